@@ -0,0 +1,358 @@
+/**
+ * @file bench_camera.cpp
+ * @brief 감지선 요청(request_id 2, 3, 4, 33)의 종단 간(end-to-end) 지연 시간 벤치마크
+ * @details 실행 중인 server에 TLS로 접속하여 감지선 삽입/조회/전체 삭제 요청을 반복하고, 요청 종류별 지연 시간 분포
+ *          (평균, p50, p90, p99, 최대)를 출력합니다. 감지선 쓰기는 응답(accepted)까지의 시간과 카메라 반영 알림
+ *          (request_id 40)까지의 시간을 따로 잽니다. server의 HOST를 camera_stub으로 지정하면 실제 카메라 없이
+ *          curl_camera 경로(연결 재사용, 캐시, 일괄 PUT 등)의 변경 효과를 측정할 수 있습니다.
+ */
+
+#include "../src/json.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace std;
+
+/**
+ * @brief SSL 연결에 버퍼 전체를 씁니다.
+ * @param ssl SSL 연결
+ * @param buffer 보낼 데이터
+ * @param len 길이
+ * @return 성공 시 true
+ */
+static bool send_all(SSL* ssl, const char* buffer, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        int sent = SSL_write(ssl, buffer + total, static_cast<int>(len - total));
+        if (sent <= 0)
+        {
+            return false;
+        }
+        total += sent;
+    }
+    return true;
+}
+
+/**
+ * @brief SSL 연결에서 정확히 len 바이트를 읽습니다.
+ * @param ssl SSL 연결
+ * @param buffer 수신 버퍼
+ * @param len 길이
+ * @return 성공 시 true
+ */
+static bool recv_all(SSL* ssl, char* buffer, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        int received = SSL_read(ssl, buffer + total, static_cast<int>(len - total));
+        if (received <= 0)
+        {
+            return false;
+        }
+        total += received;
+    }
+    return true;
+}
+
+/**
+ * @brief 서버 프로토콜(4바이트 빅엔디언 길이 + JSON)로 메시지를 보냅니다.
+ * @param ssl SSL 연결
+ * @param message 보낼 JSON
+ * @return 성공 시 true
+ */
+static bool send_message(SSL* ssl, const json& message)
+{
+    // 길이와 본문을 한 번에 보내야 Nagle/지연 ACK 대기(약 40ms)가 측정에 섞이지 않음
+    string payload = message.dump();
+    uint32_t net_len = htonl(static_cast<uint32_t>(payload.size()));
+    string frame(reinterpret_cast<const char*>(&net_len), sizeof(net_len));
+    frame += payload;
+    return send_all(ssl, frame.data(), frame.size());
+}
+
+/**
+ * @brief 서버 프로토콜로 메시지 하나를 받습니다.
+ * @param ssl SSL 연결
+ * @param message 받은 JSON (출력)
+ * @return 성공 시 true
+ */
+static bool receive_message(SSL* ssl, json& message)
+{
+    uint32_t net_len;
+    if (!recv_all(ssl, reinterpret_cast<char*>(&net_len), sizeof(net_len)))
+    {
+        return false;
+    }
+    string payload(ntohl(net_len), '\0');
+    if (!recv_all(ssl, &payload[0], payload.size()))
+    {
+        return false;
+    }
+    message = json::parse(payload);
+    return true;
+}
+
+/**
+ * @brief 카메라 명령 번호별 반영 알림(request_id 40) 수신 시각
+ */
+static map<uint64_t, chrono::steady_clock::time_point> confirmations;
+
+/**
+ * @brief 메시지 하나를 받고, 카메라 반영 알림이면 수신 시각을 기록합니다.
+ * @param ssl SSL 연결
+ * @param message 받은 JSON (출력)
+ * @return 성공 시 true
+ */
+static bool receive_and_record(SSL* ssl, json& message)
+{
+    if (!receive_message(ssl, message))
+    {
+        return false;
+    }
+    if (message.value("request_id", -1) == 40)
+    {
+        confirmations[message.value("command_id", static_cast<uint64_t>(0))] = chrono::steady_clock::now();
+        if (message.value("status", "") != "confirmed")
+        {
+            cerr << "카메라 명령 " << message["command_id"] << ": " << message["status"] << endl;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 요청을 보내고 기대한 request_id의 응답을 받을 때까지의 시간을 잽니다.
+ * @param ssl SSL 연결
+ * @param request 요청 JSON
+ * @param response_id 기다릴 응답 request_id
+ * @param response 받은 응답 (출력, nullptr 가능)
+ * @return 지연 시간(ms), 실패 시 음수
+ */
+static double timed_request(SSL* ssl, const json& request, int response_id, json* response = nullptr)
+{
+    auto started = chrono::steady_clock::now();
+    if (!send_message(ssl, request))
+    {
+        return -1;
+    }
+    json message;
+    do
+    {
+        if (!receive_and_record(ssl, message))
+        {
+            return -1;
+        }
+    } while (message.value("request_id", -1) != response_id);
+    if (response)
+    {
+        *response = message;
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+}
+
+/**
+ * @brief 카메라 명령의 반영 알림을 받을 때까지 기다려 started부터의 시간을 잽니다.
+ * @param ssl SSL 연결
+ * @param command_id 응답의 camera_command_id
+ * @param started 측정 시작 시각
+ * @return 지연 시간(ms), 실패 시 음수
+ */
+static double wait_confirmation(SSL* ssl, uint64_t command_id, chrono::steady_clock::time_point started)
+{
+    json message;
+    while (confirmations.count(command_id) == 0)
+    {
+        if (!receive_and_record(ssl, message))
+        {
+            return -1;
+        }
+    }
+    return chrono::duration<double, milli>(confirmations[command_id] - started).count();
+}
+
+/**
+ * @brief 지연 시간 분포를 한 줄로 출력합니다.
+ * @param label 출력 이름
+ * @param samples 측정값(ms)
+ */
+static void print_distribution(const string& label, vector<double> samples)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+    sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p)
+    { return samples[min(samples.size() - 1, static_cast<size_t>(p * (samples.size() - 1) + 0.5))]; };
+    double mean = 0;
+    for (double sample : samples)
+    {
+        mean += sample;
+    }
+    mean /= samples.size();
+
+    cerr << left << setw(30) << label << right << fixed << setprecision(2) << setw(6) << samples.size()
+         << setw(10) << mean << setw(10) << percentile(0.5) << setw(10) << percentile(0.9) << setw(10)
+         << percentile(0.99) << setw(10) << samples.back() << endl;
+}
+
+/**
+ * @brief 감지선 삽입 요청의 data 항목을 만듭니다.
+ * @param index 감지선 인덱스
+ * @return data JSON
+ */
+static json line_data(int index)
+{
+    return {{"index", index},
+            {"x1", 10 * index},
+            {"y1", 20},
+            {"x2", 10 * index + 5},
+            {"y2", 400},
+            {"name", "bench" + to_string(index)},
+            {"mode", "BothDirections"}};
+}
+
+int main(int argc, char* argv[])
+{
+    string host = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? stoi(argv[2]) : 8080;
+    int iterations = argc > 3 ? stoi(argv[3]) : 30;
+    int line_count = argc > 4 ? stoi(argv[4]) : 4;
+
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* address = nullptr;
+    if (getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &address) != 0)
+    {
+        cerr << "주소 변환 실패: " << host << endl;
+        return 1;
+    }
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(sock, address->ai_addr, address->ai_addrlen) < 0)
+    {
+        perror("connect");
+        return 1;
+    }
+    freeaddrinfo(address);
+
+    SSL* ssl = SSL_new(ctx);
+    SSL_set_fd(ssl, sock);
+    if (SSL_connect(ssl) <= 0)
+    {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+
+    map<string, vector<double>> results;
+    string lines_label = to_string(line_count);
+    vector<string> order = {"2: insert 1 line",
+                            "2 x " + lines_label + ": per-line setup",
+                            "2 x " + lines_label + ": camera confirmed",
+                            "33: batch insert " + lines_label,
+                            "33: camera confirmed",
+                            "3: select all",
+                            "4: delete all",
+                            "4: camera confirmed"};
+
+    // 삭제 요청을 보내고 응답과 카메라 반영까지의 시간을 기록
+    auto delete_all = [&]()
+    {
+        json response;
+        auto started = chrono::steady_clock::now();
+        results[order[6]].push_back(timed_request(ssl, {{"request_id", 4}}, 13, &response));
+        uint64_t command_id = response.value("camera_command_id", static_cast<uint64_t>(0));
+        if (command_id != 0)
+        {
+            results[order[7]].push_back(wait_confirmation(ssl, command_id, started));
+        }
+    };
+
+    // 이전 실행이 남긴 감지선 정리
+    delete_all();
+    results.clear();
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        // (1) 감지선을 request_id 2로 하나씩 설정
+        double setup_ms = 0;
+        uint64_t last_command_id = 0;
+        auto started = chrono::steady_clock::now();
+        for (int index = 1; index <= line_count; ++index)
+        {
+            json response;
+            double ms = timed_request(ssl, {{"request_id", 2}, {"camera_type", "CCTV"}, {"data", line_data(index)}}, 11,
+                                      &response);
+            if (ms < 0)
+            {
+                cerr << "요청 실패 (request_id 2)" << endl;
+                return 1;
+            }
+            results[order[0]].push_back(ms);
+            setup_ms += ms;
+            last_command_id = response.value("camera_command_id", static_cast<uint64_t>(0));
+        }
+        results[order[1]].push_back(setup_ms);
+        // 명령은 순서대로 완료되므로 마지막 명령의 알림까지를 전체 반영 시간으로 봄
+        if (last_command_id != 0)
+        {
+            results[order[2]].push_back(wait_confirmation(ssl, last_command_id, started));
+        }
+        results[order[5]].push_back(timed_request(ssl, {{"request_id", 3}}, 12));
+        delete_all();
+
+        // (2) 같은 감지선을 request_id 33으로 한 번에 설정
+        json batch = json::array();
+        for (int index = 1; index <= line_count; ++index)
+        {
+            batch.push_back(line_data(index));
+        }
+        json response;
+        started = chrono::steady_clock::now();
+        results[order[3]].push_back(
+            timed_request(ssl, {{"request_id", 33}, {"camera_type", "CCTV"}, {"data", batch}}, 34, &response));
+        uint64_t command_id = response.value("camera_command_id", static_cast<uint64_t>(0));
+        if (command_id != 0)
+        {
+            results[order[4]].push_back(wait_confirmation(ssl, command_id, started));
+        }
+        results[order[5]].push_back(timed_request(ssl, {{"request_id", 3}}, 12));
+        delete_all();
+    }
+
+    cerr << "server=" << host << ":" << port << ", iterations=" << iterations << ", lines=" << line_count << endl;
+    cerr << left << setw(30) << "request (ms)" << right << setw(6) << "n" << setw(10) << "mean" << setw(10) << "p50"
+         << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "max" << endl;
+    for (const auto& label : order)
+    {
+        print_distribution(label, results[label]);
+    }
+
+    SSL_shutdown(ssl);
+    SSL_free(ssl);
+    close(sock);
+    SSL_CTX_free(ctx);
+    return 0;
+}
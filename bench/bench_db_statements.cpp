@@ -0,0 +1,160 @@
+/**
+ * @file bench_db_statements.cpp
+ * @brief Prepared Statement 캐시 전/후 DB 처리량 벤치마크
+ * @details 같은 DB 파일에 대해 (1) 호출마다 Statement를 새로 만들고 getExpandedSQL()로 로그를 남기던 기존 방식,
+ *          (2) 호출마다 Statement만 새로 만드는 방식, (3) db_management의 캐시된 Statement 방식으로
+ *          detections INSERT와 시간 범위 SELECT를 반복 실행하여 초당 처리 건수를 비교합니다.
+ */
+
+#include "../src/db_management.hpp"
+#include "../src/db_pool.hpp"
+#include "../src/db_schema.hpp"
+#include "../src/db_statement_cache.hpp"
+#include "../src/utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief 벤치마크 기준 시각 (epoch 밀리초)
+ */
+static const long long BASE_MS = 1700000000000LL;
+
+/**
+ * @brief 기존 방식 INSERT (호출마다 prepare, 선택적으로 getExpandedSQL 로그)
+ * @param db SQLite 데이터베이스 참조
+ * @param detection 저장할 감지 데이터
+ * @param expand_sql getExpandedSQL()로 SQL 문자열을 만들지 여부
+ */
+static void insert_uncached(SQLite::Database& db, const Detection& detection, bool expand_sql)
+{
+    SQLite::Statement query(db, "INSERT INTO detections (image, timestamp, ts_ms, human_id, rule_name, vehicle_id, "
+                                "board_id, similarity) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+    query.bind(1, detection.imageBlob.data(), detection.imageBlob.size());
+    query.bind(2, detection.timestamp);
+    query.bind(3, static_cast<int64_t>(detection.timestamp_ms));
+    query.bind(4, detection.human_id);
+    query.bind(5, detection.rule_name);
+    query.bind(6, detection.vehicle_id);
+    query.bind(7, detection.board_id);
+    query.bind(8, detection.similarity);
+    if (expand_sql)
+    {
+        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
+    }
+    query.exec();
+}
+
+/**
+ * @brief 기존 방식 SELECT (호출마다 prepare, 선택적으로 getExpandedSQL 로그)
+ * @param db SQLite 데이터베이스 참조
+ * @param start_ms 시작 시각 (epoch 밀리초)
+ * @param end_ms 종료 시각 (epoch 밀리초)
+ * @param expand_sql getExpandedSQL()로 SQL 문자열을 만들지 여부
+ * @return 조회된 행 수
+ */
+static size_t select_uncached(SQLite::Database& db, long long start_ms, long long end_ms, bool expand_sql)
+{
+    SQLite::Statement query(db, "SELECT id, ts_ms FROM detections WHERE ts_ms BETWEEN ? AND ? ORDER BY ts_ms");
+    query.bind(1, static_cast<int64_t>(start_ms));
+    query.bind(2, static_cast<int64_t>(end_ms));
+    if (expand_sql)
+    {
+        cout << "Prepared SQL for select list: " << query.getExpandedSQL() << endl;
+    }
+    vector<Detection> detections;
+    while (query.executeStep())
+    {
+        Detection detection;
+        detection.id = query.getColumn(0).getInt();
+        detection.timestamp_ms = query.getColumn(1).getInt64();
+        detection.timestamp = format_kst_timestamp(detection.timestamp_ms);
+        detections.push_back(std::move(detection));
+    }
+    return detections.size();
+}
+
+/**
+ * @brief 작업을 iterations번 실행하고 초당 처리 건수를 출력합니다.
+ * @param label 출력 이름
+ * @param iterations 반복 횟수
+ * @param func i번째 반복을 실행하는 함수
+ */
+static void run_case(const string& label, int iterations, const function<void(int)>& func)
+{
+    auto started = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        func(i);
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cerr << left << setw(36) << label << right << setw(10) << iterations << " ops " << fixed << setprecision(1)
+         << setw(12) << iterations / sec << " ops/s" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int iterations = argc > 1 ? stoi(argv[1]) : 20000;
+    size_t image_bytes = argc > 2 ? stoul(argv[2]) : 1024;
+    string db_file = "bench_statements.db";
+
+    remove(db_file.c_str());
+    remove((db_file + "-wal").c_str());
+    remove((db_file + "-shm").c_str());
+
+    SQLite::Database db(db_file, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    configure_sqlite_connection(db, 5000, true);
+    run_schema_migrations(db);
+
+    // db_management 함수들이 남기는 행 단위 로그는 측정에서 제외 (결과는 cerr로 출력)
+    // (failbit 상태에서도 getExpandedSQL() 등 인자 계산은 그대로 수행됨)
+    cout.setstate(ios::failbit);
+
+    Detection detection;
+    detection.imageBlob.assign(image_bytes, 0xAB);
+    detection.timestamp = "2023-11-15T07:13:20.000Z";
+    detection.human_id = 1;
+    detection.rule_name = "bench";
+    detection.vehicle_id = 2;
+    detection.board_id = 0;
+    detection.similarity = 0.5;
+
+    auto next_detection = [&](int i)
+    {
+        detection.timestamp_ms = BASE_MS + i;
+        return detection;
+    };
+    // 최근 10건 정도를 조회하는 범위 (행 변환 비용보다 prepare 비용이 드러나도록 좁게 잡음)
+    auto range_start = [&](int i) { return BASE_MS + (i % iterations) - 10; };
+
+    cerr << "iterations=" << iterations << ", image=" << image_bytes << " bytes" << endl;
+
+    // INSERT: 각 방식마다 같은 건수를 자동 커밋 트랜잭션으로 추가 (WAL, synchronous=NORMAL)
+    run_case("insert (prepare + expanded SQL)", iterations,
+             [&](int i) { insert_uncached(db, next_detection(i), true); });
+    run_case("insert (prepare per call)", iterations, [&](int i) { insert_uncached(db, next_detection(i), false); });
+    run_case("insert (cached statement)", iterations, [&](int i) { insert_data_detections(db, next_detection(i)); });
+
+    run_case("select (prepare + expanded SQL)", iterations,
+             [&](int i) { select_uncached(db, range_start(i), range_start(i) + 10, true); });
+    run_case("select (prepare per call)", iterations,
+             [&](int i) { select_uncached(db, range_start(i), range_start(i) + 10, false); });
+    run_case("select (cached statement)", iterations,
+             [&](int i) { select_list_for_timestamp_range_detections(db, range_start(i), range_start(i) + 10); });
+
+    cout.clear();
+
+    long long hits = 0, misses = 0;
+    statement_cache_counters(hits, misses);
+    cerr << "statement cache: hits=" << hits << ", misses=" << misses << endl;
+
+    release_statement_cache(db);
+    return 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file bench_encoding.cpp
+ * @brief 메시지 인코딩(JSON, MessagePack, CBOR)별 직렬화/역직렬화 시간과 메시지 크기 벤치마크
+ * @details server가 보내는 대표 응답(감지 이미지 목록, 감지선 목록, 이벤트 목록과 집계, BBox push, 카메라 명령 알림)을
+ *          server와 같은 모양의 JSON 객체로 만들고, src/message_encoding의 encode_message/decode_message로 인코딩별
+ *          평균 시간(µs)과 직렬화된 크기를 출력합니다. 값은 고정 시드 난수로 만들어 실행마다 같습니다.
+ */
+
+#include "../src/message_encoding.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * @brief 반복 결과를 버리지 않도록 남겨 두는 값 (컴파일러 최적화로 측정 루프가 사라지지 않게 함)
+ */
+static volatile size_t g_sink = 0;
+
+/**
+ * @brief 측정할 응답 하나
+ */
+struct Sample
+{
+    string label;
+    json message;
+};
+
+/**
+ * @brief 바이트열을 base64 문자열로 변환합니다. (감지 이미지 응답 재현용)
+ * @param data 바이트열
+ * @return base64 문자열
+ */
+static string to_base64(const vector<uint8_t>& data)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t chunk = data[i] << 16;
+        chunk |= (i + 1 < data.size() ? data[i + 1] : 0) << 8;
+        chunk |= i + 2 < data.size() ? data[i + 2] : 0;
+        out += table[(chunk >> 18) & 0x3F];
+        out += table[(chunk >> 12) & 0x3F];
+        out += i + 1 < data.size() ? table[(chunk >> 6) & 0x3F] : '=';
+        out += i + 2 < data.size() ? table[chunk & 0x3F] : '=';
+    }
+    return out;
+}
+
+/**
+ * @brief server 응답과 같은 모양의 측정용 메시지를 만듭니다.
+ * @param image_bytes 감지 이미지 하나의 크기(byte)
+ * @return 측정할 응답 목록
+ */
+static vector<Sample> make_samples(size_t image_bytes)
+{
+    mt19937 rng(42);
+    uniform_int_distribution<int> byte(0, 255);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    const long long base_ms = 1760000000000LL;
+
+    vector<Sample> samples;
+
+    // request_id 10: 감지 이미지 10건
+    json detections = json::array();
+    for (int i = 0; i < 10; i++)
+    {
+        vector<uint8_t> image(image_bytes);
+        for (auto& b : image)
+        {
+            b = static_cast<uint8_t>(byte(rng));
+        }
+        detections.push_back({{"id", 1000 + i},
+                              {"image", to_base64(image)},
+                              {"timestamp", "2025-10-09T12:00:0" + to_string(i)},
+                              {"timestamp_ms", base_ms + i * 1000}});
+    }
+    samples.push_back({"10: detections + image x10", {{"request_id", 10}, {"data", detections}}});
+
+    // request_id 10: 이미지 없는 감지 목록 200건 (include_image == false)
+    json detection_list = json::array();
+    for (int i = 0; i < 200; i++)
+    {
+        detection_list.push_back(
+            {{"id", 1000 + i}, {"timestamp", "2025-10-09T12:00:00"}, {"timestamp_ms", base_ms + i * 1000}});
+    }
+    samples.push_back({"10: detection list x200", {{"request_id", 10}, {"data", detection_list}}});
+
+    // request_id 12: 감지선 8개
+    json lines = json::array();
+    for (int i = 1; i <= 8; i++)
+    {
+        lines.push_back({{"index", i},
+                         {"x1", 100 * i},
+                         {"y1", 200},
+                         {"x2", 100 * i + 50},
+                         {"y2", 900},
+                         {"name", "line" + to_string(i)},
+                         {"mode", "BothDirections"}});
+    }
+    samples.push_back({"12: lines x8", {{"request_id", 12}, {"data", lines}}});
+
+    // request_id 27: 이벤트 목록 200건
+    json events = json::array();
+    for (int i = 0; i < 200; i++)
+    {
+        events.push_back({{"id", 5000 + i},
+                          {"timestamp", "2025-10-09T12:00:00"},
+                          {"timestamp_ms", base_ms + i * 1000},
+                          {"human_id", i % 7},
+                          {"rule_name", "line" + to_string(i % 8 + 1)},
+                          {"vehicle_id", i % 5},
+                          {"board_id", "board-01"},
+                          {"similarity", unit(rng)}});
+    }
+    samples.push_back(
+        {"27: events x200", {{"request_id", 27}, {"mode", "list"}, {"total", 200}, {"data", events}}});
+
+    // request_id 27: 시간대별 건수 96구간 (15분 단위 하루)
+    json buckets = json::array();
+    for (int i = 0; i < 96; i++)
+    {
+        buckets.push_back(
+            {{"start_ms", base_ms + i * 900000LL}, {"start", "2025-10-09T12:00:00"}, {"count", i % 13}});
+    }
+    samples.push_back(
+        {"27: counts x96",
+         {{"request_id", 27}, {"mode", "count"}, {"total", 576}, {"bucket_sec", 900}, {"buckets", buckets}}});
+
+    // response_id 200: BBox push 20개
+    json bboxes = json::array();
+    for (int i = 0; i < 20; i++)
+    {
+        bboxes.push_back({{"id", i},
+                          {"type", i % 2 ? "Human" : "Vehicle"},
+                          {"confidence", unit(rng)},
+                          {"x", 10 * i},
+                          {"y", 20 * i},
+                          {"width", 64},
+                          {"height", 128}});
+    }
+    samples.push_back({"200: bbox push x20",
+                       {{"response_id", 200},
+                        {"bboxes", bboxes},
+                        {"buffer_info", {{"buffer_size", 3}, {"processed_count", 120345}}}}});
+
+    // request_id 40: 카메라 명령 완료 알림
+    samples.push_back({"40: camera command",
+                       {{"request_id", 40},
+                        {"command_id", 17},
+                        {"source_request_id", 33},
+                        {"status", "applied"},
+                        {"indexes", {1, 2, 3, 4}},
+                        {"failed_indexes", json::array()}}});
+
+    return samples;
+}
+
+/**
+ * @brief 메시지 하나를 지정한 인코딩으로 반복 직렬화/역직렬화하여 결과를 출력합니다.
+ * @param sample 측정할 응답
+ * @param encoding 메시지 인코딩
+ * @param iterations 반복 횟수
+ * @param json_size 같은 메시지의 JSON 크기 (비율 계산용)
+ */
+static void run_one(const Sample& sample, MessageEncoding encoding, int iterations, size_t json_size)
+{
+    string encoded = encode_message(sample.message, encoding);
+    if (decode_message(encoded.data(), encoded.size(), encoding) != sample.message)
+    {
+        cout << "  " << left << setw(9) << message_encoding_name(encoding) << "왕복 결과가 원본과 다름" << endl;
+        return;
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t sink = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        sink += encode_message(sample.message, encoding).size();
+    }
+    auto middle = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        sink += decode_message(encoded.data(), encoded.size(), encoding).size();
+    }
+    auto end = chrono::steady_clock::now();
+    g_sink = sink;
+
+    double encode_us = chrono::duration<double, micro>(middle - start).count() / iterations;
+    double decode_us = chrono::duration<double, micro>(end - middle).count() / iterations;
+    cout << "  " << left << setw(9) << message_encoding_name(encoding) << right << setw(10) << encoded.size()
+         << " B (" << fixed << setprecision(0) << setw(3) << 100.0 * encoded.size() / json_size << "%)" << setprecision(2)
+         << "  encode " << setw(9) << encode_us << " us  decode " << setw(9) << decode_us << " us" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int iterations = argc > 1 ? stoi(argv[1]) : 2000;
+    size_t image_kb = argc > 2 ? stoul(argv[2]) : 30;
+
+    cout << "반복 " << iterations << "회, 감지 이미지 " << image_kb << " KB" << endl;
+    for (const auto& sample : make_samples(image_kb * 1024))
+    {
+        cout << sample.label << endl;
+        size_t json_size = sample.message.dump().size();
+        // 이미지가 담긴 큰 응답은 반복 횟수를 줄여 실행 시간을 맞춤
+        int count = json_size > 64 * 1024 ? max(1, iterations / 20) : iterations;
+        for (auto encoding : {MessageEncoding::Json, MessageEncoding::MessagePack, MessageEncoding::Cbor})
+        {
+            run_one(sample, encoding, count, json_size);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file bench_line_resync.cpp
+ * @brief 감지선 동기화(request_id == 3) 전/후 fsync 횟수와 지연 시간 벤치마크
+ * @details xSync 호출 수를 세는 SQLite VFS를 기본 VFS로 등록한 뒤, (1) lines 테이블 전체 삭제 후 한 행씩 자동 커밋으로
+ *          다시 삽입하던 기존 방식과 (2) LineConfigStore::replace_lines()의 diff 기반 단일 트랜잭션 방식으로
+ *          "CCTV에서 감지선 하나가 사라진" 동기화를 반복하고, 동기화 1회당 fsync 횟수와 평균 지연 시간을 비교합니다.
+ */
+
+#include "../src/db_management.hpp"
+#include "../src/db_pool.hpp"
+#include "../src/db_schema.hpp"
+#include "../src/line_config_store.hpp"
+
+#include <sqlite3.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ==================== fsync 카운팅 VFS ====================
+
+/**
+ * @brief 누적 xSync 호출 수
+ */
+static atomic<long long> sync_count(0);
+
+/**
+ * @brief 원래 기본 VFS
+ */
+static sqlite3_vfs* base_vfs = nullptr;
+
+/**
+ * @brief 실제 파일 핸들을 감싸는 파일 객체 (실제 핸들은 바로 뒤 메모리에 위치)
+ */
+struct CountingFile
+{
+    sqlite3_file base;
+    sqlite3_file* real;
+};
+
+static int counting_close(sqlite3_file* f)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xClose(real);
+}
+static int counting_read(sqlite3_file* f, void* buf, int amount, sqlite3_int64 offset)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xRead(real, buf, amount, offset);
+}
+static int counting_write(sqlite3_file* f, const void* buf, int amount, sqlite3_int64 offset)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xWrite(real, buf, amount, offset);
+}
+static int counting_truncate(sqlite3_file* f, sqlite3_int64 size)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xTruncate(real, size);
+}
+static int counting_sync(sqlite3_file* f, int flags)
+{
+    sync_count++;
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xSync(real, flags);
+}
+static int counting_file_size(sqlite3_file* f, sqlite3_int64* size)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xFileSize(real, size);
+}
+static int counting_lock(sqlite3_file* f, int level)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xLock(real, level);
+}
+static int counting_unlock(sqlite3_file* f, int level)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xUnlock(real, level);
+}
+static int counting_check_reserved_lock(sqlite3_file* f, int* out)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xCheckReservedLock(real, out);
+}
+static int counting_file_control(sqlite3_file* f, int op, void* arg)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xFileControl(real, op, arg);
+}
+static int counting_sector_size(sqlite3_file* f)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xSectorSize(real);
+}
+static int counting_device_characteristics(sqlite3_file* f)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xDeviceCharacteristics(real);
+}
+static int counting_shm_map(sqlite3_file* f, int page, int size, int extend, void volatile** out)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xShmMap(real, page, size, extend, out);
+}
+static int counting_shm_lock(sqlite3_file* f, int offset, int n, int flags)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xShmLock(real, offset, n, flags);
+}
+static void counting_shm_barrier(sqlite3_file* f)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    real->pMethods->xShmBarrier(real);
+}
+static int counting_shm_unmap(sqlite3_file* f, int delete_flag)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xShmUnmap(real, delete_flag);
+}
+static int counting_fetch(sqlite3_file* f, sqlite3_int64 offset, int amount, void** out)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xFetch(real, offset, amount, out);
+}
+static int counting_unfetch(sqlite3_file* f, sqlite3_int64 offset, void* p)
+{
+    sqlite3_file* real = reinterpret_cast<CountingFile*>(f)->real;
+    return real->pMethods->xUnfetch(real, offset, p);
+}
+
+static const sqlite3_io_methods counting_io_methods = {
+    3,
+    counting_close,
+    counting_read,
+    counting_write,
+    counting_truncate,
+    counting_sync,
+    counting_file_size,
+    counting_lock,
+    counting_unlock,
+    counting_check_reserved_lock,
+    counting_file_control,
+    counting_sector_size,
+    counting_device_characteristics,
+    counting_shm_map,
+    counting_shm_lock,
+    counting_shm_barrier,
+    counting_shm_unmap,
+    counting_fetch,
+    counting_unfetch,
+};
+
+static int counting_open(sqlite3_vfs* vfs, const char* name, sqlite3_file* f, int flags, int* out_flags)
+{
+    CountingFile* file = reinterpret_cast<CountingFile*>(f);
+    file->real = reinterpret_cast<sqlite3_file*>(file + 1);
+    int rc = base_vfs->xOpen(base_vfs, name, file->real, flags, out_flags);
+    file->base.pMethods = (file->real->pMethods != nullptr) ? &counting_io_methods : nullptr;
+    return rc;
+}
+
+/**
+ * @brief 기본 VFS를 감싸 xSync 호출 수를 세는 VFS를 기본으로 등록합니다.
+ */
+static void register_counting_vfs()
+{
+    static sqlite3_vfs vfs;
+    base_vfs = sqlite3_vfs_find(nullptr);
+    vfs = *base_vfs;
+    vfs.zName = "fsync_counting";
+    vfs.szOsFile = static_cast<int>(sizeof(CountingFile)) + base_vfs->szOsFile;
+    vfs.xOpen = counting_open;
+    sqlite3_vfs_register(&vfs, 1);
+}
+
+// ==================== 벤치마크 ====================
+
+/**
+ * @brief 동기화 방식 하나의 결과를 출력합니다.
+ * @param label 출력 이름
+ * @param iterations 반복 횟수
+ * @param run i번째 동기화를 실행하는 함수 (측정 대상)
+ * @param restore i번째 동기화 전에 상태를 되돌리는 함수 (측정 제외)
+ */
+static void run_case(const string& label, int iterations, const function<void(int)>& run,
+                     const function<void(int)>& restore)
+{
+    long long syncs = 0;
+    double total_ms = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        restore(i);
+        long long before = sync_count.load();
+        auto started = chrono::steady_clock::now();
+        run(i);
+        total_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+        syncs += sync_count.load() - before;
+    }
+    cerr << left << setw(34) << label << right << fixed << setprecision(2) << setw(8)
+         << static_cast<double>(syncs) / iterations << " fsync/op " << setw(10) << total_ms / iterations << " ms/op"
+         << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int line_count = argc > 1 ? stoi(argv[1]) : 8;
+    int iterations = argc > 2 ? stoi(argv[2]) : 200;
+    string db_file = "bench_resync.db";
+
+    register_counting_vfs();
+
+    vector<CrossLine> lines;
+    for (int i = 0; i < line_count; ++i)
+    {
+        lines.push_back({i + 1, 10 * i, 20, 10 * i + 5, 400, "line" + to_string(i + 1), "BothDirections"});
+    }
+
+    // db_management/LineConfigStore가 남기는 행 단위 로그는 측정에서 제외 (결과는 cerr로 출력)
+    cout.setstate(ios::failbit);
+    cerr << "lines=" << line_count << ", iterations=" << iterations << " (매 회 감지선 1개가 CCTV에서 사라진 경우)"
+         << endl;
+
+    for (const char* synchronous : {"NORMAL", "FULL"})
+    {
+        remove(db_file.c_str());
+        remove((db_file + "-wal").c_str());
+        remove((db_file + "-shm").c_str());
+
+        DatabasePool db_pool;
+        if (!db_pool.open(db_file, 1, 5000))
+        {
+            return 1;
+        }
+        db_pool.write(
+            [&](SQLite::Database& db)
+            {
+                run_schema_migrations(db);
+                db.exec(string("PRAGMA synchronous = ") + synchronous);
+                for (const auto& line : lines)
+                {
+                    insert_data_lines(db, line);
+                }
+            });
+        g_line_config.load(db_pool);
+
+        cerr << "[WAL, synchronous=" << synchronous << "]" << endl;
+
+        // i번째 반복에서는 (i % line_count)번째 감지선이 사라진 목록으로 동기화
+        auto camera_lines = [&](int i)
+        {
+            vector<CrossLine> remaining = lines;
+            remaining.erase(remaining.begin() + (i % line_count));
+            return remaining;
+        };
+        auto restore_all = [&](int)
+        {
+            db_pool.write(
+                [&](SQLite::Database& db)
+                {
+                    SQLite::Transaction transaction(db);
+                    delete_all_data_lines(db);
+                    for (const auto& line : lines)
+                    {
+                        insert_data_lines(db, line);
+                    }
+                    transaction.commit();
+                });
+        };
+
+        run_case(
+            "before: delete all + autocommit", iterations,
+            [&](int i)
+            {
+                vector<CrossLine> remaining = camera_lines(i);
+                db_pool.write(
+                    [&](SQLite::Database& db)
+                    {
+                        delete_all_data_lines(db);
+                        for (const auto& line : remaining)
+                        {
+                            insert_data_lines(db, line);
+                        }
+                    });
+            },
+            restore_all);
+
+        // 기존 방식은 스냅샷을 거치지 않으므로 DB를 되돌린 뒤 스냅샷을 다시 로드
+        restore_all(0);
+        g_line_config.load(db_pool);
+
+        run_case(
+            "after: diff in one transaction", iterations,
+            [&](int i) { g_line_config.replace_lines(camera_lines(i)); },
+            [&](int i)
+            {
+                // 직전 반복에서 삭제된 감지선을 스냅샷과 DB에 되돌림
+                if (i > 0)
+                {
+                    g_line_config.insert_line(lines[(i - 1) % line_count]);
+                }
+            });
+
+        db_pool.close();
+    }
+
+    cout.clear();
+    return 0;
+}
@@ -0,0 +1,274 @@
+/**
+ * @file bench_local_rtt.cpp
+ * @brief 로컬 클라이언트의 요청 왕복 지연 시간 벤치마크 (루프백 TLS / Unix 도메인 소켓)
+ * @details 같은 장비에서 실행 중인 server에 127.0.0.1 TLS 연결과 Unix 소켓(config.json의 local_socket.path) 연결을 각각
+ *          맺고, 메모리에서 응답하는 작은 요청을 반복하여 왕복 지연 시간 분포(평균, p50, p90, p99, 최대)를 출력합니다.
+ *          연결 수립 시간(TCP 연결 + 전체 TLS 핸드셰이크 / Unix 소켓 연결)도 따로 잽니다.
+ */
+
+#include "../src/json.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace std;
+
+/**
+ * @brief 측정용 연결 하나 (ssl == nullptr이면 Unix 소켓 평문 연결)
+ */
+struct Connection
+{
+    int fd = -1;
+    SSL* ssl = nullptr;
+};
+
+/**
+ * @brief 연결에 버퍼 전체를 씁니다.
+ * @param conn 연결
+ * @param buffer 보낼 데이터
+ * @param len 길이
+ * @return 성공 시 true
+ */
+static bool send_all(const Connection& conn, const char* buffer, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        long sent = conn.ssl ? SSL_write(conn.ssl, buffer + total, static_cast<int>(len - total))
+                             : send(conn.fd, buffer + total, len - total, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        total += sent;
+    }
+    return true;
+}
+
+/**
+ * @brief 연결에서 정확히 len 바이트를 읽습니다.
+ * @param conn 연결
+ * @param buffer 수신 버퍼
+ * @param len 길이
+ * @return 성공 시 true
+ */
+static bool recv_all(const Connection& conn, char* buffer, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        long received = conn.ssl ? SSL_read(conn.ssl, buffer + total, static_cast<int>(len - total))
+                                 : recv(conn.fd, buffer + total, len - total, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        total += received;
+    }
+    return true;
+}
+
+/**
+ * @brief 요청을 보내고 응답 하나를 받을 때까지의 시간을 잽니다.
+ * @param conn 연결
+ * @param request 요청 JSON
+ * @param response_id 기대하는 응답 request_id
+ * @return 지연 시간(ms), 실패 시 음수
+ */
+static double timed_request(const Connection& conn, const json& request, int response_id)
+{
+    auto started = chrono::steady_clock::now();
+    string payload = request.dump();
+    uint32_t net_len = htonl(static_cast<uint32_t>(payload.size()));
+    string frame(reinterpret_cast<const char*>(&net_len), sizeof(net_len));
+    frame += payload;
+    if (!send_all(conn, frame.data(), frame.size()) || !recv_all(conn, reinterpret_cast<char*>(&net_len), 4))
+    {
+        return -1;
+    }
+    string body(ntohl(net_len), '\0');
+    if (!recv_all(conn, &body[0], body.size()) || json::parse(body).value("request_id", -1) != response_id)
+    {
+        return -1;
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+}
+
+/**
+ * @brief 127.0.0.1로 TCP 연결 후 TLS 핸드셰이크를 합니다. (세션 재개 없이 매번 전체 핸드셰이크)
+ * @param ctx 클라이언트 SSL_CTX
+ * @param port server 포트
+ * @param conn 연결 (출력)
+ * @return 성공 시 true
+ */
+static bool connect_tls(SSL_CTX* ctx, int port, Connection& conn)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    conn.fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(conn.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(conn.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        perror("connect");
+        return false;
+    }
+    conn.ssl = SSL_new(ctx);
+    SSL_set_fd(conn.ssl, conn.fd);
+    if (SSL_connect(conn.ssl) <= 0)
+    {
+        ERR_print_errors_fp(stderr);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Unix 소켓으로 연결합니다.
+ * @param path 소켓 파일 경로
+ * @param conn 연결 (출력)
+ * @return 성공 시 true
+ */
+static bool connect_unix(const string& path, Connection& conn)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    conn.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(conn.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        perror(("connect " + path).c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 연결을 닫습니다.
+ * @param conn 연결
+ */
+static void disconnect(Connection& conn)
+{
+    if (conn.ssl)
+    {
+        SSL_shutdown(conn.ssl);
+        SSL_free(conn.ssl);
+        conn.ssl = nullptr;
+    }
+    if (conn.fd >= 0)
+    {
+        close(conn.fd);
+        conn.fd = -1;
+    }
+}
+
+/**
+ * @brief 지연 시간 분포를 한 줄로 출력합니다.
+ * @param label 출력 이름
+ * @param samples 측정값(ms)
+ */
+static void print_distribution(const string& label, vector<double> samples)
+{
+    if (samples.empty())
+    {
+        cerr << left << setw(30) << label << "측정 실패" << endl;
+        return;
+    }
+    sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p)
+    { return samples[min(samples.size() - 1, static_cast<size_t>(p * (samples.size() - 1) + 0.5))]; };
+    double mean = 0;
+    for (double sample : samples)
+    {
+        mean += sample;
+    }
+    mean /= samples.size();
+
+    cerr << left << setw(30) << label << right << fixed << setprecision(3) << setw(6) << samples.size()
+         << setw(10) << mean << setw(10) << percentile(0.5) << setw(10) << percentile(0.9) << setw(10)
+         << percentile(0.99) << setw(10) << samples.back() << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    string socket_path = argc > 1 ? argv[1] : "../server.sock";
+    int port = argc > 2 ? stoi(argv[2]) : 8080;
+    int iterations = argc > 3 ? stoi(argv[3]) : 2000;
+    int connects = argc > 4 ? stoi(argv[4]) : 50;
+
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+
+    // 메모리에서 응답하는 요청 (보존 통계, 기준선 스냅샷)
+    const vector<pair<string, pair<json, int>>> requests = {
+        {"24: retention stats", {{{"request_id", 24}}, 25}},
+        {"7: baseline select all", {{{"request_id", 7}}, 16}},
+    };
+
+    cerr << left << setw(30) << "측정 항목 (ms)" << right << setw(6) << "n" << setw(10) << "avg" << setw(10) << "p50"
+         << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "max" << endl;
+
+    for (bool local : {false, true})
+    {
+        string transport = local ? "unix" : "tls";
+
+        vector<double> connect_ms;
+        for (int i = 0; i < connects; i++)
+        {
+            Connection conn;
+            auto started = chrono::steady_clock::now();
+            if (!(local ? connect_unix(socket_path, conn) : connect_tls(ctx, port, conn)))
+            {
+                disconnect(conn);
+                break;
+            }
+            connect_ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - started).count());
+            disconnect(conn);
+        }
+        print_distribution(transport + " connect", connect_ms);
+
+        Connection conn;
+        if (!(local ? connect_unix(socket_path, conn) : connect_tls(ctx, port, conn)))
+        {
+            disconnect(conn);
+            continue;
+        }
+        for (const auto& request : requests)
+        {
+            vector<double> samples;
+            for (int i = 0; i < iterations; i++)
+            {
+                double ms = timed_request(conn, request.second.first, request.second.second);
+                if (ms < 0)
+                {
+                    break;
+                }
+                samples.push_back(ms);
+            }
+            print_distribution(transport + " " + request.first, samples);
+        }
+        disconnect(conn);
+    }
+
+    SSL_CTX_free(ctx);
+    return 0;
+}
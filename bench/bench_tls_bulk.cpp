@@ -0,0 +1,321 @@
+/**
+ * @file bench_tls_bulk.cpp
+ * @brief TLS 대용량 송신 경로(사용자 공간 암호화 / kTLS / kTLS + sendfile)의 루프백 벤치마크
+ * @details 127.0.0.1 TCP 연결 하나로 서버 쪽 스레드가 큰 프레임(감지 이미지가 담긴 응답 크기)을 반복해서 보내고,
+ *          송신 스레드의 CPU 시간(getrusage RUSAGE_THREAD, 사용자/커널)과 처리량을 출력합니다. kTLS의 암호화는
+ *          송신 스레드의 sendmsg 안에서 실행되므로 커널 시간에 포함됩니다. 수신 쪽은 항상 사용자 공간 OpenSSL로 읽고
+ *          버립니다. 커널 tls 모듈이 없거나 협상된 암호를 커널이 지원하지 않으면 kTLS 행은 "kTLS=no"로 표시되며
+ *          사용자 공간 암호화와 같은 경로를 잽니다.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief 송신 방식
+ */
+enum class SendMode
+{
+    Userspace, ///< kTLS 없이 SSL_write
+    Ktls,      ///< SSL_OP_ENABLE_KTLS + SSL_write
+    Sendfile   ///< SSL_OP_ENABLE_KTLS + 파일에서 SSL_sendfile
+};
+
+/**
+ * @brief 한 번의 측정 결과
+ */
+struct BulkResult
+{
+    bool ok = false;
+    bool skipped = false;
+    bool ktls = false;
+    string cipher;
+    size_t bytes = 0;
+    double wall_ms = 0;
+    double user_ms = 0;
+    double sys_ms = 0;
+};
+
+/**
+ * @brief 현재 스레드의 사용자/커널 CPU 시간(ms)을 읽습니다.
+ * @param user_ms 사용자 모드 CPU 시간 (출력)
+ * @param sys_ms 커널 모드 CPU 시간 (출력)
+ */
+static void thread_cpu_ms(double& user_ms, double& sys_ms)
+{
+    rusage usage{};
+    getrusage(RUSAGE_THREAD, &usage);
+    user_ms = usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0;
+    sys_ms = usage.ru_stime.tv_sec * 1000.0 + usage.ru_stime.tv_usec / 1000.0;
+}
+
+/**
+ * @brief SSL 연결에 버퍼 전체를 씁니다.
+ * @param ssl SSL 연결
+ * @param buffer 보낼 데이터
+ * @param len 길이
+ * @return 성공 시 true
+ */
+static bool send_all(SSL* ssl, const char* buffer, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        int sent = SSL_write(ssl, buffer + total, static_cast<int>(len - total));
+        if (sent <= 0)
+        {
+            return false;
+        }
+        total += sent;
+    }
+    return true;
+}
+
+/**
+ * @brief 파일 구간 전체를 SSL_sendfile로 보냅니다. (kTLS 송신 중일 때만 동작)
+ * @param ssl SSL 연결
+ * @param fd 파일 디스크립터
+ * @param len 보낼 길이 (파일 처음부터)
+ * @return 성공 시 true
+ */
+static bool sendfile_all(SSL* ssl, int fd, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        ossl_ssize_t sent = SSL_sendfile(ssl, fd, static_cast<off_t>(total), len - total, 0);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        total += sent;
+    }
+    return true;
+}
+
+/**
+ * @brief 루프백 TCP 연결 하나를 만듭니다.
+ * @param server_fd 서버 쪽 소켓 (출력)
+ * @param client_fd 클라이언트 쪽 소켓 (출력)
+ * @return 성공 시 true
+ */
+static bool make_loopback_pair(int& server_fd, int& client_fd)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listener, 1) < 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len) < 0)
+    {
+        perror("listen");
+        close(listener);
+        return false;
+    }
+    client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(client_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        perror("connect");
+        close(listener);
+        return false;
+    }
+    server_fd = accept(listener, nullptr, nullptr);
+    close(listener);
+    int one = 1;
+    setsockopt(server_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return server_fd >= 0;
+}
+
+/**
+ * @brief 한 가지 송신 방식으로 total_bytes를 보내고 송신 스레드의 CPU 시간을 잽니다.
+ * @param mode 송신 방식
+ * @param server_ctx 서버 SSL_CTX (인증서 설정 완료)
+ * @param client_ctx 클라이언트 SSL_CTX
+ * @param frame 한 번에 보낼 프레임
+ * @param file_fd frame과 같은 내용의 파일 (Sendfile 방식에서 사용)
+ * @param total_bytes 보낼 전체 바이트 수
+ * @return 측정 결과
+ */
+static BulkResult run_bulk(SendMode mode, SSL_CTX* server_ctx, SSL_CTX* client_ctx, const string& frame, int file_fd,
+                           size_t total_bytes)
+{
+    BulkResult result;
+    int server_fd = -1;
+    int client_fd = -1;
+    if (!make_loopback_pair(server_fd, client_fd))
+    {
+        return result;
+    }
+
+    if (mode == SendMode::Userspace)
+    {
+        SSL_CTX_clear_options(server_ctx, SSL_OP_ENABLE_KTLS);
+    }
+    else
+    {
+        SSL_CTX_set_options(server_ctx, SSL_OP_ENABLE_KTLS);
+    }
+
+    SSL* server = SSL_new(server_ctx);
+    SSL_set_fd(server, server_fd);
+    SSL* client = SSL_new(client_ctx);
+    SSL_set_fd(client, client_fd);
+
+    thread sender(
+        [&]
+        {
+            if (SSL_accept(server) <= 0)
+            {
+                ERR_print_errors_fp(stderr);
+                return;
+            }
+            result.ktls = BIO_get_ktls_send(SSL_get_wbio(server));
+            result.cipher = SSL_get_cipher_name(server);
+            if (mode == SendMode::Sendfile && !result.ktls)
+            {
+                // SSL_sendfile은 kTLS 송신 중에만 동작
+                result.skipped = true;
+                SSL_shutdown(server);
+                return;
+            }
+
+            double user_start = 0;
+            double sys_start = 0;
+            thread_cpu_ms(user_start, sys_start);
+            auto wall_start = chrono::steady_clock::now();
+            size_t sent = 0;
+            while (sent < total_bytes)
+            {
+                bool ok = mode == SendMode::Sendfile ? sendfile_all(server, file_fd, frame.size())
+                                                     : send_all(server, frame.data(), frame.size());
+                if (!ok)
+                {
+                    ERR_print_errors_fp(stderr);
+                    break;
+                }
+                sent += frame.size();
+            }
+            thread_cpu_ms(result.user_ms, result.sys_ms);
+            result.user_ms -= user_start;
+            result.sys_ms -= sys_start;
+            result.wall_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - wall_start).count();
+            result.bytes = sent;
+            result.ok = sent >= total_bytes;
+            SSL_shutdown(server);
+        });
+
+    if (SSL_connect(client) > 0)
+    {
+        vector<char> buffer(64 * 1024);
+        while (SSL_read(client, buffer.data(), static_cast<int>(buffer.size())) > 0)
+        {
+        }
+    }
+    else
+    {
+        ERR_print_errors_fp(stderr);
+    }
+    sender.join();
+
+    SSL_free(client);
+    SSL_free(server);
+    close(client_fd);
+    close(server_fd);
+    return result;
+}
+
+/**
+ * @brief 측정 결과 한 행을 출력합니다.
+ * @param label 송신 방식 이름
+ * @param result 측정 결과
+ */
+static void print_result(const string& label, const BulkResult& result)
+{
+    cout << left << setw(26) << label;
+    if (!result.ok)
+    {
+        cout << (result.skipped ? "건너뜀 (kTLS 송신 아님)" : "실패") << endl;
+        return;
+    }
+    double mb = result.bytes / (1024.0 * 1024.0);
+    double cpu_ms = result.user_ms + result.sys_ms;
+    cout << setw(9) << (result.ktls ? "kTLS=yes" : "kTLS=no") << setw(32) << result.cipher << right << fixed
+         << setprecision(1) << setw(8) << mb / (result.wall_ms / 1000.0) << " MB/s  CPU " << setw(7) << cpu_ms
+         << " ms (user " << result.user_ms << " / sys " << result.sys_ms << ")" << setprecision(2) << setw(7)
+         << cpu_ms / mb << " ms/MB" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t total_mb = argc > 1 ? stoul(argv[1]) : 256;
+    size_t frame_kb = argc > 2 ? stoul(argv[2]) : 256;
+    string cert = argc > 3 ? argv[3] : "stub.crt";
+    string key = argc > 4 ? argv[4] : "stub.key";
+    string suites = argc > 5 ? argv[5] : "";
+
+    SSL_CTX* server_ctx = SSL_CTX_new(TLS_server_method());
+    if (SSL_CTX_use_certificate_file(server_ctx, cert.c_str(), SSL_FILETYPE_PEM) <= 0 ||
+        SSL_CTX_use_PrivateKey_file(server_ctx, key.c_str(), SSL_FILETYPE_PEM) <= 0)
+    {
+        cerr << "인증서/개인키 로드 실패: " << cert << ", " << key << " (make stub-cert)" << endl;
+        return 1;
+    }
+    // 세션 티켓 없이 핸드셰이크 직후 바로 본문을 보냄
+    SSL_CTX_set_num_tickets(server_ctx, 0);
+    SSL_CTX* client_ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(client_ctx, SSL_VERIFY_NONE, nullptr);
+    if (!suites.empty() && (SSL_CTX_set_ciphersuites(server_ctx, suites.c_str()) != 1 ||
+                            SSL_CTX_set_ciphersuites(client_ctx, suites.c_str()) != 1))
+    {
+        cerr << "TLS 1.3 암호 스위트 설정 실패: " << suites << endl;
+        return 1;
+    }
+
+    // 프레임 내용 (암호화 비용은 내용과 무관하므로 임의 바이트)
+    string frame(frame_kb * 1024, '\0');
+    for (size_t i = 0; i < frame.size(); ++i)
+    {
+        frame[i] = static_cast<char>(i * 131 + 7);
+    }
+    char file_name[] = "/tmp/bench_tls_bulk.XXXXXX";
+    int file_fd = mkstemp(file_name);
+    if (file_fd < 0 || write(file_fd, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size()))
+    {
+        perror("임시 파일");
+        return 1;
+    }
+    unlink(file_name);
+
+    size_t total_bytes = total_mb * 1024 * 1024;
+    cout << "전송량 " << total_mb << " MB, 프레임 " << frame_kb << " KB, 루프백 TCP" << endl;
+    print_result("userspace (SSL_write)", run_bulk(SendMode::Userspace, server_ctx, client_ctx, frame, file_fd,
+                                                   total_bytes));
+    print_result("kTLS (SSL_write)", run_bulk(SendMode::Ktls, server_ctx, client_ctx, frame, file_fd, total_bytes));
+    print_result("kTLS + SSL_sendfile", run_bulk(SendMode::Sendfile, server_ctx, client_ctx, frame, file_fd,
+                                                 total_bytes));
+
+    close(file_fd);
+    SSL_CTX_free(client_ctx);
+    SSL_CTX_free(server_ctx);
+    return 0;
+}
@@ -0,0 +1,396 @@
+/**
+ * @file camera_stub.cpp
+ * @brief 카메라 linecrossing REST API 대역(stand-in) HTTPS 서버
+ * @details 실제 카메라 없이 curl_camera 경로를 측정/확인하기 위해 `/opensdk/WiseAI/configuration/linecrossing`의
+ *          GET/PUT/DELETE를 메모리 상태로 흉내 냅니다. 카메라와 같이 HTTP Digest 인증(MD5, qop=auth)을 요구하고,
+ *          모든 응답 전에 지정한 지연 시간만큼 기다리며, HTTP/1.1 keep-alive 연결과 ETag/If-None-Match를 지원합니다.
+ *          연결마다 스레드 하나로 처리합니다.
+ */
+
+#include "../src/json.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using json = nlohmann::json;
+using namespace std;
+
+/**
+ * @brief linecrossing 설정 경로
+ */
+static const string LINECROSSING_PATH = "/opensdk/WiseAI/configuration/linecrossing";
+
+/**
+ * @brief Digest 인증 realm
+ */
+static const string REALM = "camera-stub";
+
+/**
+ * @brief 실행 인자/환경 변수로 정한 대역 서버 설정
+ */
+static string username;
+static string password;
+static int latency_ms = 20;
+
+/**
+ * @brief 서버 시작 시 한 번 만드는 Digest nonce
+ */
+static string server_nonce;
+
+/**
+ * @brief 감지선 상태 (index 순) 및 보호용 뮤텍스, 변경될 때마다 증가하는 ETag 버전
+ */
+static map<int, json> lines;
+static mutex lines_mutex;
+static uint64_t lines_version = 1;
+
+/**
+ * @brief 수신한 HTTP 요청 하나
+ */
+struct HttpRequest
+{
+    string method;
+    string target;
+    map<string, string> headers; ///< 헤더 이름은 소문자
+    string body;
+};
+
+/**
+ * @brief 문자열의 MD5 해시를 16진수 소문자로 반환합니다.
+ * @param data 입력 문자열
+ * @return 32자리 16진수 문자열
+ */
+static string md5_hex(const string& data)
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(data.data(), data.size(), digest, &length, EVP_md5(), nullptr);
+
+    static const char* hex = "0123456789abcdef";
+    string out;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        out += hex[digest[i] >> 4];
+        out += hex[digest[i] & 0x0f];
+    }
+    return out;
+}
+
+/**
+ * @brief 헤더 이름을 소문자로 바꿉니다.
+ * @param value 입력 문자열
+ * @return 소문자 문자열
+ */
+static string to_lower(string value)
+{
+    for (auto& c : value)
+    {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return value;
+}
+
+/**
+ * @brief SSL 연결에서 HTTP 요청 하나를 읽습니다.
+ * @param ssl SSL 연결
+ * @param pending 이전 읽기에서 남은 데이터 (keep-alive 연결에서 다음 요청의 앞부분)
+ * @param request 읽은 요청 (출력)
+ * @return 성공 시 true, 연결 종료/오류 시 false
+ */
+static bool read_request(SSL* ssl, string& pending, HttpRequest& request)
+{
+    char buffer[4096];
+    size_t header_end;
+    while ((header_end = pending.find("\r\n\r\n")) == string::npos)
+    {
+        int n = SSL_read(ssl, buffer, sizeof(buffer));
+        if (n <= 0)
+        {
+            return false;
+        }
+        pending.append(buffer, n);
+    }
+
+    istringstream head(pending.substr(0, header_end));
+    string line;
+    getline(head, line);
+    istringstream request_line(line);
+    request_line >> request.method >> request.target;
+    request.headers.clear();
+    while (getline(head, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        size_t colon = line.find(':');
+        if (colon == string::npos)
+        {
+            continue;
+        }
+        size_t value_begin = line.find_first_not_of(' ', colon + 1);
+        request.headers[to_lower(line.substr(0, colon))] = value_begin == string::npos ? "" : line.substr(value_begin);
+    }
+
+    size_t content_length = 0;
+    auto it = request.headers.find("content-length");
+    if (it != request.headers.end())
+    {
+        content_length = stoul(it->second);
+    }
+    pending.erase(0, header_end + 4);
+    while (pending.size() < content_length)
+    {
+        int n = SSL_read(ssl, buffer, sizeof(buffer));
+        if (n <= 0)
+        {
+            return false;
+        }
+        pending.append(buffer, n);
+    }
+    request.body = pending.substr(0, content_length);
+    pending.erase(0, content_length);
+    return true;
+}
+
+/**
+ * @brief HTTP 응답을 보냅니다.
+ * @param ssl SSL 연결
+ * @param status 상태 줄 (예: "200 OK")
+ * @param body 응답 본문
+ * @param extra_headers 추가 헤더 (각 줄은 "\r\n"으로 끝나야 함)
+ * @return 성공 시 true
+ */
+static bool send_response(SSL* ssl, const string& status, const string& body, const string& extra_headers = "")
+{
+    string response = "HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\nContent-Length: " +
+                      to_string(body.size()) + "\r\n" + extra_headers + "\r\n" + body;
+    return SSL_write(ssl, response.data(), static_cast<int>(response.size())) == static_cast<int>(response.size());
+}
+
+/**
+ * @brief Digest Authorization 헤더를 검증합니다.
+ * @param request 수신한 요청
+ * @return 사용자/비밀번호/nonce가 맞으면 true
+ */
+static bool check_digest(const HttpRequest& request)
+{
+    auto it = request.headers.find("authorization");
+    if (it == request.headers.end() || strncasecmp(it->second.c_str(), "Digest ", 7) != 0)
+    {
+        return false;
+    }
+
+    // key="value" 또는 key=value 목록을 파싱
+    map<string, string> fields;
+    const string& header = it->second;
+    size_t pos = 7;
+    while (pos < header.size())
+    {
+        size_t eq = header.find('=', pos);
+        if (eq == string::npos)
+        {
+            break;
+        }
+        string key = header.substr(pos, eq - pos);
+        key.erase(0, key.find_first_not_of(" ,"));
+        string value;
+        if (eq + 1 < header.size() && header[eq + 1] == '"')
+        {
+            size_t close = header.find('"', eq + 2);
+            value = header.substr(eq + 2, close - eq - 2);
+            pos = close == string::npos ? header.size() : close + 1;
+        }
+        else
+        {
+            size_t comma = header.find(',', eq + 1);
+            value = header.substr(eq + 1, comma == string::npos ? string::npos : comma - eq - 1);
+            pos = comma == string::npos ? header.size() : comma;
+        }
+        fields[key] = value;
+        pos = header.find_first_not_of(" ,", pos);
+    }
+
+    if (fields["username"] != username || fields["nonce"] != server_nonce || fields["uri"] != request.target)
+    {
+        return false;
+    }
+    string ha1 = md5_hex(username + ":" + REALM + ":" + password);
+    string ha2 = md5_hex(request.method + ":" + request.target);
+    string expected = md5_hex(ha1 + ":" + server_nonce + ":" + fields["nc"] + ":" + fields["cnonce"] + ":" +
+                              fields["qop"] + ":" + ha2);
+    return fields["response"] == expected;
+}
+
+/**
+ * @brief 인증된 요청을 처리하고 응답합니다.
+ * @param ssl SSL 연결
+ * @param request 수신한 요청
+ * @return 응답 전송 성공 시 true
+ */
+static bool handle_request(SSL* ssl, const HttpRequest& request)
+{
+    string path = request.target.substr(0, request.target.find('?'));
+
+    if (request.method == "GET" && path == LINECROSSING_PATH)
+    {
+        json root;
+        string etag;
+        {
+            lock_guard<mutex> lock(lines_mutex);
+            json line_array = json::array();
+            for (const auto& entry : lines)
+            {
+                line_array.push_back(entry.second);
+            }
+            root["lineCrossing"] = json::array({{{"channel", 0}, {"enable", true}, {"line", line_array}}});
+            etag = "\"" + to_string(lines_version) + "\"";
+        }
+        auto it = request.headers.find("if-none-match");
+        if (it != request.headers.end() && it->second == etag)
+        {
+            return send_response(ssl, "304 Not Modified", "", "ETag: " + etag + "\r\n");
+        }
+        return send_response(ssl, "200 OK", root.dump(), "ETag: " + etag + "\r\n");
+    }
+
+    if (request.method == "PUT" && path == LINECROSSING_PATH)
+    {
+        json body = json::parse(request.body, nullptr, false);
+        if (body.is_discarded() || !body.contains("line") || !body["line"].is_array())
+        {
+            return send_response(ssl, "400 Bad Request", "{}");
+        }
+        lock_guard<mutex> lock(lines_mutex);
+        for (const auto& line : body["line"])
+        {
+            lines[line.value("index", -1)] = line;
+        }
+        lines_version++;
+        return send_response(ssl, "200 OK", "{}");
+    }
+
+    if (request.method == "DELETE" && path == LINECROSSING_PATH + "/line")
+    {
+        size_t index_pos = request.target.find("index=");
+        if (index_pos == string::npos)
+        {
+            return send_response(ssl, "400 Bad Request", "{}");
+        }
+        int index = atoi(request.target.c_str() + index_pos + 6);
+        lock_guard<mutex> lock(lines_mutex);
+        if (lines.erase(index) > 0)
+        {
+            lines_version++;
+        }
+        return send_response(ssl, "200 OK", "{}");
+    }
+
+    return send_response(ssl, "404 Not Found", "{}");
+}
+
+/**
+ * @brief 연결 하나를 처리합니다. (keep-alive로 여러 요청 처리)
+ * @param ctx SSL 컨텍스트
+ * @param client_fd 클라이언트 소켓
+ */
+static void serve_connection(SSL_CTX* ctx, int client_fd)
+{
+    SSL* ssl = SSL_new(ctx);
+    SSL_set_fd(ssl, client_fd);
+    if (SSL_accept(ssl) > 0)
+    {
+        string pending;
+        HttpRequest request;
+        while (read_request(ssl, pending, request))
+        {
+            this_thread::sleep_for(chrono::milliseconds(latency_ms));
+
+            bool ok;
+            if (!check_digest(request))
+            {
+                string challenge = "WWW-Authenticate: Digest realm=\"" + REALM + "\", nonce=\"" + server_nonce +
+                                   "\", qop=\"auth\", algorithm=MD5\r\n";
+                ok = send_response(ssl, "401 Unauthorized", "", challenge);
+            }
+            else
+            {
+                ok = handle_request(ssl, request);
+            }
+
+            auto it = request.headers.find("connection");
+            if (!ok || (it != request.headers.end() && strcasecmp(it->second.c_str(), "close") == 0))
+            {
+                break;
+            }
+        }
+        SSL_shutdown(ssl);
+    }
+    SSL_free(ssl);
+    close(client_fd);
+}
+
+int main(int argc, char* argv[])
+{
+    int port = argc > 1 ? stoi(argv[1]) : 8443;
+    latency_ms = argc > 2 ? stoi(argv[2]) : 20;
+    string cert_file = argc > 3 ? argv[3] : "stub.crt";
+    string key_file = argc > 4 ? argv[4] : "stub.key";
+    username = getenv("USERNAME") ? getenv("USERNAME") : "admin";
+    password = getenv("PASSWORD") ? getenv("PASSWORD") : "admin";
+
+    unsigned char nonce_bytes[16];
+    RAND_bytes(nonce_bytes, sizeof(nonce_bytes));
+    server_nonce = md5_hex(string(reinterpret_cast<char*>(nonce_bytes), sizeof(nonce_bytes)));
+
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx || SSL_CTX_use_certificate_file(ctx, cert_file.c_str(), SSL_FILETYPE_PEM) <= 0 ||
+        SSL_CTX_use_PrivateKey_file(ctx, key_file.c_str(), SSL_FILETYPE_PEM) <= 0)
+    {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int opt = 1;
+    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(server_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(server_fd, 16) < 0)
+    {
+        perror("bind/listen");
+        return 1;
+    }
+
+    cerr << "camera stub: https://127.0.0.1:" << port << LINECROSSING_PATH << " (user=" << username
+         << ", latency=" << latency_ms << "ms)" << endl;
+
+    while (true)
+    {
+        int client_fd = accept(server_fd, nullptr, nullptr);
+        if (client_fd < 0)
+        {
+            continue;
+        }
+        thread(serve_connection, ctx, client_fd).detach();
+    }
+}
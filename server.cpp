@@ -4,12 +4,15 @@
  * @brief 서버 메인 엔트리 포인트
  * @details RTSP 서버와 TCP 서버를 멀티스레드로 실행하는 메인 프로그램입니다.
  *          각 서버는 독립적인 스레드에서 실행되며, 함수 세부 구현은 별도 파일에 작성되어 있습니다.
+ *          이전 서버가 실행 중이면 리스닝 소켓을 넘겨받아 연결 끊김 없이 교체합니다. (listener_handoff.hpp 참고)
  */
 
 #include <fstream>
 #include <thread>
 
+#include "src/config_manager.hpp"
 #include "src/db_management.hpp"
+#include "src/listener_handoff.hpp"
 #include "src/rtsp_server.hpp"
 #include "src/tcp_server.hpp"
 
@@ -21,19 +24,44 @@ using namespace std;
  * @param argv 명령행 인수 배열
  * @return 프로그램 종료 코드 (성공 시 0)
  * @details RTSP 서버와 TCP 서버를 각각 별도의 스레드에서 실행합니다.
- *          두 스레드가 모두 종료될 때까지 대기한 후 프로그램을 종료합니다.
+ *          TCP 서버가 종료 신호나 인계 완료로 정상 종료하면 RTSP 서버도 멈추고, 두 스레드가 모두 종료된 후
+ *          프로그램을 종료합니다.
  */
 int main(int argc, char* argv[])
 {
+    // 이전 서버의 리스닝 소켓은 두 서버가 리스너를 열기 전에 넘겨받음 (이전 서버가 없으면 각 서버가 새로 엶)
+    // 오래 걸릴 수 있는 스키마 마이그레이션은 넘겨받기 전에 끝내, 이전 서버의 인계 확인 대기가 리스너 시작만 기다리도록 함
+    // (준비에 실패하면 넘겨받지 않고 이전 서버가 계속 서비스함)
+    bool inherited = false;
+    if (load_all_config() && g_config.restart_enabled && tcp_prepare())
+    {
+        inherited = g_listener_handoff.inherit(g_config.restart_handoff_path);
+    }
+
     // RTSP 서버를 별도 스레드에서 실행
     thread rtsp_run_thread(rtsp_run, argc, argv);
 
     // TCP 서버를 별도 스레드에서 실행
-    thread tcp_run_thread(tcp_run);
+    int tcp_result = 0;
+    thread tcp_run_thread([&tcp_result] { tcp_result = tcp_run(); });
 
-    // 두 서버 스레드가 모두 종료될 때까지 대기
-    rtsp_run_thread.join();
+    // TCP 서버가 시작에 실패한 경우에는 이전처럼 RTSP 서버만 계속 실행
     tcp_run_thread.join();
+    if (tcp_result == 0)
+    {
+        rtsp_stop();
+    }
+    else
+    {
+        // 넘겨받은 소켓은 닫고 이전 서버와의 연결도 닫아 이전 서버가 바로 계속 서비스하도록 함
+        // (이전 서버가 있으면 RTSP 소켓도 이전 서버의 것이므로 RTSP 서버도 멈춤)
+        g_listener_handoff.stop(false);
+        if (inherited)
+        {
+            rtsp_stop();
+        }
+    }
+    rtsp_run_thread.join();
 
     return 0;
 }
@@ -0,0 +1,448 @@
+/**
+ * @file camera_command_queue.cpp
+ * @brief CCTV 감지선 쓰기 명령 비동기 큐 구현 파일
+ * @details 인덱스별 대체, 일괄 실행, 지수 백오프 재시도와 완료 콜백을 구현합니다.
+ */
+
+#include "camera_command_queue.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 카메라 명령 큐 인스턴스
+ */
+CameraCommandQueue g_camera_commands;
+
+/**
+ * @brief 재시도 대기 시간의 최대 배수(2^MAX_RETRY_SHIFT)와 최대 대기 시간(ms)
+ */
+static const int MAX_RETRY_SHIFT = 16;
+static const long long MAX_RETRY_DELAY_MS = 60000;
+
+/**
+ * @brief 카메라 쓰기 요청이 성공했는지 확인합니다.
+ * @param response 요청 결과
+ * @return 전송에 성공하고 HTTP 2xx이면 true
+ */
+static bool camera_write_succeeded(const CameraResponse& response)
+{
+    return response.result == CURLE_OK && response.http_code >= 200 && response.http_code < 300;
+}
+
+/**
+ * @brief 실패한 카메라 쓰기 요청을 다시 시도할 만한지 확인합니다.
+ * @param response 요청 결과
+ * @return 전송 실패(연결/타임아웃), 5xx, 408, 429이면 true (그 밖의 4xx는 다시 보내도 같은 결과)
+ */
+static bool camera_write_retryable(const CameraResponse& response)
+{
+    return response.result != CURLE_OK || response.http_code >= 500 || response.http_code == 408 ||
+           response.http_code == 429;
+}
+
+/**
+ * @brief 결과를 프로토콜 문자열로 변환합니다.
+ * @param status 명령 결과
+ * @return 결과 문자열
+ */
+const char* camera_command_status_name(CameraCommandStatus status)
+{
+    switch (status)
+    {
+    case CameraCommandStatus::Confirmed:
+        return "confirmed";
+    case CameraCommandStatus::Superseded:
+        return "superseded";
+    case CameraCommandStatus::Failed:
+        break;
+    }
+    return "failed";
+}
+
+/**
+ * @brief 소멸자. 실행 중인 큐 스레드를 중지함
+ */
+CameraCommandQueue::~CameraCommandQueue()
+{
+    stop();
+}
+
+/**
+ * @brief 큐 스레드를 시작합니다.
+ * @param max_attempts 감지선 하나당 최대 시도 횟수
+ * @param retry_base_ms 첫 재시도 대기 시간(ms)
+ */
+void CameraCommandQueue::start(int max_attempts, int retry_base_ms)
+{
+    lock_guard<mutex> lock(queue_mutex);
+    if (running)
+    {
+        return;
+    }
+    this->max_attempts = max(1, max_attempts);
+    this->retry_base_ms = max(0, retry_base_ms);
+    running = true;
+    worker = thread(&CameraCommandQueue::worker_loop, this);
+    cout << "[CameraCommand] 명령 큐 시작 (max_attempts=" << this->max_attempts
+         << ", retry_base_ms=" << this->retry_base_ms << ")" << endl;
+}
+
+/**
+ * @brief 큐 스레드를 중지합니다. 실행 중인 요청은 끝까지 기다리고, 남은 명령은 실패로 완료합니다.
+ */
+void CameraCommandQueue::stop()
+{
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+    }
+    wake_cv.notify_all();
+    idle_cv.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+
+    vector<shared_ptr<Command>> completed;
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        if (!pending.empty())
+        {
+            cerr << "[CameraCommand] 종료로 전송하지 못한 감지선 쓰기 " << pending.size() << "개" << endl;
+        }
+        for (const auto& entry : pending)
+        {
+            resolve(entry.second, CameraCommandStatus::Failed, completed);
+        }
+        pending.clear();
+    }
+    notify(completed);
+    cout << "[CameraCommand] 명령 큐 종료" << endl;
+}
+
+/**
+ * @brief 감지선 추가(PUT) 명령을 넣습니다.
+ * @param lines 추가할 감지선 목록 (카메라 좌표계)
+ * @param callback 완료 콜백
+ * @return 명령 번호 (lines가 비어 있으면 0)
+ */
+uint64_t CameraCommandQueue::submit_put(const vector<CrossLine>& lines, CameraCommandCallback callback)
+{
+    vector<PendingWrite> writes;
+    for (const auto& line : lines)
+    {
+        PendingWrite write;
+        write.line = line;
+        write.index = line.index;
+        writes.push_back(std::move(write));
+    }
+    return submit(std::move(writes), std::move(callback));
+}
+
+/**
+ * @brief 감지선 삭제(DELETE) 명령을 넣습니다.
+ * @param indexes 삭제할 감지선 인덱스 목록
+ * @param callback 완료 콜백
+ * @return 명령 번호 (indexes가 비어 있으면 0)
+ */
+uint64_t CameraCommandQueue::submit_delete(const vector<int>& indexes, CameraCommandCallback callback)
+{
+    vector<PendingWrite> writes;
+    for (int index : indexes)
+    {
+        PendingWrite write;
+        write.is_delete = true;
+        write.index = index;
+        writes.push_back(std::move(write));
+    }
+    return submit(std::move(writes), std::move(callback));
+}
+
+/**
+ * @brief 아직 카메라에 반영되지 않은 추가 명령의 감지선 인덱스를 반환합니다.
+ * @return 감지선 인덱스 목록
+ */
+vector<int> CameraCommandQueue::pending_put_indexes()
+{
+    lock_guard<mutex> lock(queue_mutex);
+    vector<int> indexes = in_flight_puts;
+    for (const auto& entry : pending)
+    {
+        if (!entry.second.is_delete)
+        {
+            indexes.push_back(entry.first);
+        }
+    }
+    return indexes;
+}
+
+/**
+ * @brief 대기 중이거나 실행 중인 명령이 모두 끝나고 완료 콜백까지 호출될 때까지 기다립니다.
+ * @details 재시도를 기다리는 쓰기도 끝날 때까지 기다리므로, 카메라가 응답하지 않으면 deadline까지 기다립니다.
+ * @param deadline 최대 대기 시각
+ * @return 모두 끝났으면 true, 시간 초과 시 false
+ */
+bool CameraCommandQueue::wait_idle(chrono::steady_clock::time_point deadline)
+{
+    unique_lock<mutex> lock(queue_mutex);
+    return idle_cv.wait_until(lock, deadline, [this] { return !running || (pending.empty() && !executing); });
+}
+
+/**
+ * @brief 쓰기 목록을 하나의 명령으로 큐에 넣습니다.
+ * @details 같은 인덱스에 아직 실행되지 않은 쓰기가 있으면 새 쓰기로 바꾸고, 기존 쓰기는 superseded로 끝냅니다.
+ *          실행 중인 쓰기는 건드리지 않으므로 새 쓰기는 그 요청이 끝난 뒤에 실행됩니다.
+ * @param writes 감지선별 쓰기 목록
+ * @param callback 완료 콜백
+ * @return 명령 번호 (writes가 비어 있으면 0)
+ */
+uint64_t CameraCommandQueue::submit(vector<PendingWrite> writes, CameraCommandCallback callback)
+{
+    if (writes.empty())
+    {
+        return 0;
+    }
+
+    auto command = make_shared<Command>();
+    command->remaining = writes.size();
+    command->callback = std::move(callback);
+
+    vector<shared_ptr<Command>> completed;
+    uint64_t command_id;
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        command_id = next_command_id++;
+        command->result.command_id = command_id;
+
+        auto now = chrono::steady_clock::now();
+        for (auto& write : writes)
+        {
+            command->result.indexes.push_back(write.index);
+            write.command = command;
+            write.ready_at = now;
+
+            if (!running)
+            {
+                resolve(write, CameraCommandStatus::Failed, completed);
+                continue;
+            }
+
+            auto it = pending.find(write.index);
+            if (it == pending.end())
+            {
+                pending.emplace(write.index, std::move(write));
+                continue;
+            }
+            // 같은 명령 안의 중복 인덱스는 뒤의 항목만 남기고 대체로 표시하지 않음
+            resolve(it->second,
+                    it->second.command == command ? CameraCommandStatus::Confirmed : CameraCommandStatus::Superseded,
+                    completed);
+            it->second = std::move(write);
+        }
+    }
+    wake_cv.notify_one();
+    notify(completed);
+    return command_id;
+}
+
+/**
+ * @brief 감지선 하나의 결과를 명령에 반영하고, 명령이 끝났으면 완료 목록에 넣습니다.
+ * @param write 끝난 쓰기
+ * @param status 감지선 하나의 결과
+ * @param completed 완료된 명령 목록 (출력)
+ */
+void CameraCommandQueue::resolve(const PendingWrite& write, CameraCommandStatus status,
+                                 vector<shared_ptr<Command>>& completed)
+{
+    Command& command = *write.command;
+    if (status == CameraCommandStatus::Failed)
+    {
+        command.result.failed_indexes.push_back(write.index);
+    }
+    else if (status == CameraCommandStatus::Superseded)
+    {
+        command.superseded = true;
+    }
+
+    if (--command.remaining > 0)
+    {
+        return;
+    }
+    if (!command.result.failed_indexes.empty())
+    {
+        command.result.status = CameraCommandStatus::Failed;
+    }
+    else
+    {
+        command.result.status = command.superseded ? CameraCommandStatus::Superseded : CameraCommandStatus::Confirmed;
+    }
+    completed.push_back(write.command);
+}
+
+/**
+ * @brief 완료된 명령의 콜백을 호출합니다.
+ * @param completed 완료된 명령 목록
+ */
+void CameraCommandQueue::notify(const vector<shared_ptr<Command>>& completed)
+{
+    for (const auto& command : completed)
+    {
+        cout << "[CameraCommand] 명령 " << command->result.command_id << " 완료 ("
+             << camera_command_status_name(command->result.status) << ")" << endl;
+        if (!command->callback)
+        {
+            continue;
+        }
+        try
+        {
+            command->callback(command->result);
+        }
+        catch (const exception& e)
+        {
+            cerr << "[CameraCommand] 완료 콜백 실패: " << e.what() << endl;
+        }
+    }
+}
+
+/**
+ * @brief 큐 스레드 본체. 준비된 쓰기를 모아 실행하고 결과에 따라 완료 또는 재시도
+ * @details 준비된 쓰기 중 제출 순서로 맨 앞과 같은 종류가 이어지는 것만 실행하며, 추가는 명령마다 PUT 한 번으로,
+ *          삭제는 동시 DELETE로 실행합니다. 실패한 쓰기는 같은 인덱스에 새 쓰기가 없고 다시 시도할 만한 오류이면
+ *          retry_base_ms * 2^(시도 횟수 - 1) 뒤에(최대 60초) 다시 실행합니다.
+ */
+void CameraCommandQueue::worker_loop()
+{
+    unique_lock<mutex> lock(queue_mutex);
+    while (running)
+    {
+        auto now = chrono::steady_clock::now();
+        auto next_ready = chrono::steady_clock::time_point::max();
+        vector<map<int, PendingWrite>::iterator> ready;
+        for (auto it = pending.begin(); it != pending.end(); ++it)
+        {
+            if (it->second.ready_at > now)
+            {
+                next_ready = min(next_ready, it->second.ready_at);
+                continue;
+            }
+            ready.push_back(it);
+        }
+
+        // 준비된 쓰기를 제출 순서(명령 번호)대로 보고, 맨 앞과 같은 종류가 이어지는 동안만 이번에 실행
+        // (삭제 뒤에 제출된 추가가 삭제보다 먼저 실행되지 않도록, 나머지는 다음 차례에 실행)
+        stable_sort(ready.begin(), ready.end(),
+                    [](const map<int, PendingWrite>::iterator& a, const map<int, PendingWrite>::iterator& b)
+                    { return a->second.command->result.command_id < b->second.command->result.command_id; });
+        vector<PendingWrite> puts;
+        vector<PendingWrite> deletes;
+        bool run_deletes = !ready.empty() && ready.front()->second.is_delete;
+        for (auto it : ready)
+        {
+            if (it->second.is_delete != run_deletes)
+            {
+                break;
+            }
+            it->second.attempts++;
+            (it->second.is_delete ? deletes : puts).push_back(std::move(it->second));
+            pending.erase(it);
+        }
+
+        if (puts.empty() && deletes.empty())
+        {
+            if (next_ready == chrono::steady_clock::time_point::max())
+            {
+                wake_cv.wait(lock);
+            }
+            else
+            {
+                wake_cv.wait_until(lock, next_ready);
+            }
+            continue;
+        }
+
+        for (const auto& write : puts)
+        {
+            in_flight_puts.push_back(write.index);
+        }
+        executing = true;
+        lock.unlock();
+
+        // 카메라 요청은 잠금 없이 실행 (그동안 들어온 명령은 다음 차례에 실행, 캐시는 성공한 요청마다 무효화됨)
+        // 추가는 명령마다 PUT 하나로 보내므로, 한 명령의 잘못된 감지선이 다른 클라이언트의 결과에 영향을 주지 않음
+        vector<CameraResponse> put_results(puts.size());
+        for (size_t begin = 0; begin < puts.size();)
+        {
+            size_t end = begin;
+            vector<CrossLine> lines;
+            while (end < puts.size() && puts[end].command == puts[begin].command)
+            {
+                lines.push_back(puts[end++].line);
+            }
+            CameraResponse response = g_camera_lines.put_lines(lines);
+            fill(put_results.begin() + begin, put_results.begin() + end, response);
+            begin = end;
+        }
+        vector<CameraResponse> delete_results;
+        if (!deletes.empty())
+        {
+            vector<int> indexes;
+            for (const auto& write : deletes)
+            {
+                indexes.push_back(write.index);
+            }
+            delete_results = g_camera_lines.delete_lines(indexes);
+        }
+
+        lock.lock();
+        in_flight_puts.clear();
+        vector<shared_ptr<Command>> completed;
+        auto finish = [&](PendingWrite& write, const CameraResponse& response)
+        {
+            if (camera_write_succeeded(response))
+            {
+                resolve(write, CameraCommandStatus::Confirmed, completed);
+                return;
+            }
+
+            const char* method = write.is_delete ? "DELETE" : "PUT";
+            bool superseded = pending.count(write.index) > 0;
+            if (!superseded && camera_write_retryable(response) && write.attempts < max_attempts)
+            {
+                int shift = min(write.attempts - 1, MAX_RETRY_SHIFT);
+                int delay_ms = static_cast<int>(min<long long>(static_cast<long long>(retry_base_ms) << shift,
+                                                               MAX_RETRY_DELAY_MS));
+                cerr << "[CameraCommand] " << method << " 실패 (index " << write.index << ", HTTP " << response.http_code
+                     << "), " << delay_ms << "ms 후 재시도 (" << write.attempts << "/" << max_attempts << ")" << endl;
+                write.ready_at = chrono::steady_clock::now() + chrono::milliseconds(delay_ms);
+                int index = write.index;
+                pending.emplace(index, std::move(write));
+                return;
+            }
+
+            cerr << "[CameraCommand] " << method << " 실패 (index " << write.index << ", HTTP " << response.http_code
+                 << ", 시도 " << write.attempts << "회)" << endl;
+            resolve(write, superseded ? CameraCommandStatus::Superseded : CameraCommandStatus::Failed, completed);
+        };
+        for (size_t i = 0; i < puts.size(); ++i)
+        {
+            finish(puts[i], put_results[i]);
+        }
+        for (size_t i = 0; i < deletes.size(); ++i)
+        {
+            finish(deletes[i], delete_results[i]);
+        }
+
+        // 콜백은 클라이언트에 쓰므로 잠금 없이 호출 (콜백 안에서 submit 가능)
+        lock.unlock();
+        notify(completed);
+        lock.lock();
+        executing = false;
+        idle_cv.notify_all();
+    }
+}
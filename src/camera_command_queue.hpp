@@ -0,0 +1,201 @@
+/**
+ * @file camera_command_queue.hpp
+ * @brief CCTV 감지선 쓰기 명령 비동기 큐 헤더 파일
+ * @details 요청 처리 스레드는 카메라 PUT/DELETE를 직접 기다리지 않고 이 큐에 명령을 넣은 뒤 바로 응답합니다.
+ *          백그라운드 스레드 하나가 대기 중인 명령을 제출 순서대로 모아, 같은 종류가 이어지는 동안 PUT은 명령마다
+ *          한 요청으로, DELETE는 동시 요청으로 실행하고, 실패하면 지수 백오프(최대 60초)로 재시도합니다.
+ *          같은 감지선 인덱스에 대한 아직 실행되지 않은 명령은 나중 명령으로 대체(coalescing)됩니다.
+ *          명령이 끝나면 완료 콜백이 큐 스레드에서 한 번 호출됩니다.
+ */
+
+#pragma once
+
+#include "camera_line_cache.hpp"
+#include "db_management.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 카메라 명령의 최종 결과
+ */
+enum class CameraCommandStatus
+{
+    Confirmed,  ///< 모든 감지선이 카메라에 반영됨
+    Superseded, ///< 일부 감지선이 실행 전에 나중 명령으로 대체됨 (실패는 없음)
+    Failed      ///< 재시도 후에도 반영하지 못한 감지선이 있음
+};
+
+/**
+ * @brief 완료 콜백으로 전달되는 카메라 명령 결과
+ */
+struct CameraCommandResult
+{
+    uint64_t command_id;             ///< submit_put/submit_delete가 반환한 명령 번호
+    CameraCommandStatus status;      ///< 최종 결과
+    std::vector<int> indexes;        ///< 명령에 포함된 감지선 인덱스
+    std::vector<int> failed_indexes; ///< 반영하지 못한 감지선 인덱스
+};
+
+/**
+ * @brief 카메라 명령 완료 콜백 (큐 스레드 또는 대체를 일으킨 submit 호출 스레드에서 호출)
+ */
+using CameraCommandCallback = std::function<void(const CameraCommandResult&)>;
+
+/**
+ * @brief 결과를 프로토콜 문자열("confirmed", "superseded", "failed")로 변환합니다.
+ * @param status 명령 결과
+ * @return 결과 문자열
+ */
+const char* camera_command_status_name(CameraCommandStatus status);
+
+/**
+ * @class CameraCommandQueue
+ * @brief 감지선 인덱스별로 합쳐지는 카메라 쓰기 명령 큐
+ */
+class CameraCommandQueue
+{
+public:
+    /**
+     * @brief 소멸자. 실행 중인 큐 스레드를 중지함
+     */
+    ~CameraCommandQueue();
+
+    /**
+     * @brief 큐 스레드를 시작합니다.
+     * @param max_attempts 감지선 하나당 최대 시도 횟수 (1이면 재시도 없음)
+     * @param retry_base_ms 첫 재시도 대기 시간(ms), 이후 시도마다 두 배
+     */
+    void start(int max_attempts, int retry_base_ms);
+
+    /**
+     * @brief 큐 스레드를 중지합니다. 실행 중인 요청은 끝까지 기다리고, 남은 명령은 실패로 완료합니다.
+     */
+    void stop();
+
+    /**
+     * @brief 감지선 추가(PUT) 명령을 넣습니다.
+     * @param lines 추가할 감지선 목록 (카메라 좌표계)
+     * @param callback 완료 콜백 (nullptr 가능)
+     * @return 명령 번호 (lines가 비어 있으면 0, 콜백 호출 없음)
+     */
+    uint64_t submit_put(const std::vector<CrossLine>& lines, CameraCommandCallback callback);
+
+    /**
+     * @brief 감지선 삭제(DELETE) 명령을 넣습니다.
+     * @param indexes 삭제할 감지선 인덱스 목록
+     * @param callback 완료 콜백 (nullptr 가능)
+     * @return 명령 번호 (indexes가 비어 있으면 0, 콜백 호출 없음)
+     */
+    uint64_t submit_delete(const std::vector<int>& indexes, CameraCommandCallback callback);
+
+    /**
+     * @brief 아직 카메라에 반영되지 않은(대기 또는 실행 중인) 추가 명령의 감지선 인덱스를 반환합니다.
+     * @details 인덱스가 여기서 빠지는 시점에는 CCTV 감지선 캐시가 이미 무효화되어 있습니다.
+     * @return 감지선 인덱스 목록
+     */
+    std::vector<int> pending_put_indexes();
+
+    /**
+     * @brief 대기 중이거나 실행 중인 명령이 모두 끝나고 완료 콜백까지 호출될 때까지 기다립니다. (종료 전 정리용)
+     * @param deadline 최대 대기 시각
+     * @return 모두 끝났으면 true, 시간 초과 시 false
+     */
+    bool wait_idle(std::chrono::steady_clock::time_point deadline);
+
+private:
+    /**
+     * @brief submit 한 번에 해당하는 명령 (감지선 전체가 끝나면 완료)
+     */
+    struct Command
+    {
+        CameraCommandResult result;
+        size_t remaining = 0;
+        bool superseded = false;
+        CameraCommandCallback callback;
+    };
+
+    /**
+     * @brief 감지선 하나에 대한 대기 중인 쓰기
+     */
+    struct PendingWrite
+    {
+        bool is_delete = false;
+        CrossLine line;
+        int index = 0;
+        int attempts = 0;
+        std::chrono::steady_clock::time_point ready_at;
+        std::shared_ptr<Command> command;
+    };
+
+    /**
+     * @brief 쓰기 목록을 하나의 명령으로 큐에 넣습니다.
+     * @param writes 감지선별 쓰기 목록
+     * @param callback 완료 콜백
+     * @return 명령 번호 (writes가 비어 있으면 0)
+     */
+    uint64_t submit(std::vector<PendingWrite> writes, CameraCommandCallback callback);
+
+    /**
+     * @brief 감지선 하나의 결과를 명령에 반영하고, 명령이 끝났으면 완료 목록에 넣습니다. (queue_mutex 보유 상태에서 호출)
+     * @param write 끝난 쓰기
+     * @param status 감지선 하나의 결과
+     * @param completed 완료된 명령 목록 (출력)
+     */
+    void resolve(const PendingWrite& write, CameraCommandStatus status,
+                 std::vector<std::shared_ptr<Command>>& completed);
+
+    /**
+     * @brief 완료된 명령의 콜백을 호출합니다. (queue_mutex 없이 호출)
+     * @param completed 완료된 명령 목록
+     */
+    void notify(const std::vector<std::shared_ptr<Command>>& completed);
+
+    /**
+     * @brief 큐 스레드 본체. 준비된 쓰기를 모아 실행하고 결과에 따라 완료 또는 재시도
+     */
+    void worker_loop();
+
+    /**
+     * @brief 감지선 인덱스별 대기 중인 쓰기 (실행 중인 쓰기는 포함하지 않음)
+     */
+    std::map<int, PendingWrite> pending;
+
+    /**
+     * @brief 실행 중인 추가 명령의 감지선 인덱스
+     */
+    std::vector<int> in_flight_puts;
+
+    /**
+     * @brief 큐 보호용 뮤텍스, 큐 스레드 깨우기 신호, 다음 명령 번호
+     */
+    std::mutex queue_mutex;
+    std::condition_variable wake_cv;
+    uint64_t next_command_id = 1;
+
+    /**
+     * @brief 큐 스레드가 카메라 요청 또는 완료 콜백을 실행 중인지 여부, 큐가 비었음을 알리는 신호
+     */
+    bool executing = false;
+    std::condition_variable idle_cv;
+
+    /**
+     * @brief 큐 스레드 및 재시도 설정
+     */
+    std::thread worker;
+    bool running = false;
+    int max_attempts = 3;
+    int retry_base_ms = 500;
+};
+
+/**
+ * @brief 서버 전역 카메라 명령 큐 인스턴스
+ */
+extern CameraCommandQueue g_camera_commands;
@@ -0,0 +1,238 @@
+/**
+ * @file camera_line_cache.cpp
+ * @brief CCTV 라인 크로싱 설정 캐시 구현 파일
+ * @details 조건부 GET/해시 비교 기반 갱신, 실패 시 재시도 간격 조절, 쓰기 성공 시 무효화를 구현합니다.
+ */
+
+#include "camera_line_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 CCTV 감지선 캐시 인스턴스
+ */
+CameraLineCache g_camera_lines;
+
+/**
+ * @brief 카메라 linecrossing 응답 본문에서 감지선 목록을 읽습니다.
+ * @param body 응답 본문 (JSON 문자열)
+ * @param lines 감지선 목록 (출력)
+ * @return 파싱 성공 시 true
+ */
+static bool parse_camera_lines(const string& body, vector<CrossLine>& lines)
+{
+    try
+    {
+        json j = json::parse(body);
+        // "lineCrossing" 배열의 첫 번째 요소 안에 있는 "line" 배열을 순회
+        for (const auto& item : j["lineCrossing"][0]["line"])
+        {
+            CrossLine cl;
+            cl.index = item["index"];
+            cl.name = item["name"];
+            cl.mode = item["mode"];
+            cl.x1 = item["lineCoordinates"][0]["x"];
+            cl.y1 = item["lineCoordinates"][0]["y"];
+            cl.x2 = item["lineCoordinates"][1]["x"];
+            cl.y2 = item["lineCoordinates"][1]["y"];
+            lines.push_back(cl);
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "[CameraCache] linecrossing 응답 파싱 실패: " << e.what() << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 소멸자. 실행 중인 갱신 스레드를 중지함
+ */
+CameraLineCache::~CameraLineCache()
+{
+    stop();
+}
+
+/**
+ * @brief 갱신 스레드를 시작합니다. (첫 갱신은 스레드에서 바로 실행)
+ * @param refresh_interval_sec 주기적 갱신 간격(초)
+ */
+void CameraLineCache::start(int refresh_interval_sec)
+{
+    if (running.exchange(true))
+    {
+        return;
+    }
+    this->refresh_interval_sec = refresh_interval_sec > 0 ? refresh_interval_sec : 30;
+    worker = thread(&CameraLineCache::worker_loop, this);
+    cout << "[CameraCache] 갱신 스레드 시작 (interval=" << this->refresh_interval_sec << "s)" << endl;
+}
+
+/**
+ * @brief 갱신 스레드를 중지하고 종료를 기다립니다.
+ */
+void CameraLineCache::stop()
+{
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        if (!running.exchange(false))
+        {
+            return;
+        }
+    }
+    wake_cv.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief 카메라 쓰기 요청이 성공했는지 확인합니다.
+ * @param response 요청 결과
+ * @return 전송에 성공하고 HTTP 2xx이면 true
+ */
+static bool camera_write_succeeded(const CameraResponse& response)
+{
+    return response.result == CURLE_OK && response.http_code >= 200 && response.http_code < 300;
+}
+
+/**
+ * @brief 현재 CCTV 감지선 목록을 반환합니다. (카메라에 접근하지 않음)
+ * @return 불변 스냅샷 포인터
+ */
+shared_ptr<const CameraLineSnapshot> CameraLineCache::lines()
+{
+    return atomic_load(&current);
+}
+
+/**
+ * @brief 마지막 무효화 이후 갱신에 성공했는지 확인합니다.
+ * @details 갱신은 스냅샷을 공개한 뒤에 refreshed_epoch를 기록하므로, true를 본 뒤 읽은 스냅샷은 그 갱신 이후의
+ *          것입니다.
+ * @return 최신이면 true
+ */
+bool CameraLineCache::is_current() const
+{
+    return refreshed_epoch.load() == invalidations.load();
+}
+
+/**
+ * @brief CCTV에 여러 감지선을 하나의 PUT 요청으로 추가하고, 성공하면 캐시를 무효화합니다.
+ * @param lines 추가할 감지선 목록 (카메라 좌표계)
+ * @return 요청 결과
+ */
+CameraResponse CameraLineCache::put_lines(const vector<CrossLine>& lines)
+{
+    CameraResponse response = putLines(lines);
+    if (camera_write_succeeded(response))
+    {
+        invalidate();
+    }
+    return response;
+}
+
+/**
+ * @brief CCTV에서 여러 감지선을 동시에 삭제하고, 하나라도 성공하면 캐시를 무효화합니다.
+ * @param indexes 삭제할 감지선 인덱스 목록
+ * @return 인덱스와 같은 순서의 요청 결과 목록
+ */
+vector<CameraResponse> CameraLineCache::delete_lines(const vector<int>& indexes)
+{
+    vector<CameraResponse> results = deleteLines(indexes);
+    if (any_of(results.begin(), results.end(), camera_write_succeeded))
+    {
+        invalidate();
+    }
+    return results;
+}
+
+/**
+ * @brief 캐시를 무효화하고 갱신 스레드를 깨웁니다.
+ */
+void CameraLineCache::invalidate()
+{
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        invalidations++;
+    }
+    wake_cv.notify_all();
+}
+
+/**
+ * @brief 카메라에서 설정을 다시 읽어 바뀌었으면 새 스냅샷을 공개합니다.
+ * @details 이전 응답에 ETag가 있었으면 If-None-Match로 요청하여 304이면 그대로 둡니다. ETag가 없는 카메라는
+ *          본문 해시가 같으면 파싱을 건너뜁니다. 요청 전에 읽은 무효화 횟수를 기록하므로, 요청 도중 쓰기가 있었다면
+ *          갱신 후에도 stale로 남아 갱신 스레드가 바로 다시 읽습니다.
+ * @return 성공(변경 없음 포함) 시 true
+ */
+bool CameraLineCache::refresh()
+{
+    uint64_t epoch = invalidations.load();
+    CameraResponse response = getLines(etag);
+
+    if (response.result != CURLE_OK || (response.http_code != 200 && response.http_code != 304))
+    {
+        cerr << "[CameraCache] CCTV 감지선 조회 실패 (HTTP " << response.http_code << ")" << endl;
+        return false;
+    }
+
+    if (response.http_code == 304)
+    {
+        refreshed_epoch = epoch;
+        return true;
+    }
+
+    size_t hash = std::hash<string>{}(response.body);
+    auto base = atomic_load(&current);
+    if (base->valid && hash == body_hash)
+    {
+        etag = response.etag;
+        refreshed_epoch = epoch;
+        return true;
+    }
+
+    auto next = make_shared<CameraLineSnapshot>();
+    if (!parse_camera_lines(response.body, next->lines))
+    {
+        return false;
+    }
+    next->valid = true;
+    next->generation = base->generation + 1;
+    atomic_store(&current, shared_ptr<const CameraLineSnapshot>(std::move(next)));
+
+    etag = response.etag;
+    body_hash = hash;
+    refreshed_epoch = epoch;
+    cout << "[CameraCache] CCTV 감지선 갱신 (" << atomic_load(&current)->lines.size() << "개)" << endl;
+    return true;
+}
+
+/**
+ * @brief 갱신 스레드 본체. 주기마다 또는 무효화될 때 갱신하고, 실패하면 간격을 늘려 가며 다시 시도
+ * @details 카메라가 응답하지 않는 동안에도 요청은 그대로 이 스레드 하나만 보내며, 재시도 간격은 1초부터 두 배씩
+ *          늘어 갱신 주기에서 멈춥니다. 그동안의 조회는 마지막 스냅샷으로 응답합니다.
+ */
+void CameraLineCache::worker_loop()
+{
+    const chrono::seconds interval(refresh_interval_sec);
+    chrono::seconds retry_delay(1);
+    while (running.load())
+    {
+        uint64_t seen = invalidations.load();
+        bool ok = refresh();
+        chrono::seconds wait = ok ? interval : min(retry_delay, interval);
+        retry_delay = ok ? chrono::seconds(1) : min(retry_delay * 2, interval);
+
+        // 실패한 뒤에는 새 쓰기로 무효화되어도 재시도 간격을 지킴 (카메라가 복구될 때까지 요청을 줄임)
+        unique_lock<mutex> lock(wake_mutex);
+        wake_cv.wait_for(lock, wait, [this, seen, ok]
+                         { return !running.load() || (ok && invalidations.load() != seen); });
+    }
+    cout << "[CameraCache] 갱신 스레드 종료" << endl;
+}
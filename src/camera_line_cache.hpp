@@ -0,0 +1,135 @@
+/**
+ * @file camera_line_cache.hpp
+ * @brief CCTV 라인 크로싱 설정 캐시 헤더 파일
+ * @details 카메라의 linecrossing 설정을 백그라운드 스레드에서 주기적으로 읽어 불변 스냅샷으로 보관합니다.
+ *          ETag를 주는 카메라에는 조건부 GET(If-None-Match)을, 그렇지 않으면 응답 본문 해시 비교를 사용하여
+ *          바뀌지 않은 설정은 다시 파싱하지 않습니다. 이 캐시를 통한 PUT/DELETE가 성공하면 캐시를 무효화하여 갱신
+ *          스레드가 바로 다시 읽습니다. 조회 요청은 카메라에 접근하지 않고 항상 현재 스냅샷으로 응답합니다.
+ */
+
+#pragma once
+
+#include "curl_camera.hpp"
+#include "db_management.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 특정 시점의 CCTV 감지선 목록 (공개 후에는 수정하지 않음)
+ */
+struct CameraLineSnapshot
+{
+    std::vector<CrossLine> lines; ///< CCTV에 설정된 감지선 (카메라 좌표계, 응답 순서)
+    bool valid = false;           ///< 카메라에서 한 번이라도 읽어 왔으면 true
+    uint64_t generation = 0;      ///< 내용이 바뀌어 공개될 때마다 1씩 증가하는 세대 번호
+};
+
+/**
+ * @class CameraLineCache
+ * @brief CCTV 라인 크로싱 설정의 백그라운드 갱신 캐시
+ * @details 무효화 횟수(invalidations)와 마지막으로 성공한 갱신이 시작될 때의 무효화 횟수(refreshed_epoch)를 비교하여,
+ *          갱신 도중 쓰기가 일어나도 오래된 응답이 최신으로 취급되지 않게 합니다.
+ */
+class CameraLineCache
+{
+public:
+    /**
+     * @brief 소멸자. 실행 중인 갱신 스레드를 중지함
+     */
+    ~CameraLineCache();
+
+    /**
+     * @brief 갱신 스레드를 시작합니다. (첫 갱신은 스레드에서 바로 실행)
+     * @param refresh_interval_sec 주기적 갱신 간격(초)
+     */
+    void start(int refresh_interval_sec);
+
+    /**
+     * @brief 갱신 스레드를 중지하고 종료를 기다립니다.
+     */
+    void stop();
+
+    /**
+     * @brief 현재 CCTV 감지선 목록을 반환합니다. (카메라에 접근하지 않음)
+     * @details 무효화된 뒤 아직 갱신되지 않았으면 오래된 스냅샷일 수 있습니다. 최신 여부는 스냅샷을 읽기 전에
+     *          is_current()로 확인합니다.
+     * @return 불변 스냅샷 포인터 (한 번도 읽지 못했으면 valid == false)
+     */
+    std::shared_ptr<const CameraLineSnapshot> lines();
+
+    /**
+     * @brief 마지막 무효화 이후 갱신에 성공했는지 확인합니다.
+     * @details 이 호출 뒤에 읽은 스냅샷은 호출 시점까지의 쓰기를 모두 반영합니다.
+     * @return 최신이면 true
+     */
+    bool is_current() const;
+
+    /**
+     * @brief CCTV에 여러 감지선을 하나의 PUT 요청으로 추가하고, 성공하면 캐시를 무효화합니다.
+     * @param lines 추가할 감지선 목록 (카메라 좌표계)
+     * @return 요청 결과
+     */
+    CameraResponse put_lines(const std::vector<CrossLine>& lines);
+
+    /**
+     * @brief CCTV에서 여러 감지선을 동시에 삭제하고, 하나라도 성공하면 캐시를 무효화합니다.
+     * @param indexes 삭제할 감지선 인덱스 목록
+     * @return 인덱스와 같은 순서의 요청 결과 목록
+     */
+    std::vector<CameraResponse> delete_lines(const std::vector<int>& indexes);
+
+    /**
+     * @brief 캐시를 무효화하고 갱신 스레드를 깨웁니다.
+     */
+    void invalidate();
+
+private:
+    /**
+     * @brief 카메라에서 설정을 다시 읽어 바뀌었으면 새 스냅샷을 공개합니다. (갱신 스레드에서만 호출)
+     * @return 성공(변경 없음 포함) 시 true
+     */
+    bool refresh();
+
+    /**
+     * @brief 갱신 스레드 본체. 주기마다 또는 무효화될 때 갱신하고, 실패하면 간격을 늘려 가며 다시 시도
+     */
+    void worker_loop();
+
+    /**
+     * @brief 현재 스냅샷 (std::atomic_load/atomic_store로만 접근)
+     */
+    std::shared_ptr<const CameraLineSnapshot> current = std::make_shared<const CameraLineSnapshot>();
+
+    /**
+     * @brief 변경 감지 상태 (ETag, 응답 본문 해시, 갱신 스레드만 접근)
+     */
+    std::string etag;
+    size_t body_hash = 0;
+
+    /**
+     * @brief 무효화 횟수와 마지막 성공 갱신 시작 시점의 무효화 횟수 (다르면 stale)
+     */
+    std::atomic<uint64_t> invalidations{1};
+    std::atomic<uint64_t> refreshed_epoch{0};
+
+    /**
+     * @brief 갱신 스레드 및 종료/깨우기 신호
+     */
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    int refresh_interval_sec = 30;
+};
+
+/**
+ * @brief 서버 전역 CCTV 감지선 캐시 인스턴스
+ */
+extern CameraLineCache g_camera_lines;
@@ -0,0 +1,288 @@
+/**
+ * @file client_session.cpp
+ * @brief 클라이언트 연결 세션 구현 파일
+ * @details SSL ex_data를 이용한 세션 조회, 직렬화된 메시지 송수신, 연결 시간 초과 타이머를 구현합니다.
+ */
+
+#include "client_session.hpp"
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * @brief 세션 포인터를 저장하는 SSL ex_data 인덱스를 반환합니다. (처음 호출 시 한 번 할당)
+ * @return ex_data 인덱스
+ */
+static int session_ex_index()
+{
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+/**
+ * @brief 길이 접두사와 본문을 전송합니다. (호출자가 쓰기 직렬화를 보장)
+ * @details 접두사와 본문을 한 버퍼로 합쳐 SSL_write 한 번으로 보냅니다. 4바이트 접두사만 담긴 TLS 레코드를 따로
+ *          보내면 Nagle 알고리즘이 본문 전송을 상대의 지연 ACK(약 40ms)까지 붙잡을 수 있습니다.
+ * @param ssl 클라이언트 SSL 연결
+ * @param payload 전송할 메시지 본문
+ * @param flags 길이 접두사에 더할 플래그 비트 (FRAME_COMPRESSED_FLAG)
+ * @return 성공 시 true, 실패 시 false
+ */
+static bool send_frame(SSL* ssl, const string& payload, uint32_t flags)
+{
+    uint32_t net_len = htonl(static_cast<uint32_t>(payload.size()) | flags);
+    string frame(reinterpret_cast<const char*>(&net_len), sizeof(net_len));
+    frame += payload;
+    return sendAll(ssl, frame.data(), frame.size(), 0) != -1;
+}
+
+/**
+ * @brief 시간 초과된 연결의 소켓을 shutdown합니다. (타이머 휠 스레드에서 호출)
+ * @details 디스크립터는 닫지 않으므로, 막혀 있던 읽기/쓰기가 실패하면 연결을 처리하는 스레드가 평소처럼 정리합니다.
+ * @param client_socket 소켓 디스크립터
+ * @param reason 로그에 남길 이유
+ */
+static void shutdown_timed_out(int client_socket, const char* reason)
+{
+    cerr << "[Session] " << reason << ", 연결을 끊습니다. (fd " << client_socket << ")" << endl;
+    shutdown(client_socket, SHUT_RDWR);
+}
+
+/**
+ * @brief 생성자
+ * @param ssl 클라이언트 SSL 연결
+ */
+ClientSession::ClientSession(SSL* ssl) : ssl(ssl)
+{
+}
+
+/**
+ * @brief 새 세션을 만들어 SSL 객체에 연결합니다.
+ * @param ssl 클라이언트 SSL 연결
+ * @return 세션
+ */
+shared_ptr<ClientSession> ClientSession::attach(SSL* ssl)
+{
+    shared_ptr<ClientSession> session(new ClientSession(ssl));
+    SSL_set_ex_data(ssl, session_ex_index(), session.get());
+    return session;
+}
+
+/**
+ * @brief SSL 객체에 연결된 세션을 찾습니다.
+ * @param ssl 클라이언트 SSL 연결
+ * @return 세션 (없으면 nullptr)
+ */
+shared_ptr<ClientSession> ClientSession::from(SSL* ssl)
+{
+    auto* session = static_cast<ClientSession*>(SSL_get_ex_data(ssl, session_ex_index()));
+    return session ? session->shared_from_this() : nullptr;
+}
+
+/**
+ * @brief 메시지 하나를 연결의 인코딩으로 직렬화하여 4바이트 길이 접두사와 함께 전송합니다.
+ * @param message 전송할 메시지
+ * @return 성공 시 true, 연결이 닫혔거나 전송 실패 시 false
+ */
+bool ClientSession::send_json(const json& message)
+{
+    lock_guard<mutex> lock(write_mutex);
+    if (!open)
+    {
+        return false;
+    }
+    return send_payload_locked(encode_message(message, encoding));
+}
+
+/**
+ * @brief 메시지 하나를 현재 인코딩으로 전송한 뒤 이후 송수신 인코딩을 바꿉니다.
+ * @param reply 협상 응답
+ * @param encoding 이후 메시지 인코딩
+ * @return 성공 시 true, 연결이 닫혔거나 전송 실패 시 false
+ */
+bool ClientSession::send_json_and_switch_encoding(const json& reply, MessageEncoding encoding)
+{
+    lock_guard<mutex> lock(write_mutex);
+    if (!open)
+    {
+        return false;
+    }
+    bool sent = send_payload_locked(encode_message(reply, this->encoding));
+    this->encoding = encoding;
+    return sent;
+}
+
+/**
+ * @brief 전송할 본문을 필요하면 압축하여 전송합니다.
+ * @details 임계값보다 작은 메시지는 압축하지 않으므로 작은 응답과 BBox push에는 압축 비용이 들지 않습니다.
+ * @param payload 직렬화된 메시지
+ * @return 성공 시 true, 전송 실패 시 false
+ */
+bool ClientSession::send_payload_locked(const string& payload)
+{
+    const string* body = &payload;
+    uint32_t flags = 0;
+    string compressed;
+    if (compressor && payload.size() >= compression_threshold)
+    {
+        if (compressor->compress(payload, compressed) && compressed.size() < payload.size())
+        {
+            compressed_messages++;
+            compressed_input_bytes += payload.size();
+            compressed_output_bytes += compressed.size();
+            body = &compressed;
+            flags = FRAME_COMPRESSED_FLAG;
+        }
+    }
+
+    // 상대가 읽지 않아 송신 버퍼가 가득 찬 채로 멈추면 타이머가 소켓을 끊어 쓰기(와 write_mutex)를 풀어 줌
+    if (write_timer)
+    {
+        g_timer_wheel.arm(write_timer, write_stall_timeout);
+    }
+    bool sent = send_frame(ssl, *body, flags);
+    if (write_timer)
+    {
+        g_timer_wheel.disarm(write_timer);
+    }
+    return sent;
+}
+
+/**
+ * @brief 이후 전송하는 메시지에 압축을 켭니다.
+ * @param codec 압축 방식 (CompressionCodec::None이면 압축을 끔)
+ * @param level 압축 수준
+ * @param threshold 압축할 최소 본문 크기(byte)
+ * @param max_message_bytes 수신한 압축 메시지의 최대 원본 크기(byte)
+ */
+void ClientSession::enable_compression(CompressionCodec codec, int level, size_t threshold, size_t max_message_bytes)
+{
+    lock_guard<mutex> lock(write_mutex);
+    compressor.reset(codec == CompressionCodec::None ? nullptr : new MessageCompressor(codec, level));
+    compression_threshold = threshold;
+    this->max_message_bytes = max_message_bytes;
+}
+
+/**
+ * @brief 수신한 프레임의 본문을 해제하고 연결의 인코딩으로 읽습니다. (연결을 처리하는 스레드에서만 호출)
+ * @details 압축 컨텍스트와 인코딩을 바꾸는 함수도 같은 스레드에서만 호출되므로 write_mutex 없이 사용합니다.
+ * @param data 프레임 본문
+ * @param compressed 길이 접두사에 압축 비트가 있었는지 여부
+ * @param message 메시지 (출력)
+ * @return 성공 시 true, 압축을 협상하지 않았거나 해제 또는 디코딩에 실패하면 false
+ */
+bool ClientSession::receive_frame(const vector<char>& data, bool compressed, json& message)
+{
+    try
+    {
+        if (!compressed)
+        {
+            message = decode_message(data.data(), data.size(), encoding);
+            return true;
+        }
+
+        string decompressed;
+        if (!compressor || !compressor->decompress(data.data(), data.size(), max_message_bytes, decompressed))
+        {
+            cerr << "[Session] 압축 메시지 해제 실패 (협상되지 않았거나 손상됨)" << endl;
+            return false;
+        }
+        message = decode_message(decompressed.data(), decompressed.size(), encoding);
+        return true;
+    }
+    catch (const json::exception& e)
+    {
+        cerr << "[Session] " << message_encoding_name(encoding) << " 메시지 디코딩 실패: " << e.what() << endl;
+        return false;
+    }
+}
+
+/**
+ * @brief 연결의 시간 초과 타이머를 만들고 송신 정체 감시를 켭니다.
+ * @param client_socket 만료 시 shutdown할 소켓 디스크립터
+ * @param write_stall_timeout 메시지 하나를 보내는 데 허용하는 시간 (0이면 사용 안 함)
+ */
+void ClientSession::start_timeouts(int client_socket, chrono::milliseconds write_stall_timeout)
+{
+    idle_timer = g_timer_wheel.add([client_socket] { shutdown_timed_out(client_socket, "수신 유휴 시간 초과"); });
+    lock_guard<mutex> lock(write_mutex);
+    if (write_stall_timeout.count() > 0)
+    {
+        write_timer = g_timer_wheel.add([client_socket] { shutdown_timed_out(client_socket, "송신 정체 시간 초과"); });
+        this->write_stall_timeout = write_stall_timeout;
+    }
+}
+
+/**
+ * @brief 수신 유휴 시간 초과를 켭니다.
+ * @param idle_timeout 다음 메시지를 기다리는 최대 시간 (0이면 사용 안 함)
+ */
+void ClientSession::enable_idle_timeout(chrono::milliseconds idle_timeout)
+{
+    this->idle_timeout = idle_timeout;
+}
+
+/**
+ * @brief 다음 메시지를 기다리기 시작할 때 수신 유휴 타이머를 설정합니다.
+ */
+void ClientSession::begin_read_wait()
+{
+    if (idle_timer && idle_timeout.count() > 0)
+    {
+        g_timer_wheel.arm(idle_timer, idle_timeout);
+    }
+}
+
+/**
+ * @brief 메시지를 받은 뒤 요청을 처리하는 동안 수신 유휴 타이머를 해제합니다.
+ */
+void ClientSession::end_read_wait()
+{
+    if (idle_timer && idle_timeout.count() > 0)
+    {
+        g_timer_wheel.disarm(idle_timer);
+    }
+}
+
+/**
+ * @brief 세션을 닫고 SSL 객체와의 연결을 끊습니다.
+ * @details 타이머 콜백은 write_mutex를 잡지 않으므로 잠금 안에서 타이머를 지워도 됩니다. 반환 후에는 콜백이
+ *          실행되지 않으므로 호출자가 소켓을 닫아도 다른 연결의 디스크립터를 shutdown하지 않습니다.
+ */
+void ClientSession::close()
+{
+    lock_guard<mutex> lock(write_mutex);
+    open = false;
+    SSL_set_ex_data(ssl, session_ex_index(), nullptr);
+    g_timer_wheel.remove(idle_timer);
+    g_timer_wheel.remove(write_timer);
+    idle_timer = 0;
+    write_timer = 0;
+    if (compressed_messages > 0)
+    {
+        cout << "[Session] 압축 전송 " << compressed_messages << "건 (" << compressed_input_bytes << " -> "
+             << compressed_output_bytes << " bytes)" << endl;
+    }
+}
+
+/**
+ * @brief 메시지 하나를 직렬화하여 4바이트 길이 접두사와 함께 전송합니다.
+ * @param ssl 클라이언트 SSL 연결
+ * @param message 전송할 메시지
+ * @return 성공 시 true, 실패 시 false
+ */
+bool send_framed_json(SSL* ssl, const json& message)
+{
+    auto session = ClientSession::from(ssl);
+    if (session)
+    {
+        return session->send_json(message);
+    }
+    return send_frame(ssl, message.dump(), 0);
+}
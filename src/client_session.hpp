@@ -0,0 +1,179 @@
+/**
+ * @file client_session.hpp
+ * @brief 클라이언트 연결 세션 헤더 파일
+ * @details 연결마다 하나의 ClientSession을 만들어 SSL 객체의 ex_data에 연결해 둡니다. 요청 처리 스레드, BBox push
+ *          스레드, 카메라 명령 완료 콜백처럼 서로 다른 스레드가 같은 연결에 쓰는 메시지를 세션의 쓰기 뮤텍스로
+ *          직렬화하고, 연결이 닫힌 뒤에는 쓰기를 건너뛰어 해제된 SSL에 접근하지 않게 합니다. 비동기 콜백은
+ *          std::weak_ptr<ClientSession>만 보관합니다. 압축을 협상한 연결은 임계값 이상의 메시지를 세션의 압축
+ *          컨텍스트로 압축해 보냅니다. 메시지는 JSON 객체로 주고받고, 연결에서 협상한 인코딩(JSON, MessagePack,
+ *          CBOR)으로의 변환은 세션이 송수신할 때만 합니다. 세션은 타이머 휠에 송신 정체 타이머(메시지 하나를 보내는
+ *          동안만 설정)와 수신 유휴 타이머(heartbeat를 보낸 연결에서 다음 메시지를 기다리는 동안만 설정)를 두고,
+ *          만료되면 소켓을 shutdown하여 막혀 있는 읽기/쓰기를 깨웁니다.
+ */
+
+#pragma once
+
+#include "json.hpp"
+#include "message_compression.hpp"
+#include "message_encoding.hpp"
+#include "ssl.hpp"
+#include "timer_wheel.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class ClientSession
+ * @brief 클라이언트 연결 하나의 송신 상태
+ */
+class ClientSession : public std::enable_shared_from_this<ClientSession>
+{
+public:
+    /**
+     * @brief 새 세션을 만들어 SSL 객체에 연결합니다.
+     * @param ssl 클라이언트 SSL 연결
+     * @return 세션 (연결을 처리하는 스레드가 연결 종료까지 보관)
+     */
+    static std::shared_ptr<ClientSession> attach(SSL* ssl);
+
+    /**
+     * @brief SSL 객체에 연결된 세션을 찾습니다.
+     * @details 연결을 처리하는 스레드(또는 종료 전에 join되는 스레드)에서만 호출합니다. 다른 스레드는 이 결과를
+     *          std::weak_ptr로 받아 보관합니다.
+     * @param ssl 클라이언트 SSL 연결
+     * @return 세션 (연결되지 않았거나 이미 닫혔으면 nullptr)
+     */
+    static std::shared_ptr<ClientSession> from(SSL* ssl);
+
+    /**
+     * @brief 메시지 하나를 연결의 인코딩으로 직렬화하여 4바이트 길이 접두사와 함께 전송합니다. (다른 스레드의 쓰기와
+     *        섞이지 않음)
+     * @details 압축을 켰고 본문이 임계값 이상이면 압축하며, 압축해도 작아지지 않으면 원본을 보냅니다.
+     * @param message 전송할 메시지
+     * @return 성공 시 true, 연결이 닫혔거나 전송 실패 시 false
+     */
+    bool send_json(const nlohmann::json& message);
+
+    /**
+     * @brief 메시지 하나를 현재 인코딩으로 전송한 뒤 이후 송수신 인코딩을 바꿉니다. (협상 응답 전용)
+     * @details 전송과 전환을 같은 쓰기 잠금 안에서 하므로, 다른 스레드의 메시지가 협상 응답보다 먼저 새 인코딩으로
+     *          나가거나 응답 뒤에 이전 인코딩으로 나가지 않습니다. 연결을 처리하는 스레드에서만 호출합니다.
+     * @param reply 협상 응답
+     * @param encoding 이후 메시지 인코딩
+     * @return 성공 시 true, 연결이 닫혔거나 전송 실패 시 false
+     */
+    bool send_json_and_switch_encoding(const nlohmann::json& reply, MessageEncoding encoding);
+
+    /**
+     * @brief 이후 전송하는 메시지에 압축을 켭니다.
+     * @param codec 압축 방식 (CompressionCodec::None이면 압축을 끔)
+     * @param level 압축 수준
+     * @param threshold 압축할 최소 본문 크기(byte)
+     * @param max_message_bytes 수신한 압축 메시지의 최대 원본 크기(byte)
+     */
+    void enable_compression(CompressionCodec codec, int level, size_t threshold, size_t max_message_bytes);
+
+    /**
+     * @brief 수신한 프레임의 본문을 해제하고 연결의 인코딩으로 읽습니다. (연결을 처리하는 스레드에서만 호출)
+     * @param data 프레임 본문
+     * @param compressed 길이 접두사에 압축 비트가 있었는지 여부
+     * @param message 메시지 (출력)
+     * @return 성공 시 true, 압축을 협상하지 않았거나 해제 또는 디코딩에 실패하면 false
+     */
+    bool receive_frame(const std::vector<char>& data, bool compressed, nlohmann::json& message);
+
+    /**
+     * @brief 연결의 시간 초과 타이머를 만들고 송신 정체 감시를 켭니다. (연결을 처리하는 스레드가 attach 직후 호출)
+     * @param client_socket 만료 시 shutdown할 소켓 디스크립터
+     * @param write_stall_timeout 메시지 하나를 보내는 데 허용하는 시간 (0이면 사용 안 함)
+     */
+    void start_timeouts(int client_socket, std::chrono::milliseconds write_stall_timeout);
+
+    /**
+     * @brief 수신 유휴 시간 초과를 켭니다. (heartbeat 요청 처리 시, 연결을 처리하는 스레드에서만 호출)
+     * @param idle_timeout 다음 메시지를 기다리는 최대 시간 (0이면 사용 안 함)
+     */
+    void enable_idle_timeout(std::chrono::milliseconds idle_timeout);
+
+    /**
+     * @brief 다음 메시지를 기다리기 시작할 때 수신 유휴 타이머를 설정합니다. (연결을 처리하는 스레드에서만 호출)
+     */
+    void begin_read_wait();
+
+    /**
+     * @brief 메시지를 받은 뒤 요청을 처리하는 동안 수신 유휴 타이머를 해제합니다. (연결을 처리하는 스레드에서만 호출)
+     */
+    void end_read_wait();
+
+    /**
+     * @brief 세션을 닫고 SSL 객체와의 연결을 끊습니다. (SSL_free 전에 호출)
+     * @details 진행 중인 쓰기가 끝날 때까지 기다리며(송신 정체 타이머가 막힌 쓰기를 깨움), 이후의 send_json()은
+     *          전송하지 않고 false를 반환합니다. 시간 초과 타이머도 지웁니다.
+     */
+    void close();
+
+private:
+    /**
+     * @brief 생성자. attach()로만 생성
+     * @param ssl 클라이언트 SSL 연결
+     */
+    explicit ClientSession(SSL* ssl);
+
+    /**
+     * @brief 클라이언트 SSL 연결 (open == false이면 접근하지 않음)
+     */
+    SSL* ssl;
+
+    /**
+     * @brief 쓰기 직렬화용 뮤텍스와 연결 상태
+     */
+    std::mutex write_mutex;
+    bool open = true;
+
+    /**
+     * @brief 전송할 본문을 필요하면 압축하여 전송합니다. (write_mutex를 잡은 상태에서 호출)
+     * @param payload 직렬화된 메시지
+     * @return 성공 시 true, 전송 실패 시 false
+     */
+    bool send_payload_locked(const std::string& payload);
+
+    /**
+     * @brief 메시지 인코딩 (변경은 연결을 처리하는 스레드가 write_mutex 안에서만 함)
+     */
+    MessageEncoding encoding = MessageEncoding::Json;
+
+    /**
+     * @brief 압축 컨텍스트(송신은 write_mutex 안에서 사용)와 설정
+     */
+    std::unique_ptr<MessageCompressor> compressor;
+    size_t compression_threshold = 0;
+    size_t max_message_bytes = 0;
+
+    /**
+     * @brief 압축 전송 통계 (연결 종료 시 로그)
+     */
+    uint64_t compressed_messages = 0;
+    uint64_t compressed_input_bytes = 0;
+    uint64_t compressed_output_bytes = 0;
+
+    /**
+     * @brief 시간 초과 타이머 (0이면 없음)와 설정 (idle_timeout은 연결을 처리하는 스레드만 사용)
+     */
+    TimerId idle_timer = 0;
+    TimerId write_timer = 0;
+    std::chrono::milliseconds idle_timeout{0};
+    std::chrono::milliseconds write_stall_timeout{0};
+};
+
+/**
+ * @brief 메시지 하나를 직렬화하여 4바이트 길이 접두사와 함께 전송합니다.
+ * @details SSL 객체에 세션이 연결되어 있으면 세션의 쓰기 뮤텍스 안에서 세션의 인코딩으로 전송하고, 없으면 JSON
+ *          텍스트로 전송합니다.
+ * @param ssl 클라이언트 SSL 연결
+ * @param message 전송할 메시지
+ * @return 성공 시 true, 실패 시 false
+ */
+bool send_framed_json(SSL* ssl, const nlohmann::json& message);
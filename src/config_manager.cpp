@@ -137,6 +137,81 @@ bool load_json_config()
             g_config.board_ports[to_string(i)] = port;
         }
 
+        // retention 설정 (항목이 없으면 기본값 사용)
+        json retention = config.value("retention", json::object());
+        g_config.retention_max_age_days = retention.value("max_age_days", 30);
+        g_config.retention_max_bytes = retention.value("max_bytes", 2147483648LL);
+        g_config.retention_batch_size = retention.value("batch_size", 200);
+        g_config.retention_interval_sec = retention.value("interval_sec", 60);
+        g_config.retention_vacuum_pages = retention.value("vacuum_pages_per_step", 256);
+        g_config.retention_vacuum_conversion = retention.value("vacuum_conversion", false);
+
+        // database 설정 (항목이 없으면 기본값 사용)
+        json database = config.value("database", json::object());
+        g_config.db_reader_count = database.value("reader_count", 4);
+        g_config.db_busy_timeout_ms = database.value("busy_timeout_ms", 5000);
+        g_config.db_log_sql = database.value("log_sql", false);
+        g_config.detection_queue_capacity = database.value("detection_queue_capacity", static_cast<size_t>(64));
+        g_config.detection_batch_size = database.value("detection_batch_size", static_cast<size_t>(16));
+        g_config.detection_max_attempts = database.value("detection_max_attempts", 3);
+
+        // camera 설정 (항목이 없으면 기본값 사용)
+        json camera = config.value("camera", json::object());
+        g_config.camera_request_timeout_ms = camera.value("request_timeout_ms", 5000);
+        g_config.camera_max_parallel_requests = camera.value("max_parallel_requests", 4);
+        g_config.camera_cache_refresh_sec = camera.value("cache_refresh_sec", 30);
+        g_config.camera_command_max_attempts = camera.value("command_max_attempts", 3);
+        g_config.camera_command_retry_base_ms = camera.value("command_retry_base_ms", 500);
+
+        // tls 설정 (항목이 없으면 기본값 사용)
+        json tls = config.value("tls", json::object());
+        g_config.tls_session_cache_size = tls.value("session_cache_size", 128L);
+        g_config.tls_session_timeout_sec = tls.value("session_timeout_sec", 3600L);
+        g_config.tls_ticket_key_rotation_sec = tls.value("ticket_key_rotation_sec", 3600);
+        g_config.tls_ktls = tls.value("ktls", true);
+        g_config.tls_handshake_timeout_ms = tls.value("handshake_timeout_ms", 10000);
+        g_config.tls_max_concurrent_handshakes = tls.value("max_concurrent_handshakes", 32);
+        g_config.tls_crypto_threads = tls.value("crypto_threads", 2);
+
+        // compression 설정 (항목이 없으면 기본값 사용)
+        json compression = config.value("compression", json::object());
+        g_config.compression_threshold_bytes = compression.value("threshold_bytes", static_cast<size_t>(1024));
+        g_config.compression_deflate_level = compression.value("deflate_level", 6);
+        g_config.compression_zstd_level = compression.value("zstd_level", 3);
+        g_config.compression_max_message_bytes =
+            compression.value("max_message_bytes", static_cast<size_t>(16 * 1024 * 1024));
+
+        // listener 설정 (항목이 없으면 기본값 사용)
+        json listener = config.value("listener", json::object());
+        g_config.listener_acceptors = listener.value("acceptors", 0);
+        g_config.listener_backlog = listener.value("backlog", 1024);
+        g_config.listener_pin_threads = listener.value("pin_threads", true);
+        g_config.listener_stats_interval_sec = listener.value("stats_interval_sec", 60);
+
+        // local_socket 설정 (항목이 없으면 기본값 사용)
+        json local_socket = config.value("local_socket", json::object());
+        g_config.local_socket_enabled = local_socket.value("enabled", false);
+        g_config.local_socket_path = local_socket.value("path", "server.sock");
+        g_config.local_socket_mode = stoi(local_socket.value("mode", "0660"), nullptr, 8);
+        g_config.local_socket_allowed_uids = local_socket.value("allowed_uids", vector<int>());
+        g_config.local_socket_allowed_gids = local_socket.value("allowed_gids", vector<int>());
+
+        // connection 설정 (항목이 없으면 기본값 사용)
+        json connection = config.value("connection", json::object());
+        g_config.connection_timer_tick_ms = connection.value("timer_tick_ms", 100);
+        g_config.connection_idle_timeout_sec = connection.value("idle_timeout_sec", 30);
+        g_config.connection_write_stall_timeout_ms = connection.value("write_stall_timeout_ms", 10000);
+        g_config.connection_keepalive_idle_sec = connection.value("keepalive_idle_sec", 10);
+        g_config.connection_keepalive_interval_sec = connection.value("keepalive_interval_sec", 5);
+        g_config.connection_keepalive_count = connection.value("keepalive_count", 3);
+
+        // restart 설정 (항목이 없으면 기본값 사용)
+        json restart = config.value("restart", json::object());
+        g_config.restart_enabled = restart.value("enabled", true);
+        g_config.restart_handoff_path = restart.value("handoff_path", "server.handoff.sock");
+        g_config.restart_handoff_ack_timeout_sec = restart.value("handoff_ack_timeout_sec", 60);
+        g_config.restart_drain_timeout_sec = restart.value("drain_timeout_sec", 30);
+
         cout << "[INFO] config.json 파일을 로드했습니다." << endl;
         return true;
     }
@@ -8,6 +8,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -55,6 +56,104 @@ struct AppConfig
     int retry_count;
     /** @brief config.json에서 로드되는 타임아웃(ms) */
     int timeout_ms;
+
+    /** @brief config.json에서 로드되는 감지 데이터 보존 기간(일) */
+    int retention_max_age_days;
+    /** @brief config.json에서 로드되는 DB 최대 사용 용량(바이트) */
+    long long retention_max_bytes;
+    /** @brief config.json에서 로드되는 보존 작업 1회 배치 크기(행) */
+    int retention_batch_size;
+    /** @brief config.json에서 로드되는 보존 작업 주기(초) */
+    int retention_interval_sec;
+    /** @brief config.json에서 로드되는 incremental_vacuum 1회당 페이지 수 */
+    int retention_vacuum_pages;
+    /** @brief config.json에서 로드되는 auto_vacuum 전환용 전체 VACUUM 허용 여부 (유지보수 시에만 켬) */
+    bool retention_vacuum_conversion;
+
+    /** @brief config.json에서 로드되는 server 읽기 전용 DB 연결 수 */
+    int db_reader_count;
+    /** @brief config.json에서 로드되는 DB 잠금 대기 시간(ms) */
+    int db_busy_timeout_ms;
+    /** @brief config.json에서 로드되는 SQL 디버그 로그(바인딩된 SQL 출력) 여부 */
+    bool db_log_sql;
+    /** @brief config.json에서 로드되는 control 감지 저장 큐 최대 길이(레코드) */
+    size_t detection_queue_capacity;
+    /** @brief config.json에서 로드되는 control 감지 저장 트랜잭션당 최대 레코드 수 */
+    size_t detection_batch_size;
+    /** @brief config.json에서 로드되는 control 감지 저장 실패 시 레코드당 최대 시도 횟수 */
+    int detection_max_attempts;
+
+    /** @brief config.json에서 로드되는 카메라 HTTP 요청 1건당 타임아웃(ms, 0이면 제한 없음) */
+    int camera_request_timeout_ms;
+    /** @brief config.json에서 로드되는 카메라로 동시에 여는 최대 연결 수 (0이면 제한 없음) */
+    int camera_max_parallel_requests;
+    /** @brief config.json에서 로드되는 CCTV 감지선 캐시 주기적 갱신 간격(초) */
+    int camera_cache_refresh_sec;
+    /** @brief config.json에서 로드되는 카메라 쓰기 명령의 감지선당 최대 시도 횟수 */
+    int camera_command_max_attempts;
+    /** @brief config.json에서 로드되는 카메라 쓰기 명령 첫 재시도 대기 시간(ms, 이후 두 배씩 증가) */
+    int camera_command_retry_base_ms;
+
+    /** @brief config.json에서 로드되는 TLS 서버 세션 캐시 최대 세션 수 */
+    long tls_session_cache_size;
+    /** @brief config.json에서 로드되는 TLS 세션(티켓 포함) 유효 시간(초) */
+    long tls_session_timeout_sec;
+    /** @brief config.json에서 로드되는 TLS 세션 티켓 키 교체 주기(초) */
+    int tls_ticket_key_rotation_sec;
+    /** @brief config.json에서 로드되는 커널 TLS(kTLS) 송신 오프로드 사용 여부 */
+    bool tls_ktls;
+    /** @brief config.json에서 로드되는 TLS 핸드셰이크 마감 시간(ms) */
+    int tls_handshake_timeout_ms;
+    /** @brief config.json에서 로드되는 동시에 진행할 수 있는 최대 TLS 핸드셰이크 수 */
+    int tls_max_concurrent_handshakes;
+    /** @brief config.json에서 로드되는 TLS 핸드셰이크 암호 연산 스레드 수 */
+    int tls_crypto_threads;
+    /** @brief config.json에서 로드되는 메시지 압축 최소 크기(byte) */
+    size_t compression_threshold_bytes;
+    /** @brief config.json에서 로드되는 deflate 압축 수준(1~9) */
+    int compression_deflate_level;
+    /** @brief config.json에서 로드되는 zstd 압축 수준(1~19) */
+    int compression_zstd_level;
+    /** @brief config.json에서 로드되는 수신 압축 메시지의 최대 원본 크기(byte) */
+    size_t compression_max_message_bytes;
+    /** @brief config.json에서 로드되는 SO_REUSEPORT 리스닝 소켓(수락 스레드) 수 (0이면 CPU 코어 수) */
+    int listener_acceptors;
+    /** @brief config.json에서 로드되는 리스닝 소켓별 listen 백로그 */
+    int listener_backlog;
+    /** @brief config.json에서 로드되는 수락 스레드 코어 고정 여부 */
+    bool listener_pin_threads;
+    /** @brief config.json에서 로드되는 수락 큐 통계 보고 주기(초) */
+    int listener_stats_interval_sec;
+    /** @brief config.json에서 로드되는 로컬 Unix 소켓 리스너 사용 여부 */
+    bool local_socket_enabled;
+    /** @brief config.json에서 로드되는 로컬 Unix 소켓 파일 경로 */
+    string local_socket_path;
+    /** @brief config.json에서 로드되는 로컬 Unix 소켓 파일 권한 (8진수 문자열, 예: "0660") */
+    int local_socket_mode;
+    /** @brief config.json에서 로드되는 로컬 연결을 추가로 허용할 uid 목록 (root와 서버 uid는 항상 허용) */
+    vector<int> local_socket_allowed_uids;
+    /** @brief config.json에서 로드되는 로컬 연결을 허용할 gid 목록 */
+    vector<int> local_socket_allowed_gids;
+    /** @brief config.json에서 로드되는 타이머 휠 틱 간격(ms, 연결 시간 초과의 해상도) */
+    int connection_timer_tick_ms;
+    /** @brief config.json에서 로드되는 수신 유휴 시간 초과(초, heartbeat를 보낸 연결에 적용, 0이면 사용 안 함) */
+    int connection_idle_timeout_sec;
+    /** @brief config.json에서 로드되는 송신 정체 시간 초과(ms, 메시지 하나를 보내는 데 허용하는 시간, 0이면 사용 안 함) */
+    int connection_write_stall_timeout_ms;
+    /** @brief config.json에서 로드되는 TCP keepalive 시작 전 유휴 시간(초, 0이면 keepalive 사용 안 함) */
+    int connection_keepalive_idle_sec;
+    /** @brief config.json에서 로드되는 TCP keepalive 탐침 간격(초) */
+    int connection_keepalive_interval_sec;
+    /** @brief config.json에서 로드되는 응답 없는 TCP keepalive 탐침 허용 횟수 */
+    int connection_keepalive_count;
+    /** @brief config.json에서 로드되는 무중단 재시작(리스닝 소켓 인계) 사용 여부 */
+    bool restart_enabled;
+    /** @brief config.json에서 로드되는 리스닝 소켓 인계용 Unix 소켓 경로 */
+    string restart_handoff_path;
+    /** @brief config.json에서 로드되는 새 서버가 리스너를 시작할 때까지 기다리는 최대 시간(초) */
+    int restart_handoff_ack_timeout_sec;
+    /** @brief config.json에서 로드되는 종료 전 연결 정리(drain) 최대 시간(초) */
+    int restart_drain_timeout_sec;
 };
 
 /**
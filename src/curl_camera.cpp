@@ -6,6 +6,9 @@
 
 #include "curl_camera.hpp"
 
+#include <mutex>
+#include <strings.h>
+
 /**
  * @brief libcurl의 응답 데이터를 저장하는 콜백 함수
  *
@@ -26,246 +29,506 @@ size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp)
 }
 
 /**
- * @brief 라인 크로싱 설정 정보를 GET 요청으로 받아옵니다.
- *
- * @return HTTP 응답 본문 (JSON 문자열)
+ * @brief 응답 헤더에서 ETag를 저장하는 콜백 함수
+ * @details 인증 challenge(401) 응답의 헤더가 먼저 들어올 수 있으므로, 새 상태 줄을 받으면 이전 값을 지웁니다.
+ * @param buffer 헤더 한 줄 (NUL 종료 아님)
+ * @param size 데이터 단위 크기
+ * @param nitems 데이터 단위 개수
+ * @param userdata 사용자 정의 포인터 (CameraResponse*)
+ * @return 처리한 데이터의 총 바이트 수
  */
-string getLines()
+static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata)
 {
-    string response_buffer;
-    try
+    size_t length = size * nitems;
+    CameraResponse* response = static_cast<CameraResponse*>(userdata);
+    string line(buffer, length);
+    if (line.compare(0, 5, "HTTP/") == 0)
     {
-        CURL* curl_handle; // curl 통신을 위한 핸들
+        response->etag.clear();
+    }
+    else if (line.size() > 5 && strncasecmp(line.c_str(), "ETag:", 5) == 0)
+    {
+        size_t begin = line.find_first_not_of(" \t", 5);
+        size_t end = line.find_last_not_of(" \t\r\n");
+        response->etag = (begin == string::npos || end < begin) ? "" : line.substr(begin, end - begin + 1);
+    }
+    return length;
+}
 
-        // 2. curl_easy 핸들 생성
-        // 각 통신 요청마다 이 핸들을 생성하고 설정해요.
-        curl_handle = curl_easy_init();
-        if (!curl_handle)
-        {
-            std::cerr << "curl_easy_init() 실패" << std::endl;
-            curl_global_cleanup();
-            return NULL;
-        }
-        // --- curl 명령어 옵션 설정 시작 ---
-        // 2.1. URL 설정
-        string url = "https://" + g_config.host + "/opensdk/WiseAI/configuration/linecrossing";
-        curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-
-        // 2.2. HTTP 메서드 설정 (GET)
-        // 기본이 GET이라 명시적으로 설정할 필요 없음
-
-        // 2.3. 인증 설정
-        curl_easy_setopt(curl_handle, CURLOPT_HTTPAUTH, CURLAUTH_DIGEST);
-        string auth_str = g_config.username + ":" + g_config.password;
-        curl_easy_setopt(curl_handle, CURLOPT_USERPWD, auth_str.c_str());
-
-        // 2.4. HTTPS 인증서 검증 비활성화
-        curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYHOST, 0L);
-
-        // 2.5. 커스텀 헤더 설정
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, "Accept: application/json");
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        string cookie_header = "Cookie: TRACKID=" + g_config.trackid;
-        headers = curl_slist_append(headers, cookie_header.c_str());
-        string origin_header = "Origin: https://" + g_config.host;
-        headers = curl_slist_append(headers, origin_header.c_str());
-        string referer_header = "Referer: https://" + g_config.host + "/home/setup/opensdk/html/WiseAI/index.html";
-        headers = curl_slist_append(headers, referer_header.c_str());
-        curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
-
-        // 2.6. 압축 지원 (--compressed)
-        // Accept-Encoding 헤더를 자동으로 추가하여 서버가 압축된 응답을 보내도록
-        // 요청해요.
-        curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING,
-                         ""); // 빈 문자열로 설정하면 curl이 지원하는 압축 방식을 모두 보냄
-
-        // 2.7. 응답 본문을 프로그램 내에서 받기 위한 콜백 함수 설정
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA,
-                         &response_buffer); // 콜백 함수에 전달할 사용자 정의
-                                            // 포인터 (응답 버퍼의 주소)
-
-        // 2.8. 자세한 로그 출력 설정 (-v)
-        // curl_easy_setopt(curl_handle, CURLOPT_VERBOSE, 1L); // 이 줄을 활성화하면
-        // curl의 자세한 디버그 출력이 stderr로 나옴
-
-        // --- curl 명령어 옵션 설정 끝 ---
-
-        // 3. 요청 실행
-        CURLcode res_perform = curl_easy_perform(curl_handle);
-
-        // 4. 결과 확인
-        if (res_perform != CURLE_OK)
-        {
-            std::cerr << "curl_easy_perform() 실패: " << curl_easy_strerror(res_perform) << std::endl;
-        }
-        else
+// --- 카메라 HTTP 핸들 풀 ---
+
+/**
+ * @brief 반납 후 보관해 둘 최대 easy 핸들 수 (동시에 더 많은 요청이 오면 임시 핸들을 만들고 반납 시 해제)
+ */
+constexpr size_t MAX_IDLE_CAMERA_HANDLES = 4;
+
+/**
+ * @brief 재사용되는 카메라 요청 핸들 (헤더 목록은 핸들이 해제될 때까지 유지되어야 함)
+ */
+struct CameraHandle
+{
+    CURL* curl;          ///< 공통 옵션이 설정된 easy 핸들
+    curl_slist* headers; ///< CURLOPT_HTTPHEADER로 설정된 공통 헤더 목록
+};
+
+/**
+ * @brief 유휴 핸들 목록과 공유 핸들 보호용 뮤텍스
+ */
+static std::mutex camera_pool_mutex;
+
+/**
+ * @brief 반납된 유휴 핸들 목록
+ */
+static std::vector<CameraHandle> idle_camera_handles;
+
+/**
+ * @brief 모든 요청 핸들이 연결 캐시, TLS 세션, DNS 캐시를 공유하는 share 핸들
+ */
+static CURLSH* camera_share = nullptr;
+
+/**
+ * @brief share 핸들의 데이터 종류별 잠금
+ */
+static std::mutex camera_share_locks[CURL_LOCK_DATA_LAST];
+
+/**
+ * @brief share 핸들 잠금 콜백
+ */
+static void camera_share_lock(CURL*, curl_lock_data data, curl_lock_access, void*)
+{
+    camera_share_locks[data].lock();
+}
+
+/**
+ * @brief share 핸들 잠금 해제 콜백
+ */
+static void camera_share_unlock(CURL*, curl_lock_data data, void*)
+{
+    camera_share_locks[data].unlock();
+}
+
+/**
+ * @brief 공통 헤더를 설정하는 함수
+ * @details Accept/Content-Type과 카메라 웹 UI와 같은 Cookie/Origin/Referer 헤더를 핸들에 설정합니다.
+ * @param curl_handle libcurl 핸들
+ * @return 설정된 헤더 리스트 포인터 (핸들을 해제한 뒤 curl_slist_free_all로 해제)
+ */
+struct curl_slist* setup_common_headers(CURL* curl_handle)
+{
+    struct curl_slist* headers = NULL;
+    headers = curl_slist_append(headers, "Accept: application/json");
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    string cookie_header = "Cookie: TRACKID=" + g_config.trackid;
+    headers = curl_slist_append(headers, cookie_header.c_str());
+    string origin_header = "Origin: https://" + g_config.host;
+    headers = curl_slist_append(headers, origin_header.c_str());
+    string referer_header = "Referer: https://" + g_config.host + "/home/setup/opensdk/html/WiseAI/index.html";
+    headers = curl_slist_append(headers, referer_header.c_str());
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
+    return headers;
+}
+
+/**
+ * @brief 요청 핸들을 해제합니다.
+ * @param handle 해제할 핸들
+ */
+static void destroy_camera_handle(CameraHandle& handle)
+{
+    curl_easy_cleanup(handle.curl);
+    curl_slist_free_all(handle.headers);
+    handle = {nullptr, nullptr};
+}
+
+/**
+ * @brief 유휴 핸들을 빌리거나, 없으면 공통 옵션을 설정한 새 핸들을 만듭니다.
+ * @details 같은 easy 핸들을 다시 쓰면 digest 인증에서 받은 nonce가 핸들에 남아 있어 다음 요청부터는 401 왕복 없이
+ *          바로 Authorization 헤더를 보냅니다. 연결은 share 핸들의 연결 캐시에 남으므로 어느 핸들로 요청해도
+ *          keep-alive 연결을 재사용하고, 새 연결이 필요할 때도 공유된 TLS 세션으로 재개(resumption)합니다.
+ * @return 빌린 핸들 (생성 실패 시 curl이 nullptr)
+ */
+static CameraHandle acquire_camera_handle()
+{
+    std::lock_guard<std::mutex> lock(camera_pool_mutex);
+    if (!idle_camera_handles.empty())
+    {
+        CameraHandle handle = idle_camera_handles.back();
+        idle_camera_handles.pop_back();
+        return handle;
+    }
+
+    if (!camera_share)
+    {
+        camera_share = curl_share_init();
+        if (camera_share)
         {
-            long http_code = 0;
-            curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE,
-                              &http_code); // HTTP 응답 코드 얻기
-
-            std::cout << "--- HTTP 응답 수신 ---" << std::endl;
-            std::cout << "HTTP Status Code: " << http_code << std::endl;
-            std::cout << "--- 응답 본문 ---" << std::endl;
-            std::cout << response_buffer << std::endl;
-            std::cout << "------------------" << std::endl;
+            curl_share_setopt(camera_share, CURLSHOPT_LOCKFUNC, camera_share_lock);
+            curl_share_setopt(camera_share, CURLSHOPT_UNLOCKFUNC, camera_share_unlock);
+            curl_share_setopt(camera_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(camera_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(camera_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
         }
+    }
 
-        // 5. 자원 해제
-        curl_easy_cleanup(curl_handle); // curl 핸들 해제
-        curl_slist_free_all(headers);   // 설정했던 헤더 목록 해제 (중요!)
+    CameraHandle handle = {curl_easy_init(), nullptr};
+    if (!handle.curl)
+    {
+        return handle;
     }
-    catch (const std::exception& e)
+    if (camera_share)
     {
-        // 예외 처리 (예: new 실패 등)
-        std::cerr << "예외 발생: " << e.what() << std::endl;
+        curl_easy_setopt(handle.curl, CURLOPT_SHARE, camera_share);
     }
-    return response_buffer;
+
+    // 인증 (digest)
+    curl_easy_setopt(handle.curl, CURLOPT_HTTPAUTH, CURLAUTH_DIGEST);
+    string auth_str = g_config.username + ":" + g_config.password;
+    curl_easy_setopt(handle.curl, CURLOPT_USERPWD, auth_str.c_str());
+
+    // HTTPS 인증서 검증 비활성화
+    curl_easy_setopt(handle.curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(handle.curl, CURLOPT_SSL_VERIFYHOST, 0L);
+
+    // 공통 헤더, 압축 지원(--compressed), 응답 본문 콜백
+    handle.headers = setup_common_headers(handle.curl);
+    curl_easy_setopt(handle.curl, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(handle.curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(handle.curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+
+    // 요청 사이에 유휴 연결이 끊기지 않도록 TCP keep-alive 사용
+    curl_easy_setopt(handle.curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    return handle;
 }
 
 /**
- * @brief 라인 크로싱 설정 정보를 PUT 요청으로 서버에 전송합니다.
- *
- * @param crossLine 전송할 라인 정보 구조체
- * @return HTTP 응답 본문 (JSON 문자열)
+ * @brief 빌린 핸들을 반납합니다. 유휴 핸들이 이미 충분하면 해제합니다.
+ * @param handle 반납할 핸들
  */
-string putLines(CrossLine crossLine)
+static void release_camera_handle(CameraHandle handle)
+{
+    std::lock_guard<std::mutex> lock(camera_pool_mutex);
+    if (idle_camera_handles.size() < MAX_IDLE_CAMERA_HANDLES)
+    {
+        idle_camera_handles.push_back(handle);
+        return;
+    }
+    destroy_camera_handle(handle);
+}
+
+/**
+ * @brief 핸들에 이번 요청의 메서드, 본문, URL, 헤더, 타임아웃, 응답 버퍼를 설정합니다.
+ * @details 재사용 핸들이므로 이전 요청의 메서드/본문 설정을 먼저 지웁니다. ETag 조건이 있으면 공통 헤더에
+ *          If-None-Match를 더한 임시 헤더 목록을 설정하며, 요청이 끝나면 finish_camera_request()로 되돌립니다.
+ * @param handle 풀에서 빌린 핸들
+ * @param request 요청 정보
+ * @param response 응답 본문/ETag를 받을 결과 객체
+ * @return 임시 헤더 목록 (없으면 nullptr)
+ */
+static curl_slist* prepare_camera_request(CameraHandle& handle, const CameraRequest& request, CameraResponse* response)
+{
+    CURL* curl_handle = handle.curl;
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPGET, 1L);
+    if (!request.body.empty())
+    {
+        curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+        curl_easy_setopt(curl_handle, CURLOPT_COPYPOSTFIELDS, request.body.c_str());
+    }
+    curl_easy_setopt(curl_handle, CURLOPT_CUSTOMREQUEST, request.method.empty() ? nullptr : request.method.c_str());
+    curl_easy_setopt(curl_handle, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT_MS, static_cast<long>(g_config.camera_request_timeout_ms));
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &response->body);
+    curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, response);
+
+    curl_slist* request_headers = nullptr;
+    if (!request.etag.empty())
+    {
+        request_headers = setup_common_headers(curl_handle);
+        string condition = "If-None-Match: " + request.etag;
+        request_headers = curl_slist_append(request_headers, condition.c_str());
+        curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, request_headers);
+    }
+    return request_headers;
+}
+
+/**
+ * @brief 요청이 끝난 핸들에서 이번 요청에만 쓰인 설정을 지웁니다.
+ * @param handle 요청을 실행한 핸들
+ * @param request_headers prepare_camera_request()가 반환한 임시 헤더 목록
+ */
+static void finish_camera_request(CameraHandle& handle, curl_slist* request_headers)
+{
+    curl_easy_setopt(handle.curl, CURLOPT_WRITEDATA, nullptr);
+    curl_easy_setopt(handle.curl, CURLOPT_HEADERDATA, nullptr);
+    if (request_headers)
+    {
+        curl_easy_setopt(handle.curl, CURLOPT_HTTPHEADER, handle.headers);
+        curl_slist_free_all(request_headers);
+    }
+}
+
+/**
+ * @brief 완료된 요청의 결과를 출력합니다.
+ * @param curl_handle 요청을 실행한 핸들
+ * @param result 요청 실행 결과
+ * @param response_buffer 응답 본문
+ * @return HTTP 응답 코드 (요청 실패 시 0)
+ */
+static long log_camera_response(CURL* curl_handle, CURLcode result, const string& response_buffer)
+{
+    if (result != CURLE_OK)
+    {
+        std::cerr << "curl_easy_perform() 실패: " << curl_easy_strerror(result) << std::endl;
+        return 0;
+    }
+
+    long http_code = 0;
+    long new_connects = 0;
+    curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &http_code);
+    curl_easy_getinfo(curl_handle, CURLINFO_NUM_CONNECTS, &new_connects);
+
+    std::cout << "--- HTTP 응답 수신 ---" << std::endl;
+    std::cout << "HTTP Status Code: " << http_code << " (새 연결 " << new_connects << "개)" << std::endl;
+    std::cout << "--- 응답 본문 ---" << std::endl;
+    std::cout << response_buffer << std::endl;
+    std::cout << "------------------" << std::endl;
+    return http_code;
+}
+
+/**
+ * @brief 풀의 핸들로 카메라에 HTTP 요청을 하나 보내고 결과를 반환합니다.
+ * @param request 요청 정보
+ * @return 요청 결과
+ */
+static CameraResponse perform_camera_request(const CameraRequest& request)
 {
-    string response_buffer;
-    try
+    CameraResponse response{CURLE_FAILED_INIT, 0, "", ""};
+    CameraHandle handle = acquire_camera_handle();
+    if (!handle.curl)
+    {
+        std::cerr << "curl_easy_init() 실패" << std::endl;
+        return response;
+    }
+
+    curl_slist* request_headers = prepare_camera_request(handle, request, &response);
+    response.result = curl_easy_perform(handle.curl);
+    response.http_code = log_camera_response(handle.curl, response.result, response.body);
+
+    finish_camera_request(handle, request_headers);
+    release_camera_handle(handle);
+    return response;
+}
+
+/**
+ * @brief 여러 카메라 요청을 curl multi 인터페이스로 동시에 실행하고 결과를 모읍니다.
+ * @details 요청마다 풀에서 핸들을 하나씩 빌려 하나의 multi 핸들에 넣고, 모두 끝날 때까지 curl_multi_poll로
+ *          기다립니다. 카메라에 동시에 여는 연결 수는 camera.max_parallel_requests로 제한하며(초과분은 multi 핸들
+ *          안에서 대기), 각 요청에는 camera.request_timeout_ms가 개별 적용됩니다.
+ * @param requests 실행할 요청 목록
+ * @return 요청과 같은 순서의 결과 목록
+ */
+vector<CameraResponse> perform_camera_requests(const vector<CameraRequest>& requests)
+{
+    vector<CameraResponse> responses(requests.size(), CameraResponse{CURLE_FAILED_INIT, 0, "", ""});
+    if (requests.empty())
+    {
+        return responses;
+    }
+
+    CURLM* multi_handle = curl_multi_init();
+    if (!multi_handle)
     {
-        CURL* curl_handle; // curl 통신을 위한 핸들
+        std::cerr << "curl_multi_init() 실패" << std::endl;
+        return responses;
+    }
+    curl_multi_setopt(multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS,
+                      static_cast<long>(g_config.camera_max_parallel_requests));
 
-        // 2. curl_easy 핸들 생성
-        // 각 통신 요청마다 이 핸들을 생성하고 설정해요.
-        curl_handle = curl_easy_init();
-        if (!curl_handle)
+    vector<CameraHandle> handles(requests.size(), CameraHandle{nullptr, nullptr});
+    vector<curl_slist*> request_headers(requests.size(), nullptr);
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        handles[i] = acquire_camera_handle();
+        if (!handles[i].curl)
         {
             std::cerr << "curl_easy_init() 실패" << std::endl;
-            curl_global_cleanup();
-            return NULL;
+            continue;
         }
-        // --- curl 명령어 옵션 설정 시작 ---
-        // 2.1. URL 설정
-        string url = "https://" + g_config.host + "/opensdk/WiseAI/configuration/linecrossing";
-        curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-
-        // 2.2. HTTP 메서드 설정
-        curl_easy_setopt(curl_handle, CURLOPT_CUSTOMREQUEST, "PUT");
-
-        // 2.3. 인증 설정
-        curl_easy_setopt(curl_handle, CURLOPT_HTTPAUTH, CURLAUTH_DIGEST);
-        string auth_str = g_config.username + ":" + g_config.password;
-        curl_easy_setopt(curl_handle, CURLOPT_USERPWD, auth_str.c_str());
-
-        // 2.4. HTTPS 인증서 검증 비활성화
-        curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYHOST, 0L);
-
-        // 2.5. 커스텀 헤더 설정
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, "Accept: application/json");
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        string cookie_header = "Cookie: TRACKID=" + g_config.trackid;
-        headers = curl_slist_append(headers, cookie_header.c_str());
-        string origin_header = "Origin: https://" + g_config.host;
-        headers = curl_slist_append(headers, origin_header.c_str());
-        string referer_header = "Referer: https://" + g_config.host + "/home/setup/opensdk/html/WiseAI/index.html";
-        headers = curl_slist_append(headers, referer_header.c_str());
-        curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
-
-        json curlRoot;
-        curlRoot["channel"] = 0;
-        curlRoot["enable"] = true;
-        json lineArray = json::array();
-        json line1;
-        line1["index"] = crossLine.index;
-
-        json coodArray = json::array();
-        json cood1;
-        cood1["x"] = crossLine.x1;
-        cood1["y"] = crossLine.y1;
-        coodArray.push_back(cood1);
-        json cood2;
-        cood2["x"] = crossLine.x2;
-        cood2["y"] = crossLine.y2;
-        coodArray.push_back(cood2);
-
-        line1["lineCoordinates"] = coodArray;
-        line1["mode"] = crossLine.mode;
-        line1["name"] = crossLine.name;
-        json otfArray = json::array();
-        otfArray.push_back("Person");
-        otfArray.push_back("Vehicle.Bicycle");
-        otfArray.push_back("Vehicle.Car");
-        otfArray.push_back("Vehicle.Motorcycle");
-        otfArray.push_back("Vehicle.Bus");
-        otfArray.push_back("Vehicle.Truck");
-        line1["objectTypeFilter"] = otfArray;
-        // ["Person","Vehicle.Bicycle","Vehicle.Car","Vehicle.Motorcycle","Vehicle.Bus","Vehicle.Truck"]
-        lineArray.push_back(line1);
-
-        curlRoot["line"] = lineArray;
-
-        string insert_json_string = curlRoot.dump();
-        cout << "--- HTTP Payload 원문 ---\n" << insert_json_string << "\n";
-
-        curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS,
-                         insert_json_string.c_str()); // 데이터 포인터
-        curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE,
-                         insert_json_string.length()); // 데이터 길이
-
-        // Note: SSL 및 헤더 설정은 이미 setup_common_headers에서 처리됨
-
-        // 2.6. 압축 지원 (--compressed)
-        // Accept-Encoding 헤더를 자동으로 추가하여 서버가 압축된 응답을 보내도록
-        // 요청해요.
-        curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING,
-                         ""); // 빈 문자열로 설정하면 curl이 지원하는 압축 방식을 모두 보냄
-
-        // 2.7. 응답 본문을 프로그램 내에서 받기 위한 콜백 함수 설정
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA,
-                         &response_buffer); // 콜백 함수에 전달할 사용자 정의
-                                            // 포인터 (응답 버퍼의 주소)
-
-        // --- curl 명령어 옵션 설정 끝 ---
-
-        // 3. 요청 실행
-        CURLcode res_perform = curl_easy_perform(curl_handle);
-
-        // 4. 결과 확인
-        if (res_perform != CURLE_OK)
+        request_headers[i] = prepare_camera_request(handles[i], requests[i], &responses[i]);
+        curl_easy_setopt(handles[i].curl, CURLOPT_PRIVATE, reinterpret_cast<void*>(i));
+        curl_multi_add_handle(multi_handle, handles[i].curl);
+    }
+
+    int still_running = 0;
+    do
+    {
+        CURLMcode res_multi = curl_multi_perform(multi_handle, &still_running);
+        if (res_multi == CURLM_OK && still_running > 0)
         {
-            std::cerr << "curl_easy_perform() 실패: " << curl_easy_strerror(res_perform) << std::endl;
+            res_multi = curl_multi_poll(multi_handle, nullptr, 0, 1000, nullptr);
         }
-        else
+        if (res_multi != CURLM_OK)
         {
-            long http_code = 0;
-            curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE,
-                              &http_code); // HTTP 응답 코드 얻기
-
-            std::cout << "--- HTTP 응답 수신 ---" << std::endl;
-            std::cout << "HTTP Status Code: " << http_code << std::endl;
-            std::cout << "--- 응답 본문 ---" << std::endl;
-            std::cout << response_buffer << std::endl;
-            std::cout << "------------------" << std::endl;
+            std::cerr << "curl_multi_perform() 실패: " << curl_multi_strerror(res_multi) << std::endl;
+            break;
         }
+    } while (still_running > 0);
 
-        // 5. 자원 해제
-        curl_easy_cleanup(curl_handle); // curl 핸들 해제
-        curl_slist_free_all(headers);   // 설정했던 헤더 목록 해제 (중요!)
+    int messages_left = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_handle, &messages_left))
+    {
+        if (message->msg != CURLMSG_DONE)
+        {
+            continue;
+        }
+        void* index_ptr = nullptr;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &index_ptr);
+        CameraResponse& response = responses[reinterpret_cast<size_t>(index_ptr)];
+        response.result = message->data.result;
+        response.http_code = log_camera_response(message->easy_handle, response.result, response.body);
     }
-    catch (const std::exception& e)
+
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        if (!handles[i].curl)
+        {
+            continue;
+        }
+        curl_multi_remove_handle(multi_handle, handles[i].curl);
+        finish_camera_request(handles[i], request_headers[i]);
+        release_camera_handle(handles[i]);
+    }
+    curl_multi_cleanup(multi_handle);
+    return responses;
+}
+
+/**
+ * @brief 카메라 HTTP 핸들 풀과 share 핸들을 해제합니다.
+ */
+void cleanup_camera_http()
+{
+    std::lock_guard<std::mutex> lock(camera_pool_mutex);
+    for (auto& handle : idle_camera_handles)
+    {
+        destroy_camera_handle(handle);
+    }
+    idle_camera_handles.clear();
+    if (camera_share)
+    {
+        curl_share_cleanup(camera_share);
+        camera_share = nullptr;
+    }
+}
+
+// --- 카메라 라인 크로싱 API ---
+
+/**
+ * @brief 라인 크로싱 설정 URL을 만듭니다.
+ * @return 요청 URL
+ */
+static string line_crossing_url()
+{
+    return "https://" + g_config.host + "/opensdk/WiseAI/configuration/linecrossing";
+}
+
+/**
+ * @brief 라인 하나를 삭제하는 요청 URL을 만듭니다.
+ * @param index 삭제할 라인 인덱스
+ * @return 요청 URL
+ */
+static string line_delete_url(int index)
+{
+    return "https://" + g_config.host + "/opensdk/WiseAI/configuration/linecrossing/line?channel=0&index=" +
+           to_string(index);
+}
+
+/**
+ * @brief 라인 크로싱 설정 정보를 GET 요청으로 받아옵니다.
+ *
+ * @return HTTP 응답 본문 (JSON 문자열)
+ */
+string getLines()
+{
+    return perform_camera_request({line_crossing_url(), "", "", ""}).body;
+}
+
+/**
+ * @brief 라인 크로싱 설정 정보를 조건부 GET 요청으로 받아옵니다.
+ *
+ * @param etag 이전 응답의 ETag (빈 문자열이면 조건 없이 요청)
+ * @return 요청 결과 (내용이 바뀌지 않았으면 http_code 304, 본문 없음)
+ */
+CameraResponse getLines(const string& etag)
+{
+    return perform_camera_request({line_crossing_url(), "", "", etag});
+}
+
+/**
+ * @brief 감지선 하나를 카메라 linecrossing "line" 배열 항목으로 변환합니다.
+ * @param crossLine 변환할 라인 정보 구조체
+ * @return "line" 배열 항목 JSON
+ */
+static json line_to_camera_json(const CrossLine& crossLine)
+{
+    json line1;
+    line1["index"] = crossLine.index;
+
+    json coodArray = json::array();
+    json cood1;
+    cood1["x"] = crossLine.x1;
+    cood1["y"] = crossLine.y1;
+    coodArray.push_back(cood1);
+    json cood2;
+    cood2["x"] = crossLine.x2;
+    cood2["y"] = crossLine.y2;
+    coodArray.push_back(cood2);
+
+    line1["lineCoordinates"] = coodArray;
+    line1["mode"] = crossLine.mode;
+    line1["name"] = crossLine.name;
+    json otfArray = json::array();
+    otfArray.push_back("Person");
+    otfArray.push_back("Vehicle.Bicycle");
+    otfArray.push_back("Vehicle.Car");
+    otfArray.push_back("Vehicle.Motorcycle");
+    otfArray.push_back("Vehicle.Bus");
+    otfArray.push_back("Vehicle.Truck");
+    line1["objectTypeFilter"] = otfArray;
+    // ["Person","Vehicle.Bicycle","Vehicle.Car","Vehicle.Motorcycle","Vehicle.Bus","Vehicle.Truck"]
+    return line1;
+}
+
+/**
+ * @brief 라인 크로싱 설정 정보를 PUT 요청으로 서버에 전송합니다.
+ *
+ * @param crossLine 전송할 라인 정보 구조체
+ * @return HTTP 응답 본문 (JSON 문자열)
+ */
+string putLines(CrossLine crossLine)
+{
+    return putLines(vector<CrossLine>{crossLine}).body;
+}
+
+/**
+ * @brief 여러 라인 크로싱 설정을 하나의 PUT 요청으로 서버에 전송합니다.
+ *
+ * @param crossLines 전송할 라인 정보 목록 ("line" 배열에 모두 담아 한 번에 전송)
+ * @return 요청 결과 (전송 결과, HTTP 응답 코드, 응답 본문)
+ */
+CameraResponse putLines(const vector<CrossLine>& crossLines)
+{
+    json curlRoot;
+    curlRoot["channel"] = 0;
+    curlRoot["enable"] = true;
+    json lineArray = json::array();
+    for (const auto& crossLine : crossLines)
     {
-        // 예외 처리 (예: new 실패 등)
-        std::cerr << "예외 발생: " << e.what() << std::endl;
+        lineArray.push_back(line_to_camera_json(crossLine));
     }
+    curlRoot["line"] = lineArray;
+
+    string insert_json_string = curlRoot.dump();
+    cout << "--- HTTP Payload 원문 ---\n" << insert_json_string << "\n";
 
-    return response_buffer;
+    return perform_camera_request({line_crossing_url(), "PUT", insert_json_string, ""});
 }
 
 /**
@@ -276,94 +539,22 @@ string putLines(CrossLine crossLine)
  */
 string deleteLines(int index)
 {
-    string response_buffer;
-    try
-    {
-        CURL* curl_handle; // curl 통신을 위한 핸들
-
-        // 2. curl_easy 핸들 생성
-        // 각 통신 요청마다 이 핸들을 생성하고 설정해요.
-        curl_handle = curl_easy_init();
-        if (!curl_handle)
-        {
-            std::cerr << "curl_easy_init() 실패" << std::endl;
-            curl_global_cleanup();
-            return NULL;
-        }
-        // --- curl 명령어 옵션 설정 시작 ---
-        // 2.1. URL 설정
-        string deleteUrl = "https://" + g_config.host +
-                           "/opensdk/WiseAI/configuration/linecrossing/line?channel=0&index=" + to_string(index);
-        curl_easy_setopt(curl_handle, CURLOPT_URL, deleteUrl.c_str());
-
-        // 2.2. HTTP 메서드 설정
-        curl_easy_setopt(curl_handle, CURLOPT_CUSTOMREQUEST, "DELETE");
-
-        // 2.3. 인증 설정
-        curl_easy_setopt(curl_handle, CURLOPT_HTTPAUTH, CURLAUTH_DIGEST);
-        string auth_str = g_config.username + ":" + g_config.password;
-        curl_easy_setopt(curl_handle, CURLOPT_USERPWD, auth_str.c_str());
-
-        // 2.4. HTTPS 인증서 검증 비활성화
-        curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYHOST, 0L);
-
-        // 2.5. 커스텀 헤더 설정
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, "Accept: application/json");
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        string cookie_header = "Cookie: TRACKID=" + g_config.trackid;
-        headers = curl_slist_append(headers, cookie_header.c_str());
-        string origin_header = "Origin: https://" + g_config.host;
-        headers = curl_slist_append(headers, origin_header.c_str());
-        string referer_header = "Referer: https://" + g_config.host + "/home/setup/opensdk/html/WiseAI/index.html";
-        headers = curl_slist_append(headers, referer_header.c_str());
-        curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
-
-        // 2.6. 압축 지원 (--compressed)
-        // Accept-Encoding 헤더를 자동으로 추가하여 서버가 압축된 응답을 보내도록
-        // 요청해요.
-        curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING,
-                         ""); // 빈 문자열로 설정하면 curl이 지원하는 압축 방식을 모두 보냄
-
-        // 2.7. 응답 본문을 프로그램 내에서 받기 위한 콜백 함수 설정
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA,
-                         &response_buffer); // 콜백 함수에 전달할 사용자 정의
-                                            // 포인터 (응답 버퍼의 주소)
-
-        // --- curl 명령어 옵션 설정 끝 ---
-
-        // 3. 요청 실행
-        CURLcode res_perform = curl_easy_perform(curl_handle);
-
-        // 4. 결과 확인
-        if (res_perform != CURLE_OK)
-        {
-            std::cerr << "curl_easy_perform() 실패: " << curl_easy_strerror(res_perform) << std::endl;
-        }
-        else
-        {
-            long http_code = 0;
-            curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE,
-                              &http_code); // HTTP 응답 코드 얻기
-
-            std::cout << "--- HTTP 응답 수신 ---" << std::endl;
-            std::cout << "HTTP Status Code: " << http_code << std::endl;
-            std::cout << "--- 응답 본문 ---" << std::endl;
-            std::cout << response_buffer << std::endl;
-            std::cout << "------------------" << std::endl;
-        }
+    return perform_camera_request({line_delete_url(index), "DELETE", "", ""}).body;
+}
 
-        // 5. 자원 해제
-        curl_easy_cleanup(curl_handle); // curl 핸들 해제
-        curl_slist_free_all(headers);   // 설정했던 헤더 목록 해제 (중요!)
-    }
-    catch (const std::exception& e)
+/**
+ * @brief 여러 인덱스의 라인 크로싱 설정을 DELETE 요청으로 동시에 삭제합니다.
+ *
+ * @param indexes 삭제할 라인 인덱스 목록
+ * @return 인덱스와 같은 순서의 요청 결과 목록
+ */
+vector<CameraResponse> deleteLines(const vector<int>& indexes)
+{
+    vector<CameraRequest> requests;
+    requests.reserve(indexes.size());
+    for (int index : indexes)
     {
-        // 예외 처리 (예: new 실패 등)
-        std::cerr << "예외 발생: " << e.what() << std::endl;
+        requests.push_back({line_delete_url(index), "DELETE", "", ""});
     }
-
-    return response_buffer;
+    return perform_camera_requests(requests);
 }
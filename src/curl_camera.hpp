@@ -15,6 +15,7 @@
 #include <curl/curl.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 using std::cerr;
@@ -22,6 +23,29 @@ using std::cout;
 using std::endl;
 using std::string;
 using std::to_string;
+using std::vector;
+
+/**
+ * @brief 동시 실행할 카메라 HTTP 요청 하나
+ */
+struct CameraRequest
+{
+    string url;    ///< 요청 URL
+    string method; ///< HTTP 메서드 (빈 문자열이면 GET)
+    string body;   ///< 요청 본문 (빈 문자열이면 본문 없음)
+    string etag;   ///< If-None-Match로 보낼 ETag (빈 문자열이면 조건 없음)
+};
+
+/**
+ * @brief 카메라 HTTP 요청 하나의 결과
+ */
+struct CameraResponse
+{
+    CURLcode result; ///< 전송 결과 (타임아웃이면 CURLE_OPERATION_TIMEDOUT)
+    long http_code;  ///< HTTP 응답 코드 (전송 실패 시 0)
+    string body;     ///< 응답 본문
+    string etag;     ///< 응답의 ETag 헤더 값 (없으면 빈 문자열)
+};
 
 // --- 공통 설정 함수 ---
 /**
@@ -32,6 +56,21 @@ using std::to_string;
  */
 struct curl_slist* setup_common_headers(CURL* curl_handle);
 
+/**
+ * @brief 카메라 HTTP 핸들 풀과 share 핸들을 해제합니다.
+ * @details getLines/putLines/deleteLines는 easy 핸들을 재사용하고 연결 캐시와 TLS 세션을 공유하므로,
+ *          curl_global_cleanup() 전에 호출해야 합니다.
+ */
+void cleanup_camera_http();
+
+/**
+ * @brief 여러 카메라 요청을 curl multi 인터페이스로 동시에 실행하고 결과를 모읍니다.
+ * @details 전체 소요 시간은 요청 수와 관계없이 가장 느린 요청 하나(왕복 1회)에 가깝습니다.
+ * @param requests 실행할 요청 목록
+ * @return 요청과 같은 순서의 결과 목록
+ */
+vector<CameraResponse> perform_camera_requests(const vector<CameraRequest>& requests);
+
 /**
  * @brief libcurl의 응답 데이터를 저장하는 콜백 함수
  *
@@ -50,6 +89,13 @@ size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
  */
 string getLines();
 
+/**
+ * @brief 라인 크로싱 설정 정보를 조건부 GET 요청으로 받아옵니다.
+ * @param etag 이전 응답의 ETag (빈 문자열이면 조건 없이 요청)
+ * @return 요청 결과 (내용이 바뀌지 않았으면 http_code 304, 본문 없음)
+ */
+CameraResponse getLines(const string& etag);
+
 /**
  * @brief 라인 크로싱 설정 정보를 PUT 요청으로 서버에 전송합니다.
  * @param crossLine 전송할 라인 정보 구조체
@@ -57,9 +103,23 @@ string getLines();
  */
 string putLines(CrossLine crossLine);
 
+/**
+ * @brief 여러 라인 크로싱 설정을 하나의 PUT 요청으로 서버에 전송합니다.
+ * @param crossLines 전송할 라인 정보 목록 ("line" 배열에 모두 담아 한 번에 전송)
+ * @return 요청 결과 (전송 결과, HTTP 응답 코드, 응답 본문)
+ */
+CameraResponse putLines(const vector<CrossLine>& crossLines);
+
 /**
  * @brief 지정한 인덱스의 라인 크로싱 설정을 DELETE 요청으로 삭제합니다.
  * @param index 삭제할 라인 인덱스
  * @return HTTP 응답 본문 (JSON 문자열)
  */
 string deleteLines(int index);
+
+/**
+ * @brief 여러 인덱스의 라인 크로싱 설정을 DELETE 요청으로 동시에 삭제합니다.
+ * @param indexes 삭제할 라인 인덱스 목록
+ * @return 인덱스와 같은 순서의 요청 결과 목록
+ */
+vector<CameraResponse> deleteLines(const vector<int>& indexes);
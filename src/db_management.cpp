@@ -1,34 +1,27 @@
 /**
  * @file db_management.cpp
  * @brief 데이터베이스 관리 구현 파일
- * @details 이 파일은 SQLite 데이터베이스와 상호작용하는 함수들을 구현합니다. 테이블 생성, 데이터 삽입, 조회, 삭제 등의
- * 기능을 제공합니다.
+ * @details 이 파일은 SQLite 데이터베이스와 상호작용하는 함수들을 구현합니다. 데이터 삽입, 조회, 삭제 등의 기능을
+ * 제공하며, 테이블 생성과 스키마 변경은 db_schema의 마이그레이션이 담당합니다.
  */
 
 // g++ -o db_management db_management.cpp -l SQLiteCpp -l sqlite3 -std=c++17
 #include "db_management.hpp"
+#include "db_statement_cache.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <sqlite3.h>
 
 ///////////////////////////////////////////////
 // Detections 테이블
 
-/**
- * @brief Detections 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_detections(SQLite::Database& db)
-{
-    db.exec("CREATE TABLE IF NOT EXISTS detections ("
-            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-            "image BLOB, "
-            "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP NOT NULL)");
-    cout << "'detections' 테이블이 준비되었습니다.\n";
-    return;
-}
-
 /**
  * @brief Detections 테이블에 데이터를 삽입합니다.
  * @details 이 함수는 Detections 테이블에 새로운 데이터를 추가합니다. SQL 인젝션 방지를 위해 Prepared Statement를
- * 사용합니다.
+ * 사용합니다. timestamp_ms가 비어 있으면 timestamp 문자열에서 변환하여 저장하고, 변환할 수 없으면 저장 시각을 기록합니다.
  * @param db SQLite 데이터베이스 참조
  * @param detection 삽입할 Detection 구조체
  * @return 성공 시 true, 실패 시 false
@@ -37,12 +30,41 @@ bool insert_data_detections(SQLite::Database& db, Detection detection)
 {
     try
     {
+        long long timestamp_ms = detection.timestamp_ms;
+        if (timestamp_ms == 0 && !parse_timestamp_ms(detection.timestamp, timestamp_ms))
+        {
+            // 0으로 저장하면 보존 기간 정리에서 바로 삭제되므로 저장 시각으로 대신 기록
+            timestamp_ms = chrono::duration_cast<chrono::milliseconds>(
+                               chrono::system_clock::now().time_since_epoch())
+                               .count();
+            cerr << "[DB] 타임스탬프 형식 오류, 저장 시각으로 기록: " << detection.timestamp << endl;
+        }
+
         // SQL 인젝션 방지를 위해 Prepared Statement 사용
-        SQLite::Statement query(db, "INSERT INTO detections (image, timestamp) VALUES (?, ?)");
-        query.bind(1, detection.imageBlob.data(), detection.imageBlob.size());
-        query.bind(2, detection.timestamp);
-        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
-        query.exec();
+        CachedStatement query(db, "INSERT INTO detections (image, timestamp, ts_ms, human_id, rule_name, vehicle_id, "
+                                  "board_id, similarity) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+        query->bind(1, detection.imageBlob.data(), detection.imageBlob.size());
+        query->bind(2, detection.timestamp);
+        query->bind(3, static_cast<int64_t>(timestamp_ms));
+        // 이벤트 메타데이터가 없는 감지(-1, 빈 문자열)는 NULL로 저장
+        if (detection.rule_name.empty())
+        {
+            query->bind(4);
+            query->bind(5);
+            query->bind(6);
+            query->bind(7);
+            query->bind(8);
+        }
+        else
+        {
+            query->bind(4, detection.human_id);
+            query->bind(5, detection.rule_name);
+            query->bind(6, detection.vehicle_id);
+            query->bind(7, detection.board_id);
+            query->bind(8, detection.similarity);
+        }
+        log_sql("insert", *query);
+        query->exec();
 
         cout << "데이터 추가: (시간: " << detection.timestamp << ")" << endl;
     }
@@ -56,33 +78,36 @@ bool insert_data_detections(SQLite::Database& db, Detection detection)
 }
 
 /**
- * @brief 주어진 시간 범위 내의 Detection 데이터를 조회합니다.
+ * @brief 주어진 시간 범위 내의 Detection 데이터(이미지 포함)를 조회합니다.
+ * @details ts_ms 인덱스로 범위 검색 및 정렬을 수행하며, 필요한 컬럼만 조회합니다.
+ *          응답용 timestamp 문자열은 BLOB 뒤에 저장된 timestamp 컬럼 대신 ts_ms에서 생성합니다.
  * @param db SQLite 데이터베이스 참조
- * @param startTimestamp 시작 타임스탬프
- * @param endTimestamp 종료 타임스탬프
+ * @param startMs 시작 시각 (epoch 밀리초, 포함)
+ * @param endMs 종료 시각 (epoch 밀리초, 포함)
  * @return Detection 벡터
  */
-vector<Detection> select_data_for_timestamp_range_detections(SQLite::Database& db, string startTimestamp,
-                                                             string endTimestamp)
+vector<Detection> select_data_for_timestamp_range_detections(SQLite::Database& db, long long startMs, long long endMs)
 {
     vector<Detection> detections;
     try
     {
-        SQLite::Statement query(db, "SELECT * FROM detections WHERE timestamp BETWEEN "
-                                    "? AND ? ORDER BY timestamp");
-        query.bind(1, startTimestamp);
-        query.bind(2, endTimestamp);
-        cout << "Prepared SQL for select data vector: " << query.getExpandedSQL() << endl;
-        while (query.executeStep())
+        CachedStatement query(db, "SELECT id, ts_ms, image FROM detections WHERE ts_ms BETWEEN "
+                                  "? AND ? ORDER BY ts_ms");
+        query->bind(1, static_cast<int64_t>(startMs));
+        query->bind(2, static_cast<int64_t>(endMs));
+        log_sql("select data vector", *query);
+        while (query->executeStep())
         {
-            const unsigned char* ucharBlobData = static_cast<const unsigned char*>(query.getColumn("image").getBlob());
-            int blobSize = query.getColumn("image").getBytes();
-            vector<unsigned char> image(ucharBlobData, ucharBlobData + blobSize);
+            Detection detection;
+            detection.id = query->getColumn(0).getInt();
+            detection.timestamp_ms = query->getColumn(1).getInt64();
+            detection.timestamp = format_kst_timestamp(detection.timestamp_ms);
 
-            string timestamp = query.getColumn("timestamp");
+            const unsigned char* ucharBlobData = static_cast<const unsigned char*>(query->getColumn(2).getBlob());
+            int blobSize = query->getColumn(2).getBytes();
+            detection.imageBlob.assign(ucharBlobData, ucharBlobData + blobSize);
 
-            Detection detection = {image, timestamp};
-            detections.push_back(detection);
+            detections.push_back(std::move(detection));
         }
     }
     catch (const exception& e)
@@ -93,47 +118,265 @@ vector<Detection> select_data_for_timestamp_range_detections(SQLite::Database& d
 }
 
 /**
- * @brief Detections 테이블의 모든 데이터를 삭제합니다.
+ * @brief 주어진 시간 범위 내의 Detection 목록(id, 시각)만 조회합니다.
+ * @details idx_detections_ts_event 인덱스에 ts_ms와 rowid(id)가 모두 들어 있으므로 테이블 본문과
+ *          이미지 BLOB 페이지를 읽지 않고 인덱스만으로 응답합니다.
  * @param db SQLite 데이터베이스 참조
+ * @param startMs 시작 시각 (epoch 밀리초, 포함)
+ * @param endMs 종료 시각 (epoch 밀리초, 포함)
+ * @return imageBlob이 비어 있는 Detection 벡터
  */
-void delete_all_data_detections(SQLite::Database& db)
+vector<Detection> select_list_for_timestamp_range_detections(SQLite::Database& db, long long startMs, long long endMs)
 {
+    vector<Detection> detections;
     try
     {
-        SQLite::Statement query(db, "DELETE FROM detections");
-        cout << "Prepared SQL for delete all: " << query.getExpandedSQL() << endl;
-        int changes = query.exec();
-        cout << "테이블의 모든 데이터를 삭제했습니다. 삭제된 행 수: " << changes << endl;
+        CachedStatement query(db, "SELECT id, ts_ms FROM detections WHERE ts_ms BETWEEN ? AND ? ORDER BY ts_ms");
+        query->bind(1, static_cast<int64_t>(startMs));
+        query->bind(2, static_cast<int64_t>(endMs));
+        log_sql("select list", *query);
+        while (query->executeStep())
+        {
+            Detection detection;
+            detection.id = query->getColumn(0).getInt();
+            detection.timestamp_ms = query->getColumn(1).getInt64();
+            detection.timestamp = format_kst_timestamp(detection.timestamp_ms);
+            detections.push_back(std::move(detection));
+        }
     }
     catch (const exception& e)
     {
-        cerr << "테이블 전체 삭제 실패: " << e.what() << endl;
+        cerr << "사용자 조회 실패: " << e.what() << endl;
     }
-    return;
+    return detections;
 }
 
-///////////////////////////////////////////////
-// Lines 테이블
+/**
+ * @brief DetectionFilter 조건을 WHERE 절 문자열로 변환합니다.
+ * @details 조건이 있는 항목만 포함하며, 모든 조건은 idx_detections_ts_event 커버링 인덱스 안에서 걸러집니다.
+ *          바인딩 순서는 bind_detection_filter()와 같습니다.
+ * @param filter 조회 조건
+ * @return "WHERE ..." 문자열
+ */
+static string detection_filter_where(const DetectionFilter& filter)
+{
+    string where = "WHERE ts_ms BETWEEN ? AND ?";
+    if (!filter.rule_name.empty())
+        where += " AND rule_name = ?";
+    if (filter.board_id >= 0)
+        where += " AND board_id = ?";
+    return where;
+}
+
+/**
+ * @brief detection_filter_where()로 만든 WHERE 절의 파라미터를 바인딩합니다.
+ * @param query 준비된 SQL 문
+ * @param filter 조회 조건
+ * @param index 첫 번째 파라미터 번호
+ * @return 다음 파라미터 번호
+ */
+static int bind_detection_filter(SQLite::Statement& query, const DetectionFilter& filter, int index)
+{
+    query.bind(index++, static_cast<int64_t>(filter.start_ms));
+    query.bind(index++, static_cast<int64_t>(filter.end_ms));
+    if (!filter.rule_name.empty())
+        query.bind(index++, filter.rule_name);
+    if (filter.board_id >= 0)
+        query.bind(index++, filter.board_id);
+    return index;
+}
+
+/**
+ * @brief 조건에 맞는 감지 이벤트 목록(메타데이터만, 이미지 제외)을 조회합니다.
+ * @details 시각 기준 커버링 인덱스(idx_detections_ts_event)만으로 응답하므로 이미지 BLOB 페이지를 읽지 않습니다.
+ *          메타데이터가 기록되기 전의 행은 NULL이므로 기본값(-1, 빈 문자열, 0)으로 채웁니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param filter 조회 조건
+ * @return imageBlob이 비어 있는 Detection 벡터 (시각 순)
+ */
+vector<Detection> select_events_detections(SQLite::Database& db, const DetectionFilter& filter)
+{
+    vector<Detection> detections;
+    try
+    {
+        string sql = "SELECT id, ts_ms, human_id, rule_name, vehicle_id, board_id, similarity FROM detections " +
+                     detection_filter_where(filter) + " ORDER BY ts_ms";
+        if (filter.limit > 0)
+            sql += " LIMIT ?";
+
+        CachedStatement query(db, sql);
+        int next = bind_detection_filter(*query, filter, 1);
+        if (filter.limit > 0)
+            query->bind(next, filter.limit);
+        log_sql("select events", *query);
+
+        while (query->executeStep())
+        {
+            Detection detection;
+            detection.id = query->getColumn(0).getInt();
+            detection.timestamp_ms = query->getColumn(1).getInt64();
+            detection.timestamp = format_kst_timestamp(detection.timestamp_ms);
+            if (!query->getColumn(3).isNull())
+            {
+                detection.human_id = query->getColumn(2).getInt();
+                detection.rule_name = query->getColumn(3).getString();
+                detection.vehicle_id = query->getColumn(4).getInt();
+                detection.board_id = query->getColumn(5).getInt();
+                detection.similarity = query->getColumn(6).getDouble();
+            }
+            detections.push_back(std::move(detection));
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "감지 이벤트 조회 실패: " << e.what() << endl;
+    }
+    return detections;
+}
+
+/**
+ * @brief 조건에 맞는 감지 건수를 시간 구간별로 집계합니다.
+ * @details 구간 계산과 집계 모두 커버링 인덱스 안에서 수행되며, 결과 행 수는 구간 수만큼만 생성됩니다.
+ *          구간 경계는 집계 테이블 조회(select_detection_rollups)와 같이 KST 기준으로 맞춥니다. (일 단위 구간은 KST 자정)
+ * @param db SQLite 데이터베이스 참조
+ * @param filter 조회 조건 (limit은 무시)
+ * @param bucket_ms 구간 길이 (밀리초, 0 이하이면 전체를 하나의 구간으로 집계)
+ * @return DetectionBucket 벡터 (구간 시작 시각 순, 건수가 0인 구간은 제외)
+ */
+vector<DetectionBucket> count_detections_by_bucket(SQLite::Database& db, const DetectionFilter& filter,
+                                                   long long bucket_ms)
+{
+    const long long KST_OFFSET_MS = 9 * 3600000LL;
+
+    vector<DetectionBucket> buckets;
+    try
+    {
+        if (bucket_ms <= 0)
+        {
+            CachedStatement query(db, "SELECT count(*) FROM detections " + detection_filter_where(filter));
+            bind_detection_filter(*query, filter, 1);
+            if (query->executeStep())
+            {
+                buckets.push_back({filter.start_ms, query->getColumn(0).getInt()});
+            }
+            return buckets;
+        }
+
+        CachedStatement query(db, "SELECT ((ts_ms + ?) / ?) * ? - ? AS bucket, count(*) FROM detections " +
+                                      detection_filter_where(filter) + " GROUP BY bucket ORDER BY bucket");
+        query->bind(1, static_cast<int64_t>(KST_OFFSET_MS));
+        query->bind(2, static_cast<int64_t>(bucket_ms));
+        query->bind(3, static_cast<int64_t>(bucket_ms));
+        query->bind(4, static_cast<int64_t>(KST_OFFSET_MS));
+        bind_detection_filter(*query, filter, 5);
+        log_sql("count buckets", *query);
+
+        while (query->executeStep())
+        {
+            buckets.push_back({query->getColumn(0).getInt64(), query->getColumn(1).getInt()});
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "감지 건수 집계 실패: " << e.what() << endl;
+    }
+    return buckets;
+}
+
+/**
+ * @brief 집계 테이블에서 시간 구간별 감지 건수를 조회합니다.
+ * @details 1시간 단위로 미리 집계된 detection_rollup_hourly만 읽으므로 감지 이력 크기와 무관하게 빠르게 응답합니다.
+ *          구간 경계는 1시간 단위로 맞춰지며, 일 단위 구간은 KST 자정 기준입니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param filter 조회 조건 (limit은 무시)
+ * @param bucket_ms 구간 길이 (밀리초, 1시간의 배수)
+ * @param group_by 추가 분류 기준 ("line": 감지선별, "board": 보드별, 그 외: 분류 없음)
+ * @return DetectionRollup 벡터 (구간 시작 시각 순)
+ */
+vector<DetectionRollup> select_detection_rollups(SQLite::Database& db, const DetectionFilter& filter,
+                                                 long long bucket_ms, const string& group_by)
+{
+    const long long HOUR_MS = 3600000;
+    const long long KST_OFFSET_MS = 9 * HOUR_MS;
+
+    vector<DetectionRollup> rollups;
+    bucket_ms = max(HOUR_MS, (bucket_ms / HOUR_MS) * HOUR_MS);
+    bool by_line = (group_by == "line");
+    bool by_board = (group_by == "board");
+
+    try
+    {
+        string sql = "SELECT ((hour_ms + ?) / ?) * ? - ? AS bucket, ";
+        sql += by_line ? "rule_name, " : "'', ";
+        sql += by_board ? "board_id, " : "-1, ";
+        sql += "sum(count), sum(similarity_sum) FROM detection_rollup_hourly WHERE hour_ms BETWEEN ? AND ?";
+        if (!filter.rule_name.empty())
+            sql += " AND rule_name = ?";
+        if (filter.board_id >= 0)
+            sql += " AND board_id = ?";
+        sql += " GROUP BY bucket";
+        if (by_line)
+            sql += ", rule_name";
+        if (by_board)
+            sql += ", board_id";
+        sql += " ORDER BY bucket";
+
+        CachedStatement query(db, sql);
+        int index = 1;
+        query->bind(index++, static_cast<int64_t>(KST_OFFSET_MS));
+        query->bind(index++, static_cast<int64_t>(bucket_ms));
+        query->bind(index++, static_cast<int64_t>(bucket_ms));
+        query->bind(index++, static_cast<int64_t>(KST_OFFSET_MS));
+        // 시작 시각이 속한 1시간 구간부터 포함
+        query->bind(index++, static_cast<int64_t>((filter.start_ms / HOUR_MS) * HOUR_MS));
+        query->bind(index++, static_cast<int64_t>(filter.end_ms));
+        if (!filter.rule_name.empty())
+            query->bind(index++, filter.rule_name);
+        if (filter.board_id >= 0)
+            query->bind(index++, filter.board_id);
+        log_sql("select rollups", *query);
+
+        while (query->executeStep())
+        {
+            DetectionRollup rollup;
+            rollup.bucket_start_ms = query->getColumn(0).getInt64();
+            rollup.rule_name = query->getColumn(1).getString();
+            rollup.board_id = query->getColumn(2).getInt();
+            rollup.count = query->getColumn(3).getInt64();
+            rollup.avg_similarity = rollup.count > 0 ? query->getColumn(4).getDouble() / rollup.count : 0.0;
+            rollups.push_back(std::move(rollup));
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "감지 집계 조회 실패: " << e.what() << endl;
+    }
+    return rollups;
+}
 
 /**
- * @brief Lines 테이블을 생성합니다.
- * @details 이 함수는 Lines 테이블을 생성하며, 테이블이 이미 존재하면 아무 작업도 수행하지 않습니다.
+ * @brief Detections 테이블의 모든 데이터를 삭제합니다.
  * @param db SQLite 데이터베이스 참조
  */
-void create_table_lines(SQLite::Database& db)
+void delete_all_data_detections(SQLite::Database& db)
 {
-    db.exec("CREATE TABLE IF NOT EXISTS lines ("
-            "indexNum INTEGER PRIMARY KEY NOT NULL, "
-            "x1 INTEGER NOT NULL , "
-            "y1 INTEGER NOT NULL , "
-            "x2 INTEGER NOT NULL , "
-            "y2 INTEGER NOT NULL , "
-            "name TEXT NOT NULL UNIQUE , "
-            "mode TEXT )"); // mode = "Right", "Left", "BothDirections"
-    cout << "'lines' 테이블이 준비되었습니다.\n";
+    try
+    {
+        CachedStatement query(db, "DELETE FROM detections");
+        log_sql("delete all", *query);
+        int changes = query->exec();
+        cout << "테이블의 모든 데이터를 삭제했습니다. 삭제된 행 수: " << changes << endl;
+    }
+    catch (const exception& e)
+    {
+        cerr << "테이블 전체 삭제 실패: " << e.what() << endl;
+    }
     return;
 }
 
+///////////////////////////////////////////////
+// Lines 테이블
+
 /**
  * @brief Lines 테이블에 데이터를 삽입합니다.
  * @param db SQLite 데이터베이스 참조
@@ -145,17 +388,17 @@ bool insert_data_lines(SQLite::Database& db, CrossLine crossLine)
     try
     {
         // SQL 인젝션 방지를 위해 Prepared Statement 사용
-        SQLite::Statement query(db, "INSERT INTO lines (indexNum, x1, y1, x2, y2, name, mode) "
-                                    "VALUES (?, ?, ?, ?, ?, ?, ?)");
-        query.bind(1, crossLine.index);
-        query.bind(2, crossLine.x1);
-        query.bind(3, crossLine.y1);
-        query.bind(4, crossLine.x2);
-        query.bind(5, crossLine.y2);
-        query.bind(6, crossLine.name);
-        query.bind(7, crossLine.mode);
-        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
-        query.exec();
+        CachedStatement query(db, "INSERT INTO lines (indexNum, x1, y1, x2, y2, name, mode) "
+                                  "VALUES (?, ?, ?, ?, ?, ?, ?)");
+        query->bind(1, crossLine.index);
+        query->bind(2, crossLine.x1);
+        query->bind(3, crossLine.y1);
+        query->bind(4, crossLine.x2);
+        query->bind(5, crossLine.y2);
+        query->bind(6, crossLine.name);
+        query->bind(7, crossLine.mode);
+        log_sql("insert", *query);
+        query->exec();
 
         cout << "데이터 추가: (인덱스: " << crossLine.index << ")" << endl;
     }
@@ -172,23 +415,24 @@ bool insert_data_lines(SQLite::Database& db, CrossLine crossLine)
  * @brief Lines 테이블의 모든 데이터를 조회합니다.
  * @param db SQLite 데이터베이스 참조
  * @return CrossLine 벡터
+ * @throws SQLite::Exception 조회 실패 시 (빈 목록으로 대신하지 않음)
  */
 vector<CrossLine> select_all_data_lines(SQLite::Database& db)
 {
     vector<CrossLine> lines;
     try
     {
-        SQLite::Statement query(db, "SELECT * FROM lines ORDER BY name");
-        cout << "Prepared SQL for select data vector: " << query.getExpandedSQL() << endl;
-        while (query.executeStep())
+        CachedStatement query(db, "SELECT * FROM lines ORDER BY name");
+        log_sql("select data vector", *query);
+        while (query->executeStep())
         {
-            int indexNum = query.getColumn("indexNum").getInt();
-            int x1 = query.getColumn("x1").getInt();
-            int y1 = query.getColumn("y1").getInt();
-            int x2 = query.getColumn("x2").getInt();
-            int y2 = query.getColumn("y2").getInt();
-            string name = query.getColumn("name");
-            string mode = query.getColumn("mode");
+            int indexNum = query->getColumn("indexNum").getInt();
+            int x1 = query->getColumn("x1").getInt();
+            int y1 = query->getColumn("y1").getInt();
+            int x2 = query->getColumn("x2").getInt();
+            int y2 = query->getColumn("y2").getInt();
+            string name = query->getColumn("name");
+            string mode = query->getColumn("mode");
 
             CrossLine line = {indexNum, x1, y1, x2, y2, name, mode};
             lines.push_back(line);
@@ -196,7 +440,9 @@ vector<CrossLine> select_all_data_lines(SQLite::Database& db)
     }
     catch (const exception& e)
     {
-        cerr << "사용자 조회 실패: " << e.what() << endl;
+        // 빈 목록과 조회 실패를 구분할 수 있도록 호출자에게 전달
+        cerr << "감지선 조회 실패: " << e.what() << endl;
+        throw;
     }
     return lines;
 }
@@ -205,19 +451,20 @@ vector<CrossLine> select_all_data_lines(SQLite::Database& db)
  * @brief Lines 테이블에서 특정 인덱스의 데이터를 삭제합니다.
  * @param db SQLite 데이터베이스 참조
  * @param indexNum 삭제할 인덱스 번호
+ * @param allow_missing true이면 삭제할 행이 없어도(이미 삭제됨) 성공으로 처리 (동기화용)
  * @return 성공 시 true, 실패 시 false
  */
-bool delete_data_lines(SQLite::Database& db, int indexNum)
+bool delete_data_lines(SQLite::Database& db, int indexNum, bool allow_missing)
 {
     try
     {
-        SQLite::Statement query(db, "DELETE FROM lines WHERE indexNum = ?");
-        query.bind(1, indexNum);
+        CachedStatement query(db, "DELETE FROM lines WHERE indexNum = ?");
+        query->bind(1, indexNum);
 
-        cout << "Prepared SQL for delete one: " << query.getExpandedSQL() << endl;
-        int changes = query.exec();
+        log_sql("delete one", *query);
+        int changes = query->exec();
         cout << "테이블의 특정 데이터를 삭제했습니다. 삭제된 행 수: " << changes << endl;
-        if (changes == 0)
+        if (changes == 0 && !allow_missing)
         {
             return false;
         }
@@ -239,9 +486,9 @@ bool delete_all_data_lines(SQLite::Database& db)
 {
     try
     {
-        SQLite::Statement query(db, "DELETE FROM lines");
-        cout << "Prepared SQL for delete all: " << query.getExpandedSQL() << endl;
-        int changes = query.exec();
+        CachedStatement query(db, "DELETE FROM lines");
+        log_sql("delete all", *query);
+        int changes = query->exec();
         cout << "테이블의 모든 데이터를 삭제했습니다. 삭제된 행 수: " << changes << endl;
         if (changes == 0)
         {
@@ -259,45 +506,28 @@ bool delete_all_data_lines(SQLite::Database& db)
 ///////////////////////////////////////////////
 // BaseLine 테이블
 
-/**
- * @brief baseLines 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_baseLines(SQLite::Database& db)
-{
-    db.exec("CREATE TABLE IF NOT EXISTS baseLines ("
-            "indexNum INTEGER PRIMARY KEY, "
-            "matrixNum1 INTEGER NOT NULL, "
-            "x1 INTEGER NOT NULL, "
-            "y1 INTEGER NOT NULL, "
-            "matrixNum2 INTEGER NOT NULL, "
-            "x2 INTEGER NOT NULL, "
-            "y2 INTEGER NOT NULL)");
-    cout << "'baseLines' 테이블이 준비되었습니다.\n";
-    return;
-}
-
 /**
  * @brief baseLines 테이블의 모든 데이터를 조회합니다.
  * @param db SQLite 데이터베이스 참조
  * @return BaseLine 벡터
+ * @throws SQLite::Exception 조회 실패 시 (빈 목록으로 대신하지 않음)
  */
 vector<BaseLine> select_all_data_baseLines(SQLite::Database& db)
 {
     vector<BaseLine> baseLines;
     try
     {
-        SQLite::Statement query(db, "SELECT * FROM baseLines");
-        cout << "Prepared SQL for select data vector: " << query.getExpandedSQL() << endl;
-        while (query.executeStep())
+        CachedStatement query(db, "SELECT * FROM baseLines");
+        log_sql("select data vector", *query);
+        while (query->executeStep())
         {
-            int indexNum = query.getColumn("indexNum").getInt();
-            int matrixNum1 = query.getColumn("matrixNum1").getInt();
-            int x1 = query.getColumn("x1").getInt();
-            int y1 = query.getColumn("y1").getInt();
-            int matrixNum2 = query.getColumn("matrixNum2").getInt();
-            int x2 = query.getColumn("x2").getInt();
-            int y2 = query.getColumn("y2").getInt();
+            int indexNum = query->getColumn("indexNum").getInt();
+            int matrixNum1 = query->getColumn("matrixNum1").getInt();
+            int x1 = query->getColumn("x1").getInt();
+            int y1 = query->getColumn("y1").getInt();
+            int matrixNum2 = query->getColumn("matrixNum2").getInt();
+            int x2 = query->getColumn("x2").getInt();
+            int y2 = query->getColumn("y2").getInt();
 
             BaseLine baseLine = {indexNum, matrixNum1, x1, y1, matrixNum2, x2, y2};
             baseLines.push_back(baseLine);
@@ -305,7 +535,8 @@ vector<BaseLine> select_all_data_baseLines(SQLite::Database& db)
     }
     catch (const exception& e)
     {
-        cerr << "사용자 조회 실패: " << e.what() << endl;
+        cerr << "기준선 조회 실패: " << e.what() << endl;
+        throw;
     }
     return baseLines;
 }
@@ -321,18 +552,18 @@ bool insert_data_baseLines(SQLite::Database& db, BaseLine baseLine)
     try
     {
         // SQL 인젝션 방지를 위해 Prepared Statement 사용
-        SQLite::Statement query(db, "INSERT INTO baseLines (indexNum, matrixNum1, x1, y1, "
-                                    "matrixNum2, x2, y2) VALUES (?, ?, ?, ?, ?, ?, ?)");
-        query.bind(1, baseLine.index);
-        query.bind(2, baseLine.matrixNum1);
-        query.bind(3, baseLine.x1);
-        query.bind(4, baseLine.y1);
-        query.bind(5, baseLine.matrixNum2);
-        query.bind(6, baseLine.x2);
-        query.bind(7, baseLine.y2);
-
-        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
-        query.exec();
+        CachedStatement query(db, "INSERT INTO baseLines (indexNum, matrixNum1, x1, y1, "
+                                  "matrixNum2, x2, y2) VALUES (?, ?, ?, ?, ?, ?, ?)");
+        query->bind(1, baseLine.index);
+        query->bind(2, baseLine.matrixNum1);
+        query->bind(3, baseLine.x1);
+        query->bind(4, baseLine.y1);
+        query->bind(5, baseLine.matrixNum2);
+        query->bind(6, baseLine.x2);
+        query->bind(7, baseLine.y2);
+
+        log_sql("insert", *query);
+        query->exec();
 
         cout << "데이터 추가: (기준선 인덱스: " << baseLine.index << ")" << endl;
     }
@@ -356,15 +587,15 @@ bool update_data_baseLines(SQLite::Database& db, BaseLine baseLine)
     try
     {
         // SQL 인젝션 방지를 위해 Prepared Statement 사용
-        SQLite::Statement query(db, "UPDATE baseLines "
-                                    "SET matrixNum1 = ?, matrixNum2 = ? "
-                                    "WHERE indexNum = ?");
-        query.bind(1, baseLine.matrixNum1);
-        query.bind(2, baseLine.matrixNum2);
-        query.bind(3, baseLine.index);
+        CachedStatement query(db, "UPDATE baseLines "
+                                  "SET matrixNum1 = ?, matrixNum2 = ? "
+                                  "WHERE indexNum = ?");
+        query->bind(1, baseLine.matrixNum1);
+        query->bind(2, baseLine.matrixNum2);
+        query->bind(3, baseLine.index);
 
-        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
-        query.exec();
+        log_sql("insert", *query);
+        query->exec();
 
         cout << "데이터 수정: (기준선 인덱스: " << baseLine.index << ")" << endl;
     }
@@ -386,9 +617,9 @@ bool delete_all_data_baseLines(SQLite::Database& db)
 {
     try
     {
-        SQLite::Statement query(db, "DELETE FROM baselines");
-        cout << "Prepared SQL for delete all: " << query.getExpandedSQL() << endl;
-        int changes = query.exec();
+        CachedStatement query(db, "DELETE FROM baselines");
+        log_sql("delete all", *query);
+        int changes = query->exec();
         cout << "테이블의 모든 데이터를 삭제했습니다. 삭제된 행 수: " << changes << endl;
         if (changes == 0)
         {
@@ -406,20 +637,6 @@ bool delete_all_data_baseLines(SQLite::Database& db)
 ///////////////////////////////////////////////
 // VerticalLineEquation 테이블
 
-/**
- * @brief verticalLineEquations 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_verticalLineEquations(SQLite::Database& db)
-{
-    db.exec("CREATE TABLE IF NOT EXISTS verticalLineEquations ("
-            "indexNum INTEGER PRIMARY KEY, "
-            "a REAL NOT NULL, "
-            "b REAL NOT NULL)");
-    cout << "'verticalLineEquations' 테이블이 준비되었습니다.\n";
-    return;
-}
-
 /**
  * @brief verticalLineEquations 테이블에서 특정 인덱스의 데이터를 조회합니다.
  * @param db SQLite 데이터베이스 참조
@@ -431,14 +648,14 @@ VerticalLineEquation select_data_verticalLineEquations(SQLite::Database& db, int
     VerticalLineEquation verticalLineEquation;
     try
     {
-        SQLite::Statement query(db, "SELECT * FROM verticalLineEquations WHERE index = ?");
-        cout << "Prepared SQL for select data vector: " << query.getExpandedSQL() << endl;
-        query.bind(1, index);
-        query.exec();
+        CachedStatement query(db, "SELECT * FROM verticalLineEquations WHERE index = ?");
+        log_sql("select data vector", *query);
+        query->bind(1, index);
+        query->exec();
 
-        int indexNum = query.getColumn("indexNum").getInt();
-        double x = query.getColumn("x");
-        double y = query.getColumn("y");
+        int indexNum = query->getColumn("indexNum").getInt();
+        double x = query->getColumn("x");
+        double y = query->getColumn("y");
 
         verticalLineEquation = {indexNum, x, y};
     }
@@ -449,6 +666,34 @@ VerticalLineEquation select_data_verticalLineEquations(SQLite::Database& db, int
     return verticalLineEquation;
 }
 
+/**
+ * @brief verticalLineEquations 테이블의 모든 데이터를 조회합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @return VerticalLineEquation 벡터 (indexNum 순)
+ * @throws SQLite::Exception 조회 실패 시 (빈 목록으로 대신하지 않음)
+ */
+vector<VerticalLineEquation> select_all_data_verticalLineEquations(SQLite::Database& db)
+{
+    vector<VerticalLineEquation> verticalLineEquations;
+    try
+    {
+        CachedStatement query(db, "SELECT indexNum, a, b FROM verticalLineEquations ORDER BY indexNum");
+        log_sql("select data vector", *query);
+        while (query->executeStep())
+        {
+            VerticalLineEquation verticalLineEquation = {query->getColumn(0).getInt(), query->getColumn(1).getDouble(),
+                                                         query->getColumn(2).getDouble()};
+            verticalLineEquations.push_back(verticalLineEquation);
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "수직선 방정식 조회 실패: " << e.what() << endl;
+        throw;
+    }
+    return verticalLineEquations;
+}
+
 /**
  * @brief verticalLineEquations 테이블에 데이터를 삽입합니다.
  * @param db SQLite 데이터베이스 참조
@@ -460,12 +705,12 @@ bool insert_data_verticalLineEquations(SQLite::Database& db, VerticalLineEquatio
     try
     {
         // SQL 인젝션 방지를 위해 Prepared Statement 사용
-        SQLite::Statement query(db, "INSERT INTO verticalLineEquations (indexNum, a, b) VALUES (?, ?, ?)");
-        query.bind(1, verticalLineEquation.index);
-        query.bind(2, verticalLineEquation.a);
-        query.bind(3, verticalLineEquation.b);
-        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
-        query.exec();
+        CachedStatement query(db, "INSERT INTO verticalLineEquations (indexNum, a, b) VALUES (?, ?, ?)");
+        query->bind(1, verticalLineEquation.index);
+        query->bind(2, verticalLineEquation.a);
+        query->bind(3, verticalLineEquation.b);
+        log_sql("insert", *query);
+        query->exec();
 
         cout << "데이터 추가: (인덱스: " << verticalLineEquation.index << ")" << endl;
     }
@@ -487,9 +732,9 @@ bool delete_all_data_verticalLineEquations(SQLite::Database& db)
 {
     try
     {
-        SQLite::Statement query(db, "DELETE FROM verticalLineEquations");
-        cout << "Prepared SQL for delete all: " << query.getExpandedSQL() << endl;
-        int changes = query.exec();
+        CachedStatement query(db, "DELETE FROM verticalLineEquations");
+        log_sql("delete all", *query);
+        int changes = query->exec();
         cout << "테이블의 모든 데이터를 삭제했습니다. 삭제된 행 수: " << changes << endl;
         if (changes == 0)
         {
@@ -504,21 +749,6 @@ bool delete_all_data_verticalLineEquations(SQLite::Database& db)
     return true;
 }
 
-/**
- * @brief accounts 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_accounts(SQLite::Database& db)
-{
-    db.exec("CREATE TABLE IF NOT EXISTS accounts ("
-            "id TEXT PRIMARY KEY, "
-            "passwd TEXT NOT NULL, "
-            "otp_secret TEXT, "
-            "use_otp INTEGER DEFAULT 0)");
-    cout << "'accounts' 테이블이 준비되었습니다.\n";
-    return;
-}
-
 /**
  * @brief accounts 테이블에서 id와 passwd로 계정 정보를 조회합니다.
  * @param db SQLite 데이터베이스 참조
@@ -539,12 +769,12 @@ Account* select_data_accounts(SQLite::Database& db, string id, string passwd)
             return nullptr;
         }
 
-        SQLite::Statement query(db, "SELECT * FROM accounts WHERE id = ? AND passwd = ?");
-        query.bind(1, id);
-        query.bind(2, passwd);
+        CachedStatement query(db, "SELECT * FROM accounts WHERE id = ? AND passwd = ?");
+        query->bind(1, id);
+        query->bind(2, passwd);
 
-        string id = query.getColumn("id");
-        string passwd = query.getColumn("passwd");
+        string id = query->getColumn("id");
+        string passwd = query->getColumn("passwd");
 
         account->id = id;
         account->passwd = passwd;
@@ -567,13 +797,13 @@ bool insert_data_accounts(SQLite::Database& db, Account account)
 {
     try
     {
-        SQLite::Statement query(db, "INSERT INTO accounts (id, passwd, otp_secret, use_otp) VALUES (?, ?, ?, ?)");
-        query.bind(1, account.id);
-        query.bind(2, account.passwd);
-        query.bind(3, account.otp_secret);
-        query.bind(4, account.use_otp ? 1 : 0);
-        cout << "Prepared SQL for insert: " << query.getExpandedSQL() << endl;
-        query.exec();
+        CachedStatement query(db, "INSERT INTO accounts (id, passwd, otp_secret, use_otp) VALUES (?, ?, ?, ?)");
+        query->bind(1, account.id);
+        query->bind(2, account.passwd);
+        query->bind(3, account.otp_secret);
+        query->bind(4, account.use_otp ? 1 : 0);
+        log_sql("insert", *query);
+        query->exec();
 
         cout << "데이터 추가: (id: " << account.id << ")" << endl;
     }
@@ -596,16 +826,16 @@ Account* get_account_by_id(SQLite::Database& db, const string& id)
     try
     {
         // use_otp도 함께 조회
-        SQLite::Statement query(db, "SELECT id, passwd, otp_secret, use_otp FROM accounts WHERE id = ?");
-        query.bind(1, id);
+        CachedStatement query(db, "SELECT id, passwd, otp_secret, use_otp FROM accounts WHERE id = ?");
+        query->bind(1, id);
 
-        if (query.executeStep())
+        if (query->executeStep())
         { // 행이 존재하는 경우 (사용자를 찾음)
             Account* acc = new Account{
-                query.getColumn(0).getString(),  // id
-                query.getColumn(1).getString(),  // passwd (hashed)
-                query.getColumn(2).getString(),  // otp_secret
-                query.getColumn(3).getInt() == 1 // use_otp
+                query->getColumn(0).getString(),  // id
+                query->getColumn(1).getString(),  // passwd (hashed)
+                query->getColumn(2).getString(),  // otp_secret
+                query->getColumn(3).getInt() == 1 // use_otp
             };
             return acc;
         }
@@ -622,20 +852,6 @@ Account* get_account_by_id(SQLite::Database& db, const string& id)
     }
 }
 
-/**
- * @brief recovery_codes 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_recovery_codes(SQLite::Database& db)
-{
-    db.exec("CREATE TABLE IF NOT EXISTS recovery_codes ("
-            "id TEXT NOT NULL, "
-            "code TEXT NOT NULL, "
-            "used INTEGER DEFAULT 0, "
-            "FOREIGN KEY(id) REFERENCES accounts(id))");
-    cout << "'recovery_codes' 테이블이 준비되었습니다.\n";
-}
-
 /**
  * @brief accounts 테이블에 OTP 시크릿을 저장합니다.
  * @param db SQLite 데이터베이스 참조
@@ -647,10 +863,10 @@ bool store_otp_secret(SQLite::Database& db, const string& id, const string& secr
 {
     try
     {
-        SQLite::Statement query(db, "UPDATE accounts SET otp_secret = ? WHERE id = ?");
-        query.bind(1, secret);
-        query.bind(2, id);
-        query.exec();
+        CachedStatement query(db, "UPDATE accounts SET otp_secret = ? WHERE id = ?");
+        query->bind(1, secret);
+        query->bind(2, id);
+        query->exec();
         return true;
     }
     catch (const std::exception& e)
@@ -662,6 +878,7 @@ bool store_otp_secret(SQLite::Database& db, const string& id, const string& secr
 
 /**
  * @brief recovery_codes 테이블에 복구 코드를 저장합니다.
+ * @details 호출자가 트랜잭션을 열었으면 그 안에서 저장하고, 아니면 직접 트랜잭션을 열어 모두 저장합니다.
  * @param db SQLite 데이터베이스 참조
  * @param id 사용자 ID
  * @param codes 저장할 복구 코드 벡터
@@ -671,16 +888,24 @@ bool store_recovery_codes(SQLite::Database& db, const string& id, const vector<s
 {
     try
     {
-        SQLite::Transaction transaction(db);
-        SQLite::Statement query(db, "INSERT INTO recovery_codes (id, code) VALUES (?, ?)");
+        // 호출자가 이미 연 트랜잭션(회원가입 전체) 안이면 그 트랜잭션에 포함시키고, 아니면 직접 엶
+        unique_ptr<SQLite::Transaction> transaction;
+        if (sqlite3_get_autocommit(db.getHandle()))
+        {
+            transaction = make_unique<SQLite::Transaction>(db);
+        }
+        CachedStatement query(db, "INSERT INTO recovery_codes (id, code) VALUES (?, ?)");
         for (const auto& code : codes)
         {
-            query.bind(1, id);
-            query.bind(2, code);
-            query.exec();
-            query.reset();
+            query->bind(1, id);
+            query->bind(2, code);
+            query->exec();
+            query->reset();
+        }
+        if (transaction)
+        {
+            transaction->commit();
         }
-        transaction.commit();
         return true;
     }
     catch (const std::exception& e)
@@ -690,6 +915,25 @@ bool store_recovery_codes(SQLite::Database& db, const string& id, const vector<s
     }
 }
 
+/**
+ * @brief 해시된 복구 코드 목록에서 입력한 복구 코드와 일치하는 해시를 찾습니다.
+ * @details 해시마다 argon2 검증을 하므로 DB 연결(특히 쓰기 연결)을 잡지 않은 상태에서 호출합니다.
+ * @param hashed_codes 해시된 복구 코드 목록 (get_hashed_recovery_codes 결과)
+ * @param input 입력한 복구 코드
+ * @return 일치하는 해시, 없으면 빈 문자열
+ */
+std::string match_recovery_code(const std::vector<std::string>& hashed_codes, const std::string& input)
+{
+    for (const auto& hashed : hashed_codes)
+    {
+        if (verify_password(hashed, input))
+        {
+            return hashed;
+        }
+    }
+    return ""; // 일치하는 코드가 없음
+}
+
 /**
  * @brief 입력한 복구 코드가 DB에 저장된 해시와 일치하는지 검증합니다.
  * @param db SQLite 데이터베이스 참조
@@ -702,15 +946,7 @@ bool verify_recovery_code(SQLite::Database& db, const std::string& id, const std
     // DB에서 해당 id의 해시된 복구 코드 목록을 가져옴
     try
     {
-        std::vector<std::string> hashed_codes = get_hashed_recovery_codes(db, id);
-        for (const auto& hashed : hashed_codes)
-        {
-            if (verify_password(hashed, input))
-            {
-                return true;
-            }
-        }
-        return false; // 일치하는 코드가 없음
+        return !match_recovery_code(get_hashed_recovery_codes(db, id), input).empty();
     }
     catch (const std::exception& e)
     {
@@ -720,38 +956,21 @@ bool verify_recovery_code(SQLite::Database& db, const std::string& id, const std
 }
 
 /**
- * @brief 입력한 복구 코드가 일치하면 해당 코드를 used=1로 무효화합니다.
- * @param db SQLite 데이터베이스 참조
+ * @brief 일치한 복구 코드(해시)를 아직 사용되지 않은 경우에만 used=1로 무효화합니다.
+ * @details 검증과 무효화 사이에 다른 요청이 같은 코드를 먼저 사용했으면 변경된 행이 없으므로 실패합니다.
+ * @param db SQLite 데이터베이스 참조 (쓰기 가능)
  * @param id 사용자 ID
- * @param input_code 입력한 복구 코드
- * @return 성공 시 true, 실패 시 false
+ * @param hashed_code match_recovery_code로 찾은 해시
+ * @return 이번 호출로 무효화했으면 true, 이미 사용됐거나 실패하면 false
  */
-bool invalidate_recovery_code(SQLite::Database& db, const string& id, const string& input_code)
+bool consume_recovery_code(SQLite::Database& db, const string& id, const string& hashed_code)
 {
     try
     {
-        // 1. 사용자의 모든 미사용 복구 코드(해시) 가져오기
-        std::vector<std::string> hashed_codes = get_hashed_recovery_codes(db, id);
-        std::string matched_hash;
-        for (const auto& hash : hashed_codes)
-        {
-            if (verify_password(hash, input_code))
-            {
-                matched_hash = hash;
-                break;
-            }
-        }
-        if (matched_hash.empty())
-        {
-            // 일치하는 코드 없음
-            return false;
-        }
-        // 2. 일치하는 해시값을 가진 코드만 used=1로 업데이트
-        SQLite::Statement query(db, "UPDATE recovery_codes SET used = 1 WHERE id = ? AND code = ?");
-        query.bind(1, id);
-        query.bind(2, matched_hash);
-        int changes = query.exec();
-        return changes > 0;
+        CachedStatement query(db, "UPDATE recovery_codes SET used = 1 WHERE id = ? AND code = ? AND used = 0");
+        query->bind(1, id);
+        query->bind(2, hashed_code);
+        return query->exec() == 1;
     }
     catch (const std::exception& e)
     {
@@ -771,11 +990,11 @@ std::vector<std::string> get_hashed_recovery_codes(SQLite::Database& db, const s
     std::vector<std::string> codes;
     try
     {
-        SQLite::Statement query(db, "SELECT code FROM recovery_codes WHERE id = ? AND used = 0");
-        query.bind(1, id);
-        while (query.executeStep())
+        CachedStatement query(db, "SELECT code FROM recovery_codes WHERE id = ? AND used = 0");
+        query->bind(1, id);
+        while (query->executeStep())
         {
-            codes.push_back(query.getColumn(0).getString());
+            codes.push_back(query->getColumn(0).getString());
         }
     }
     catch (const std::exception& e)
@@ -22,7 +22,36 @@
 struct Detection
 {
     std::vector<unsigned char> imageBlob; ///< 이미지 데이터 (BLOB)
-    std::string timestamp;                ///< 감지 시각
+    std::string timestamp;                ///< 감지 시각 (KST 문자열)
+    long long timestamp_ms = 0;           ///< 감지 시각 (epoch 밀리초, 인덱스 컬럼 ts_ms)
+    int id = 0;                           ///< detections 행 id
+    int human_id = -1;                    ///< 감지선을 넘은 사람 객체 ID (-1: 기록 없음)
+    std::string rule_name;                ///< 넘은 감지선 이름
+    int vehicle_id = -1;                  ///< 접근 중인 차량 객체 ID (-1: 기록 없음)
+    int board_id = -1;                    ///< 가동한 dot matrix 보드 ID (-1: 기록 없음)
+    double similarity = 0.0;              ///< 차량 진행 방향과 감지선의 코사인 유사도
+};
+
+/**
+ * @brief 감지 이벤트 조회 조건
+ * @details 비어 있는 조건(rule_name == "", board_id < 0)은 필터링하지 않습니다.
+ */
+struct DetectionFilter
+{
+    long long start_ms = 0; ///< 시작 시각 (epoch 밀리초, 포함)
+    long long end_ms = 0;   ///< 종료 시각 (epoch 밀리초, 포함)
+    std::string rule_name;  ///< 감지선 이름 (빈 문자열이면 전체)
+    int board_id = -1;      ///< 보드 ID (음수면 전체)
+    int limit = 0;          ///< 최대 조회 행 수 (0이면 제한 없음)
+};
+
+/**
+ * @brief 시간 구간별 감지 건수
+ */
+struct DetectionBucket
+{
+    long long bucket_start_ms; ///< 구간 시작 시각 (epoch 밀리초)
+    int count;                 ///< 구간 내 감지 건수
 };
 
 /**
@@ -90,10 +119,16 @@ struct RecoveryCode
 };
 
 /**
- * @brief Detections 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
+ * @brief 시간 구간별 감지 집계 (detection_rollup_hourly 기반)
  */
-void create_table_detections(SQLite::Database& db);
+struct DetectionRollup
+{
+    long long bucket_start_ms; ///< 구간 시작 시각 (epoch 밀리초)
+    std::string rule_name;     ///< 감지선 이름 (감지선별 집계가 아니면 빈 문자열)
+    int board_id;              ///< 보드 ID (보드별 집계가 아니면 -1)
+    long long count;           ///< 구간 내 감지 건수
+    double avg_similarity;     ///< 구간 내 평균 코사인 유사도
+};
 
 /**
  * @brief Detections 테이블에 데이터를 삽입합니다.
@@ -104,26 +139,64 @@ void create_table_detections(SQLite::Database& db);
 bool insert_data_detections(SQLite::Database& db, Detection detection);
 
 /**
- * @brief 주어진 시간 범위 내의 Detection 데이터를 조회합니다.
+ * @brief 주어진 시간 범위 내의 Detection 데이터(이미지 포함)를 조회합니다.
  * @param db SQLite 데이터베이스 참조
- * @param startTimestamp 시작 타임스탬프
- * @param endTimestamp 종료 타임스탬프
+ * @param startMs 시작 시각 (epoch 밀리초, 포함)
+ * @param endMs 종료 시각 (epoch 밀리초, 포함)
  * @return Detection 벡터
  */
-std::vector<Detection> select_data_for_timestamp_range_detections(SQLite::Database& db, std::string startTimestamp,
-                                                                  std::string endTimestamp);
+std::vector<Detection> select_data_for_timestamp_range_detections(SQLite::Database& db, long long startMs,
+                                                                  long long endMs);
 
 /**
- * @brief Detections 테이블의 모든 데이터를 삭제합니다.
+ * @brief 주어진 시간 범위 내의 Detection 목록(id, 시각)만 조회합니다.
+ * @details ts_ms 인덱스만으로 응답할 수 있어 이미지 BLOB 페이지를 읽지 않습니다.
  * @param db SQLite 데이터베이스 참조
+ * @param startMs 시작 시각 (epoch 밀리초, 포함)
+ * @param endMs 종료 시각 (epoch 밀리초, 포함)
+ * @return imageBlob이 비어 있는 Detection 벡터
  */
-void delete_all_data_detections(SQLite::Database& db);
+std::vector<Detection> select_list_for_timestamp_range_detections(SQLite::Database& db, long long startMs,
+                                                                  long long endMs);
+
+/**
+ * @brief 조건에 맞는 감지 이벤트 목록(메타데이터만, 이미지 제외)을 조회합니다.
+ * @details 시각 기준 커버링 인덱스(idx_detections_ts_event)만으로 응답하므로 이미지 BLOB 페이지를 읽지 않습니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param filter 조회 조건
+ * @return imageBlob이 비어 있는 Detection 벡터 (시각 순)
+ */
+std::vector<Detection> select_events_detections(SQLite::Database& db, const DetectionFilter& filter);
+
+/**
+ * @brief 조건에 맞는 감지 건수를 시간 구간별로 집계합니다.
+ * @details 구간 경계는 집계 테이블 조회와 같이 KST 기준으로 맞춥니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param filter 조회 조건 (limit은 무시)
+ * @param bucket_ms 구간 길이 (밀리초, 0 이하이면 전체를 하나의 구간으로 집계)
+ * @return DetectionBucket 벡터 (구간 시작 시각 순, 건수가 0인 구간은 제외)
+ */
+std::vector<DetectionBucket> count_detections_by_bucket(SQLite::Database& db, const DetectionFilter& filter,
+                                                        long long bucket_ms);
 
 /**
- * @brief Lines 테이블을 생성합니다.
+ * @brief 집계 테이블에서 시간 구간별 감지 건수를 조회합니다.
+ * @details 1시간 단위로 미리 집계된 detection_rollup_hourly만 읽으므로 감지 이력 크기와 무관하게 빠르게 응답합니다.
+ *          구간 경계는 1시간 단위로 맞춰지며, 일 단위 구간은 KST 자정 기준입니다.
  * @param db SQLite 데이터베이스 참조
+ * @param filter 조회 조건 (limit은 무시)
+ * @param bucket_ms 구간 길이 (밀리초, 1시간의 배수)
+ * @param group_by 추가 분류 기준 ("line": 감지선별, "board": 보드별, 그 외: 분류 없음)
+ * @return DetectionRollup 벡터 (구간 시작 시각 순)
  */
-void create_table_lines(SQLite::Database& db);
+std::vector<DetectionRollup> select_detection_rollups(SQLite::Database& db, const DetectionFilter& filter,
+                                                      long long bucket_ms, const std::string& group_by);
+
+/**
+ * @brief Detections 테이블의 모든 데이터를 삭제합니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+void delete_all_data_detections(SQLite::Database& db);
 
 /**
  * @brief Lines 테이블에 데이터를 삽입합니다.
@@ -137,6 +210,7 @@ bool insert_data_lines(SQLite::Database& db, CrossLine crossLine);
  * @brief Lines 테이블의 모든 데이터를 조회합니다.
  * @param db SQLite 데이터베이스 참조
  * @return CrossLine 벡터
+ * @throws SQLite::Exception 조회 실패 시 (빈 목록으로 대신하지 않음)
  */
 std::vector<CrossLine> select_all_data_lines(SQLite::Database& db);
 
@@ -144,9 +218,10 @@ std::vector<CrossLine> select_all_data_lines(SQLite::Database& db);
  * @brief Lines 테이블에서 특정 인덱스의 데이터를 삭제합니다.
  * @param db SQLite 데이터베이스 참조
  * @param indexNum 삭제할 인덱스 번호
+ * @param allow_missing true이면 삭제할 행이 없어도(이미 삭제됨) 성공으로 처리 (동기화용)
  * @return 성공 시 true, 실패 시 false
  */
-bool delete_data_lines(SQLite::Database& db, int indexNum);
+bool delete_data_lines(SQLite::Database& db, int indexNum, bool allow_missing = false);
 
 /**
  * @brief Lines 테이블의 모든 데이터를 삭제합니다.
@@ -155,16 +230,11 @@ bool delete_data_lines(SQLite::Database& db, int indexNum);
  */
 bool delete_all_data_lines(SQLite::Database& db);
 
-/**
- * @brief baseLines 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_baseLines(SQLite::Database& db);
-
 /**
  * @brief baseLines 테이블의 모든 데이터를 조회합니다.
  * @param db SQLite 데이터베이스 참조
  * @return BaseLine 벡터
+ * @throws SQLite::Exception 조회 실패 시 (빈 목록으로 대신하지 않음)
  */
 std::vector<BaseLine> select_all_data_baseLines(SQLite::Database& db);
 
@@ -191,12 +261,6 @@ bool update_data_baseLines(SQLite::Database& db, BaseLine baseline);
  */
 bool delete_all_data_baseLines(SQLite::Database& db);
 
-/**
- * @brief verticalLineEquations 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_verticalLineEquations(SQLite::Database& db);
-
 /**
  * @brief verticalLineEquations 테이블에서 특정 인덱스의 데이터를 조회합니다.
  * @param db SQLite 데이터베이스 참조
@@ -205,6 +269,14 @@ void create_table_verticalLineEquations(SQLite::Database& db);
  */
 VerticalLineEquation select_data_verticalLineEquations(SQLite::Database& db, int index);
 
+/**
+ * @brief verticalLineEquations 테이블의 모든 데이터를 조회합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @return VerticalLineEquation 벡터 (indexNum 순)
+ * @throws SQLite::Exception 조회 실패 시 (빈 목록으로 대신하지 않음)
+ */
+std::vector<VerticalLineEquation> select_all_data_verticalLineEquations(SQLite::Database& db);
+
 /**
  * @brief verticalLineEquations 테이블에 데이터를 삽입합니다.
  * @param db SQLite 데이터베이스 참조
@@ -220,12 +292,6 @@ bool insert_data_verticalLineEquations(SQLite::Database& db, VerticalLineEquatio
  */
 bool delete_all_data_verticalLineEquations(SQLite::Database& db);
 
-/**
- * @brief accounts 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_accounts(SQLite::Database& db);
-
 /**
  * @brief accounts 테이블에서 id와 passwd로 계정 정보를 조회합니다.
  * @param db SQLite 데이터베이스 참조
@@ -251,12 +317,6 @@ bool insert_data_accounts(SQLite::Database& db, Account account);
  */
 Account* get_account_by_id(SQLite::Database& db, const std::string& id);
 
-/**
- * @brief recovery_codes 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void create_table_recovery_codes(SQLite::Database& db);
-
 /**
  * @brief accounts 테이블에 OTP 시크릿을 저장합니다.
  * @param db SQLite 데이터베이스 참조
@@ -268,6 +328,7 @@ bool store_otp_secret(SQLite::Database& db, const std::string& id, const std::st
 
 /**
  * @brief recovery_codes 테이블에 복구 코드를 저장합니다.
+ * @details 호출자가 트랜잭션을 열었으면 그 안에서 저장하고, 아니면 직접 트랜잭션을 열어 모두 저장합니다.
  * @param db SQLite 데이터베이스 참조
  * @param id 사용자 ID
  * @param codes 저장할 복구 코드 벡터
@@ -275,6 +336,14 @@ bool store_otp_secret(SQLite::Database& db, const std::string& id, const std::st
  */
 bool store_recovery_codes(SQLite::Database& db, const std::string& id, const std::vector<std::string>& codes);
 
+/**
+ * @brief 해시된 복구 코드 목록에서 입력한 복구 코드와 일치하는 해시를 찾습니다.
+ * @param hashed_codes 해시된 복구 코드 목록
+ * @param input 입력한 복구 코드
+ * @return 일치하는 해시, 없으면 빈 문자열
+ */
+std::string match_recovery_code(const std::vector<std::string>& hashed_codes, const std::string& input);
+
 /**
  * @brief 입력한 복구 코드가 DB에 저장된 해시와 일치하는지 검증합니다.
  * @param db SQLite 데이터베이스 참조
@@ -285,13 +354,13 @@ bool store_recovery_codes(SQLite::Database& db, const std::string& id, const std
 bool verify_recovery_code(SQLite::Database& db, const std::string& id, const std::string& code);
 
 /**
- * @brief 입력한 복구 코드가 일치하면 해당 코드를 used=1로 무효화합니다.
- * @param db SQLite 데이터베이스 참조
+ * @brief 일치한 복구 코드(해시)를 아직 사용되지 않은 경우에만 used=1로 무효화합니다.
+ * @param db SQLite 데이터베이스 참조 (쓰기 가능)
  * @param id 사용자 ID
- * @param code 입력한 복구 코드
- * @return 성공 시 true, 실패 시 false
+ * @param hashed_code match_recovery_code로 찾은 해시
+ * @return 이번 호출로 무효화했으면 true, 이미 사용됐거나 실패하면 false
  */
-bool invalidate_recovery_code(SQLite::Database& db, const std::string& id, const std::string& code);
+bool consume_recovery_code(SQLite::Database& db, const std::string& id, const std::string& hashed_code);
 
 /**
  * @brief recovery_codes 테이블에서 사용되지 않은 해시 복구 코드 목록을 조회합니다.
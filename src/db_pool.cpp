@@ -0,0 +1,200 @@
+/**
+ * @file db_pool.cpp
+ * @brief SQLite 연결 풀 구현 파일
+ * @details 읽기 전용 연결 대여/반납과 단일 쓰기 스레드의 작업 큐를 구현합니다.
+ */
+
+#include "db_pool.hpp"
+#include "db_statement_cache.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief 연결에 WAL 저널 모드와 busy timeout 정책을 적용합니다. (새 DB 파일은 auto_vacuum=INCREMENTAL로 생성)
+ * @param db SQLite 데이터베이스 참조
+ * @param busy_timeout_ms 잠금 대기 시간(ms)
+ * @param writable 쓰기 가능한 연결이면 true
+ */
+void configure_sqlite_connection(SQLite::Database& db, int busy_timeout_ms, bool writable)
+{
+    db.setBusyTimeout(busy_timeout_ms);
+    if (writable)
+    {
+        // 새 DB는 테이블을 만들기 전(WAL 전환 전)에만 auto_vacuum을 바꿀 수 있으므로 여기서 INCREMENTAL로 생성
+        // (기존 DB의 전환은 전체 VACUUM이 필요하므로 보존 스레드의 retention.vacuum_conversion 경로에서만 수행)
+        if (db.execAndGet("PRAGMA page_count").getInt() == 0)
+        {
+            db.exec("PRAGMA auto_vacuum = INCREMENTAL");
+        }
+
+        // journal_mode는 DB 파일에 영구 저장되므로 한 번 설정되면 다른 프로세스의 연결에도 적용됨
+        string mode = db.execAndGet("PRAGMA journal_mode = WAL").getString();
+        if (mode != "wal")
+        {
+            cerr << "[DB] WAL 모드 전환 실패 (journal_mode=" << mode << ")" << endl;
+        }
+        db.exec("PRAGMA synchronous = NORMAL");
+    }
+}
+
+/**
+ * @brief 소멸자. 열려 있는 연결과 쓰기 스레드를 정리함
+ */
+DatabasePool::~DatabasePool()
+{
+    close();
+}
+
+/**
+ * @brief 쓰기 연결(WAL 설정)과 읽기 연결들을 열고 쓰기 스레드를 시작합니다.
+ * @details 쓰기 연결을 먼저 열어 WAL 모드로 전환한 뒤 읽기 연결을 엽니다.
+ * @param db_file DB 파일 경로
+ * @param reader_count 읽기 전용 연결 수 (0이면 읽기도 쓰기 연결에서 실행)
+ * @param busy_timeout_ms 잠금 대기 시간(ms)
+ * @return 성공 시 true, 실패 시 false
+ */
+bool DatabasePool::open(const string& db_file, int reader_count, int busy_timeout_ms)
+{
+    try
+    {
+        writer = make_unique<SQLite::Database>(db_file, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        configure_sqlite_connection(*writer, busy_timeout_ms, true);
+
+        for (int i = 0; i < reader_count; ++i)
+        {
+            readers.push_back(make_unique<SQLite::Database>(db_file, SQLite::OPEN_READONLY));
+            configure_sqlite_connection(*readers.back(), busy_timeout_ms, false);
+            idle_readers.push_back(readers.back().get());
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "[DB] 연결 풀 생성 실패: " << e.what() << endl;
+        for (auto& reader : readers)
+        {
+            release_statement_cache(*reader);
+        }
+        if (writer)
+        {
+            release_statement_cache(*writer);
+        }
+        idle_readers.clear();
+        readers.clear();
+        writer.reset();
+        return false;
+    }
+
+    stopping = false;
+    writer_thread = thread(&DatabasePool::writer_loop, this);
+    cout << "[DB] 연결 풀 준비 완료 (WAL, 읽기 연결 " << reader_count << "개, 쓰기 연결 1개, busy_timeout "
+         << busy_timeout_ms << "ms)" << endl;
+    return true;
+}
+
+/**
+ * @brief 대기 중인 쓰기 작업을 모두 실행한 뒤 쓰기 스레드와 연결을 닫습니다.
+ */
+void DatabasePool::close()
+{
+    {
+        lock_guard<mutex> lock(write_mutex);
+        stopping = true;
+    }
+    write_cv.notify_all();
+    if (writer_thread.joinable())
+    {
+        writer_thread.join();
+    }
+
+    lock_guard<mutex> lock(reader_mutex);
+    for (auto& reader : readers)
+    {
+        release_statement_cache(*reader);
+    }
+    if (writer)
+    {
+        release_statement_cache(*writer);
+    }
+    idle_readers.clear();
+    readers.clear();
+    writer.reset();
+}
+
+/**
+ * @brief 쓰기 큐에 대기 중인 작업 수를 반환합니다.
+ * @return 대기 중인 작업 수
+ */
+size_t DatabasePool::pending_writes()
+{
+    lock_guard<mutex> lock(write_mutex);
+    return write_queue.size();
+}
+
+/**
+ * @brief 빈 읽기 연결이 생길 때까지 기다린 뒤 빌립니다.
+ * @param pool 연결 풀
+ */
+DatabasePool::ReaderLease::ReaderLease(DatabasePool& pool) : pool(pool)
+{
+    unique_lock<mutex> lock(pool.reader_mutex);
+    pool.reader_cv.wait(lock, [&pool] { return !pool.idle_readers.empty(); });
+    db = pool.idle_readers.back();
+    pool.idle_readers.pop_back();
+}
+
+/**
+ * @brief 빌린 읽기 연결을 반납합니다.
+ */
+DatabasePool::ReaderLease::~ReaderLease()
+{
+    {
+        lock_guard<mutex> lock(pool.reader_mutex);
+        pool.idle_readers.push_back(db);
+    }
+    pool.reader_cv.notify_one();
+}
+
+/**
+ * @brief 쓰기 큐에 작업을 추가합니다.
+ * @param task 쓰기 작업
+ */
+void DatabasePool::enqueue_write(function<void(SQLite::Database&)> task)
+{
+    {
+        lock_guard<mutex> lock(write_mutex);
+        if (stopping || !writer)
+        {
+            throw runtime_error("DB 쓰기 연결이 닫혀 있습니다.");
+        }
+        write_queue.push_back(std::move(task));
+    }
+    write_cv.notify_one();
+}
+
+/**
+ * @brief 쓰기 스레드 본체. 큐의 작업을 순서대로 실행
+ * @details 작업의 예외는 packaged_task가 future로 전달하므로 여기서는 잡지 않아도 됩니다.
+ *          종료 요청 후에도 이미 큐에 들어온 작업은 모두 실행합니다.
+ */
+void DatabasePool::writer_loop()
+{
+    while (true)
+    {
+        function<void(SQLite::Database&)> task;
+        {
+            unique_lock<mutex> lock(write_mutex);
+            write_cv.wait(lock, [this] { return stopping || !write_queue.empty(); });
+            if (write_queue.empty())
+            {
+                break;
+            }
+            task = std::move(write_queue.front());
+            write_queue.pop_front();
+        }
+        task(*writer);
+    }
+    cout << "[DB] 쓰기 스레드 종료" << endl;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file db_pool.hpp
+ * @brief SQLite 연결 풀 헤더 파일
+ * @details WAL 모드 DB에 대해 읽기 전용 연결 여러 개와 쓰기 전용 연결 하나를 관리합니다.
+ *          SELECT는 읽기 연결에서 동시에 실행되고, 모든 쓰기는 전용 쓰기 스레드의 큐를 통해 순서대로 실행됩니다.
+ */
+
+#pragma once
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 연결에 WAL 저널 모드와 busy timeout 정책을 적용합니다.
+ * @details WAL 모드에서는 읽기와 쓰기가 서로를 막지 않으므로 synchronous=NORMAL로도 커밋 단위 무결성이 유지됩니다.
+ *          쓰기 연결로 새 DB 파일을 만들 때는 테이블 생성 전에 auto_vacuum=INCREMENTAL을 설정합니다.
+ *          읽기 전용 연결에는 busy timeout만 적용합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param busy_timeout_ms 잠금 대기 시간(ms)
+ * @param writable 쓰기 가능한 연결이면 true
+ */
+void configure_sqlite_connection(SQLite::Database& db, int busy_timeout_ms, bool writable);
+
+/**
+ * @class DatabasePool
+ * @brief 읽기 전용 연결 풀과 단일 쓰기 연결(큐)을 관리하는 클래스
+ * @details read()는 빈 읽기 연결을 빌려 호출 스레드에서 바로 실행하고, write()는 작업을 쓰기 큐에 넣고 쓰기 스레드가
+ *          실행을 마칠 때까지 기다립니다. 쓰기 작업 안에서 다시 write()를 호출하면 교착 상태가 되므로 안 됩니다.
+ */
+class DatabasePool
+{
+public:
+    /**
+     * @brief 소멸자. 열려 있는 연결과 쓰기 스레드를 정리함
+     */
+    ~DatabasePool();
+
+    /**
+     * @brief 쓰기 연결(WAL 설정)과 읽기 연결들을 열고 쓰기 스레드를 시작합니다.
+     * @param db_file DB 파일 경로
+     * @param reader_count 읽기 전용 연결 수 (0이면 읽기도 쓰기 연결에서 실행)
+     * @param busy_timeout_ms 잠금 대기 시간(ms)
+     * @return 성공 시 true, 실패 시 false
+     */
+    bool open(const std::string& db_file, int reader_count, int busy_timeout_ms);
+
+    /**
+     * @brief 대기 중인 쓰기 작업을 모두 실행한 뒤 쓰기 스레드와 연결을 닫습니다.
+     */
+    void close();
+
+    /**
+     * @brief 읽기 연결을 하나 빌려 작업을 실행합니다.
+     * @param func SQLite::Database&를 인자로 받는 작업
+     * @return 작업의 반환값
+     */
+    template <typename Func> auto read(Func&& func) -> decltype(func(std::declval<SQLite::Database&>()))
+    {
+        if (readers.empty())
+        {
+            return write(std::forward<Func>(func));
+        }
+        ReaderLease lease(*this);
+        return func(*lease.db);
+    }
+
+    /**
+     * @brief 쓰기 큐에 작업을 넣고 실행 결과를 기다립니다.
+     * @details 작업에서 발생한 예외는 호출 스레드로 다시 던져집니다.
+     * @param func SQLite::Database&를 인자로 받는 작업
+     * @return 작업의 반환값
+     */
+    template <typename Func> auto write(Func&& func) -> decltype(func(std::declval<SQLite::Database&>()))
+    {
+        return submit_write(std::forward<Func>(func)).get();
+    }
+
+    /**
+     * @brief 쓰기 큐에 작업을 넣고 결과를 받을 future를 반환합니다. (기다리지 않음)
+     * @param func SQLite::Database&를 인자로 받는 작업
+     * @return 작업 결과 future
+     */
+    template <typename Func>
+    auto submit_write(Func&& func) -> std::future<decltype(func(std::declval<SQLite::Database&>()))>
+    {
+        using Result = decltype(func(std::declval<SQLite::Database&>()));
+        auto task = std::make_shared<std::packaged_task<Result(SQLite::Database&)>>(std::forward<Func>(func));
+        std::future<Result> result = task->get_future();
+        enqueue_write([task](SQLite::Database& db) { (*task)(db); });
+        return result;
+    }
+
+    /**
+     * @brief 쓰기 큐에 대기 중인 작업 수를 반환합니다.
+     * @return 대기 중인 작업 수
+     */
+    size_t pending_writes();
+
+private:
+    /**
+     * @brief 읽기 연결 대여 객체 (소멸 시 반납)
+     */
+    struct ReaderLease
+    {
+        explicit ReaderLease(DatabasePool& pool);
+        ~ReaderLease();
+        ReaderLease(const ReaderLease&) = delete;
+        ReaderLease& operator=(const ReaderLease&) = delete;
+
+        DatabasePool& pool;
+        SQLite::Database* db;
+    };
+
+    /**
+     * @brief 쓰기 큐에 작업을 추가합니다.
+     * @param task 쓰기 작업
+     */
+    void enqueue_write(std::function<void(SQLite::Database&)> task);
+
+    /**
+     * @brief 쓰기 스레드 본체. 큐의 작업을 순서대로 실행
+     */
+    void writer_loop();
+
+    /**
+     * @brief 읽기 연결 목록과 빈 연결 목록, 보호용 뮤텍스/조건변수
+     */
+    std::vector<std::unique_ptr<SQLite::Database>> readers;
+    std::vector<SQLite::Database*> idle_readers;
+    std::mutex reader_mutex;
+    std::condition_variable reader_cv;
+
+    /**
+     * @brief 쓰기 연결, 쓰기 큐, 쓰기 스레드
+     */
+    std::unique_ptr<SQLite::Database> writer;
+    std::deque<std::function<void(SQLite::Database&)>> write_queue;
+    std::mutex write_mutex;
+    std::condition_variable write_cv;
+    std::thread writer_thread;
+    bool stopping = false;
+};
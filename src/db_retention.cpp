@@ -0,0 +1,322 @@
+/**
+ * @file db_retention.cpp
+ * @brief 감지 데이터 보존(retention) 관리 구현 파일
+ * @details detections 테이블을 보존 기간/최대 용량 기준으로 작은 배치 단위로 삭제하고,
+ *          incremental_vacuum으로 빈 페이지를 나누어 반환합니다.
+ */
+
+#include "db_retention.hpp"
+#include "config_manager.hpp"
+#include "db_statement_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 보존 관리자 인스턴스
+ */
+RetentionManager g_retention;
+
+/**
+ * @brief 배치 사이에 다른 연결에게 잠금을 양보하는 시간(ms)
+ */
+static const int BATCH_YIELD_MS = 20;
+
+/**
+ * @brief g_config의 보존 설정값으로 RetentionPolicy를 생성합니다.
+ * @return RetentionPolicy
+ */
+RetentionPolicy retention_policy_from_config()
+{
+    RetentionPolicy policy;
+    policy.max_age_days = g_config.retention_max_age_days;
+    policy.max_bytes = g_config.retention_max_bytes;
+    policy.batch_size = max(1, g_config.retention_batch_size);
+    policy.interval_sec = max(1, g_config.retention_interval_sec);
+    policy.vacuum_pages_per_step = max(1, g_config.retention_vacuum_pages);
+    policy.vacuum_conversion = g_config.retention_vacuum_conversion;
+    return policy;
+}
+
+/**
+ * @brief 소멸자. 실행 중인 보존 스레드를 중지함
+ */
+RetentionManager::~RetentionManager()
+{
+    stop();
+}
+
+/**
+ * @brief 보존 작업 스레드를 시작합니다.
+ * @param db_pool DB 연결 풀 (stop() 호출 전까지 유효해야 함)
+ * @param policy 보존 정책
+ */
+void RetentionManager::start(DatabasePool& db_pool, const RetentionPolicy& policy)
+{
+    if (running.exchange(true))
+    {
+        return;
+    }
+    this->db_pool = &db_pool;
+    this->policy = policy;
+    worker = thread(&RetentionManager::worker_loop, this);
+
+    cout << "[Retention] 보존 스레드 시작 (max_age_days=" << policy.max_age_days
+         << ", max_bytes=" << policy.max_bytes << ", batch=" << policy.batch_size
+         << ", interval=" << policy.interval_sec << "s)" << endl;
+}
+
+/**
+ * @brief 보존 작업 스레드를 중지하고 종료를 기다립니다.
+ */
+void RetentionManager::stop()
+{
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        if (!running.exchange(false))
+        {
+            return;
+        }
+    }
+    wake_cv.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief 현재 통계를 반환합니다.
+ * @return RetentionStats 복사본
+ */
+RetentionStats RetentionManager::get_stats()
+{
+    lock_guard<mutex> lock(stats_mutex);
+    return stats;
+}
+
+/**
+ * @brief 보존 스레드 대기 중 stop()이 호출되었는지 확인하며 대기
+ * @param ms 대기 시간(ms)
+ * @return 계속 실행해야 하면 true
+ */
+bool RetentionManager::wait_for(int ms)
+{
+    unique_lock<mutex> lock(wake_mutex);
+    wake_cv.wait_for(lock, chrono::milliseconds(ms), [this] { return !running.load(); });
+    return running.load();
+}
+
+/**
+ * @brief 보존 스레드 본체. interval_sec 주기로 run_once를 호출
+ */
+void RetentionManager::worker_loop()
+{
+    try
+    {
+        db_pool->write([this](SQLite::Database& db) { ensure_incremental_vacuum(db); });
+    }
+    catch (const exception& e)
+    {
+        cerr << "[Retention] auto_vacuum 설정 실패: " << e.what() << endl;
+    }
+
+    do
+    {
+        try
+        {
+            run_once();
+        }
+        catch (const exception& e)
+        {
+            cerr << "[Retention] 보존 작업 실패: " << e.what() << endl;
+        }
+    } while (wait_for(policy.interval_sec * 1000));
+    cout << "[Retention] 보존 스레드 종료" << endl;
+}
+
+/**
+ * @brief auto_vacuum 모드가 INCREMENTAL이 아니고 vacuum_conversion이 켜져 있으면 전환합니다. (전체 VACUUM 1회)
+ * @details 새 DB는 생성 시 INCREMENTAL로 만들어지므로(configure_sqlite_connection) 이 전환은 이전 버전이 만든 DB에만
+ *          해당합니다. 기존 DB의 auto_vacuum 모드 변경은 VACUUM을 한 번 실행해야 적용됩니다. 전체 VACUUM은 DB 크기만큼의 임시
+ *          공간과 시간이 들고 그동안 쓰기가 막히므로, 유지보수 플래그(retention.vacuum_conversion)를 켠 경우에만
+ *          실행합니다. 전환 이후에는 전체 VACUUM 없이 incremental_vacuum만으로 공간을 반환합니다.
+ * @param db DB 연결
+ */
+void RetentionManager::ensure_incremental_vacuum(SQLite::Database& db)
+{
+    const int AUTO_VACUUM_INCREMENTAL = 2;
+
+    int mode = db.execAndGet("PRAGMA auto_vacuum").getInt();
+    if (mode != AUTO_VACUUM_INCREMENTAL && !policy.vacuum_conversion)
+    {
+        cout << "[Retention] auto_vacuum=INCREMENTAL이 아니므로 빈 페이지 반환을 건너뜁니다. "
+             << "(전환하려면 retention.vacuum_conversion을 켜고 재시작)" << endl;
+    }
+    else if (mode != AUTO_VACUUM_INCREMENTAL)
+    {
+        cout << "[Retention] auto_vacuum=INCREMENTAL 전환을 위해 최초 1회 VACUUM을 실행합니다..." << endl;
+        db.exec("PRAGMA auto_vacuum = INCREMENTAL");
+        db.exec("VACUUM");
+        mode = db.execAndGet("PRAGMA auto_vacuum").getInt();
+    }
+
+    lock_guard<mutex> lock(stats_mutex);
+    stats.incremental_vacuum = (mode == AUTO_VACUUM_INCREMENTAL);
+}
+
+/**
+ * @brief 보존 작업을 한 번 수행합니다.
+ * @details 1) 보존 기간이 지난 행 삭제, 2) 최대 용량 초과 시 가장 오래된 행부터 삭제,
+ *          3) 빈 페이지 반환 순서로 진행하며, 각 배치는 쓰기 큐의 독립된 짧은 트랜잭션입니다.
+ */
+void RetentionManager::run_once()
+{
+    auto started = chrono::steady_clock::now();
+    int64_t purged = 0;
+
+    // 1. 보존 기간 초과 데이터 삭제
+    if (policy.max_age_days > 0)
+    {
+        int64_t max_age_sec = static_cast<int64_t>(policy.max_age_days) * 24 * 3600;
+        int64_t cutoff = (static_cast<int64_t>(time(nullptr)) - max_age_sec) * 1000;
+        int64_t removed;
+        do
+        {
+            removed = db_pool->write([&](SQLite::Database& db) { return purge_batch(db, cutoff); });
+            purged += removed;
+        } while (removed >= policy.batch_size && wait_for(BATCH_YIELD_MS));
+    }
+
+    // 2. 최대 용량 초과 시 가장 오래된 데이터부터 삭제
+    if (policy.max_bytes > 0)
+    {
+        refresh_size_stats();
+        while (running && get_stats().used_bytes > policy.max_bytes)
+        {
+            int64_t removed = db_pool->write([this](SQLite::Database& db) { return purge_batch(db, 0); });
+            purged += removed;
+            if (removed == 0 || !wait_for(BATCH_YIELD_MS))
+            {
+                break;
+            }
+            refresh_size_stats();
+        }
+    }
+
+    // 3. 빈 페이지 반환
+    int64_t vacuumed = vacuum_free_pages();
+    refresh_size_stats();
+
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+    {
+        lock_guard<mutex> lock(stats_mutex);
+        stats.runs++;
+        stats.last_purged_rows = purged;
+        stats.total_purged_rows += purged;
+        stats.total_vacuumed_pages += vacuumed;
+        stats.last_run_duration_ms = elapsed;
+        stats.last_run_epoch_sec = time(nullptr);
+    }
+
+    if (purged > 0 || vacuumed > 0)
+    {
+        cout << "[Retention] " << purged << "행 삭제, " << vacuumed << "페이지 반환 (" << elapsed << "ms)" << endl;
+    }
+}
+
+/**
+ * @brief 가장 오래된 행부터 batch_size개 이하를 한 트랜잭션으로 삭제
+ * @details 기간 기준 삭제는 ts_ms 인덱스로 오래된 행만 찾고, 용량 기준 삭제는 id 순서(삽입 순서)로 찾으므로
+ *          테이블 전체나 이미지 BLOB 페이지를 훑지 않습니다.
+ * @param db DB 연결
+ * @param age_cutoff_ms 이 시각(epoch 밀리초)보다 오래된 행만 삭제 (0이면 나이와 무관하게 삭제)
+ * @return 삭제된 행 수
+ */
+int64_t RetentionManager::purge_batch(SQLite::Database& db, int64_t age_cutoff_ms)
+{
+    SQLite::Transaction transaction(db);
+    int changes;
+    if (age_cutoff_ms == 0)
+    {
+        CachedStatement query(db, "DELETE FROM detections WHERE id IN "
+                                  "(SELECT id FROM detections ORDER BY id LIMIT ?)");
+        query->bind(1, policy.batch_size);
+        changes = query->exec();
+    }
+    else
+    {
+        CachedStatement query(db, "DELETE FROM detections WHERE id IN "
+                                  "(SELECT id FROM detections WHERE ts_ms < ? ORDER BY ts_ms LIMIT ?)");
+        query->bind(1, age_cutoff_ms);
+        query->bind(2, policy.batch_size);
+        changes = query->exec();
+    }
+    transaction.commit();
+    return changes;
+}
+
+/**
+ * @brief freelist 페이지를 vacuum_pages_per_step 단위로 나누어 반환
+ * @details 요청한 페이지 수가 아니라 incremental_vacuum 실행 전후의 freelist_count 차이를 반환 페이지 수로 셉니다.
+ * @return 실제로 반환된 페이지 수 (실행 전후 freelist_count 차이의 합)
+ */
+int64_t RetentionManager::vacuum_free_pages()
+{
+    if (!get_stats().incremental_vacuum)
+    {
+        return 0;
+    }
+
+    int64_t total = 0;
+    while (running)
+    {
+        int64_t step = db_pool->write(
+            [this](SQLite::Database& db)
+            {
+                int64_t free_before = db.execAndGet("PRAGMA freelist_count").getInt64();
+                int64_t pages = min<int64_t>(free_before, policy.vacuum_pages_per_step);
+                if (pages <= 0)
+                {
+                    return int64_t(0);
+                }
+                db.exec("PRAGMA incremental_vacuum(" + to_string(pages) + ")");
+                int64_t free_after = db.execAndGet("PRAGMA freelist_count").getInt64();
+                return free_before - free_after;
+            });
+        if (step <= 0)
+        {
+            break;
+        }
+        total += step;
+        if (!wait_for(BATCH_YIELD_MS))
+        {
+            break;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief 파일/사용/빈 페이지 크기 통계를 갱신
+ */
+void RetentionManager::refresh_size_stats()
+{
+    int64_t page_size = 0, page_count = 0, free_pages = 0;
+    db_pool->read(
+        [&](SQLite::Database& db)
+        {
+            page_size = db.execAndGet("PRAGMA page_size").getInt64();
+            page_count = db.execAndGet("PRAGMA page_count").getInt64();
+            free_pages = db.execAndGet("PRAGMA freelist_count").getInt64();
+        });
+
+    lock_guard<mutex> lock(stats_mutex);
+    stats.file_bytes = page_size * page_count;
+    stats.freelist_bytes = page_size * free_pages;
+    stats.used_bytes = stats.file_bytes - stats.freelist_bytes;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file db_retention.hpp
+ * @brief 감지 데이터 보존(retention) 관리 헤더 파일
+ * @details detections 테이블의 오래된 데이터를 보존 기간/최대 용량 기준으로 주기적으로 삭제하고,
+ *          auto_vacuum=INCREMENTAL 모드로 삭제된 공간을 조금씩 파일 시스템에 반환합니다.
+ */
+
+#pragma once
+
+#include "db_pool.hpp"
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief 보존 정책 설정값 (config.json의 "retention" 항목)
+ */
+struct RetentionPolicy
+{
+    int max_age_days;          ///< 보존 기간(일), 0이면 기간 제한 없음
+    int64_t max_bytes;         ///< DB 최대 사용 용량(바이트), 0이면 용량 제한 없음
+    int batch_size;            ///< 한 트랜잭션에서 삭제할 최대 행 수
+    int interval_sec;          ///< 보존 작업 실행 주기(초)
+    int vacuum_pages_per_step; ///< incremental_vacuum 1회당 반환할 최대 페이지 수
+    bool vacuum_conversion;    ///< auto_vacuum 전환에 필요한 전체 VACUUM 실행 허용 여부 (유지보수 플래그)
+};
+
+/**
+ * @brief 보존 작업 상태 및 통계
+ */
+struct RetentionStats
+{
+    int64_t file_bytes = 0;           ///< DB 파일 크기 (page_count * page_size)
+    int64_t used_bytes = 0;           ///< 사용 중인 크기 (freelist 제외)
+    int64_t freelist_bytes = 0;       ///< 아직 반환되지 않은 빈 페이지 크기
+    int64_t total_purged_rows = 0;    ///< 시작 이후 삭제된 총 행 수
+    int64_t last_purged_rows = 0;     ///< 마지막 실행에서 삭제된 행 수
+    int64_t total_vacuumed_pages = 0; ///< 시작 이후 반환된 총 페이지 수
+    int64_t runs = 0;                 ///< 보존 작업 실행 횟수
+    int64_t last_run_duration_ms = 0; ///< 마지막 실행 소요 시간(ms)
+    int64_t last_run_epoch_sec = 0;   ///< 마지막 실행 시각 (epoch 초)
+    bool incremental_vacuum = false;  ///< auto_vacuum=INCREMENTAL 적용 여부
+};
+
+/**
+ * @class RetentionManager
+ * @brief detections 테이블 보존 작업을 백그라운드 스레드에서 수행하는 클래스
+ * @details 삭제와 vacuum은 연결 풀의 쓰기 큐에 작은 배치 단위 작업으로 넣으므로, 배치 사이에 요청 처리 스레드의
+ *          쓰기 작업이 끼어들 수 있어 오래 대기하지 않습니다.
+ */
+class RetentionManager
+{
+public:
+    /**
+     * @brief 소멸자. 실행 중인 보존 스레드를 중지함
+     */
+    ~RetentionManager();
+
+    /**
+     * @brief 보존 작업 스레드를 시작합니다.
+     * @param db_pool DB 연결 풀 (stop() 호출 전까지 유효해야 함)
+     * @param policy 보존 정책
+     */
+    void start(DatabasePool& db_pool, const RetentionPolicy& policy);
+
+    /**
+     * @brief 보존 작업 스레드를 중지하고 종료를 기다립니다.
+     */
+    void stop();
+
+    /**
+     * @brief 현재 통계를 반환합니다.
+     * @return RetentionStats 복사본
+     */
+    RetentionStats get_stats();
+
+    /**
+     * @brief 보존 작업을 한 번 수행합니다.
+     */
+    void run_once();
+
+private:
+    /**
+     * @brief 보존 스레드 본체. interval_sec 주기로 run_once를 호출
+     */
+    void worker_loop();
+
+    /**
+     * @brief auto_vacuum 모드가 INCREMENTAL이 아니고 vacuum_conversion이 켜져 있으면 전환합니다. (전체 VACUUM 1회)
+     * @param db DB 연결
+     */
+    void ensure_incremental_vacuum(SQLite::Database& db);
+
+    /**
+     * @brief 가장 오래된 행부터 batch_size개 이하를 한 트랜잭션으로 삭제
+     * @param db DB 연결
+     * @param age_cutoff_ms 이 시각(epoch 밀리초)보다 오래된 행만 삭제 (0이면 나이와 무관하게 삭제)
+     * @return 삭제된 행 수
+     */
+    int64_t purge_batch(SQLite::Database& db, int64_t age_cutoff_ms);
+
+    /**
+     * @brief freelist 페이지를 vacuum_pages_per_step 단위로 나누어 반환
+     * @return 실제로 반환된 페이지 수 (실행 전후 freelist_count 차이의 합)
+     */
+    int64_t vacuum_free_pages();
+
+    /**
+     * @brief 파일/사용/빈 페이지 크기 통계를 갱신
+     */
+    void refresh_size_stats();
+
+    /**
+     * @brief 보존 스레드 대기 중 stop()이 호출되었는지 확인하며 대기
+     * @param ms 대기 시간(ms)
+     * @return 계속 실행해야 하면 true
+     */
+    bool wait_for(int ms);
+
+    /**
+     * @brief DB 연결 풀
+     */
+    DatabasePool* db_pool = nullptr;
+
+    /**
+     * @brief 보존 정책
+     */
+    RetentionPolicy policy{};
+
+    /**
+     * @brief 통계 및 보호용 뮤텍스
+     */
+    RetentionStats stats;
+    std::mutex stats_mutex;
+
+    /**
+     * @brief 보존 스레드 및 종료 신호
+     */
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+};
+
+/**
+ * @brief 서버 전역 보존 관리자 인스턴스
+ */
+extern RetentionManager g_retention;
+
+/**
+ * @brief g_config의 보존 설정값으로 RetentionPolicy를 생성합니다.
+ * @return RetentionPolicy
+ */
+RetentionPolicy retention_policy_from_config();
@@ -0,0 +1,265 @@
+/**
+ * @file db_schema.cpp
+ * @brief DB 스키마 마이그레이션 구현 파일
+ * @details 테이블 생성과 스키마 변경을 순서가 정해진 마이그레이션 단계로 구현합니다.
+ */
+
+#include "db_schema.hpp"
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief 테이블에 특정 컬럼이 존재하는지 확인합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param table 테이블 이름
+ * @param column 컬럼 이름
+ * @return 존재하면 true
+ */
+bool column_exists(SQLite::Database& db, const string& table, const string& column)
+{
+    SQLite::Statement query(db, "SELECT count(*) FROM pragma_table_info(?) WHERE name = ?");
+    query.bind(1, table);
+    query.bind(2, column);
+    return query.executeStep() && query.getColumn(0).getInt() > 0;
+}
+
+/**
+ * @brief 기본 테이블(detections, lines, baseLines, verticalLineEquations, accounts, recovery_codes)을 생성합니다.
+ * @details detections는 최초 스키마(id, image, timestamp)로 만들고, 이후 컬럼은 다음 마이그레이션이 추가합니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+static void create_base_tables(SQLite::Database& db)
+{
+    db.exec("CREATE TABLE IF NOT EXISTS detections ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "image BLOB, "
+            "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP NOT NULL)");
+    db.exec("CREATE TABLE IF NOT EXISTS lines ("
+            "indexNum INTEGER PRIMARY KEY NOT NULL, "
+            "x1 INTEGER NOT NULL , "
+            "y1 INTEGER NOT NULL , "
+            "x2 INTEGER NOT NULL , "
+            "y2 INTEGER NOT NULL , "
+            "name TEXT NOT NULL UNIQUE , "
+            "mode TEXT )"); // mode = "Right", "Left", "BothDirections"
+    db.exec("CREATE TABLE IF NOT EXISTS baseLines ("
+            "indexNum INTEGER PRIMARY KEY, "
+            "matrixNum1 INTEGER NOT NULL, "
+            "x1 INTEGER NOT NULL, "
+            "y1 INTEGER NOT NULL, "
+            "matrixNum2 INTEGER NOT NULL, "
+            "x2 INTEGER NOT NULL, "
+            "y2 INTEGER NOT NULL)");
+    db.exec("CREATE TABLE IF NOT EXISTS verticalLineEquations ("
+            "indexNum INTEGER PRIMARY KEY, "
+            "a REAL NOT NULL, "
+            "b REAL NOT NULL)");
+    db.exec("CREATE TABLE IF NOT EXISTS accounts ("
+            "id TEXT PRIMARY KEY, "
+            "passwd TEXT NOT NULL, "
+            "otp_secret TEXT, "
+            "use_otp INTEGER DEFAULT 0)");
+    db.exec("CREATE TABLE IF NOT EXISTS recovery_codes ("
+            "id TEXT NOT NULL, "
+            "code TEXT NOT NULL, "
+            "used INTEGER DEFAULT 0, "
+            "FOREIGN KEY(id) REFERENCES accounts(id))");
+}
+
+/**
+ * @brief detections 테이블에 epoch 밀리초 타임스탬프(ts_ms) 컬럼을 추가합니다.
+ * @details "KST"로 끝나는 값(control이 기록한 "YYYY-MM-DDTHH:MM:SSKST" 형식)만 KST(+9시간)로 해석하고, 'Z'/"UTC"로
+ *          끝나거나 접미사가 없는 값(컬럼 기본값 CURRENT_TIMESTAMP의 "YYYY-MM-DD HH:MM:SS" 형식)은 UTC로 해석합니다.
+ *          해석할 수 없는 값은 0 대신 마이그레이션 시각으로 채워 보존 기간 정리에서 즉시 삭제되지 않도록 합니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+static void migrate_detections_timestamp_ms(SQLite::Database& db)
+{
+    if (!column_exists(db, "detections", "ts_ms"))
+    {
+        cout << "[Migration] detections.ts_ms 컬럼 추가 및 기존 타임스탬프 변환 중..." << endl;
+
+        db.exec("ALTER TABLE detections ADD COLUMN ts_ms INTEGER NOT NULL DEFAULT 0");
+        int converted = db.exec("UPDATE detections SET ts_ms = COALESCE("
+                                "CAST(ROUND((julianday(replace(substr(timestamp, 1, 19), 'T', ' ')) - 2440587.5) "
+                                "* 86400000) AS INTEGER) "
+                                "- CASE WHEN timestamp LIKE '%KST' THEN 32400000 ELSE 0 END, "
+                                "CAST(strftime('%s', 'now') AS INTEGER) * 1000)");
+
+        cout << "[Migration] detections.ts_ms 변환 완료 (" << converted << "행)" << endl;
+    }
+}
+
+/**
+ * @brief detections 테이블에 이벤트 메타데이터 컬럼과 커버링 인덱스를 추가합니다.
+ * @details ALTER TABLE로 추가된 컬럼은 이미지 BLOB 뒤에 저장되어 테이블에서 직접 읽으면 BLOB의 overflow 페이지를
+ *          따라가야 하므로, 조회에 필요한 컬럼을 모두 포함하는 시각 기준 인덱스를 하나 만듭니다. 라인/보드 조건은
+ *          이 인덱스 안에서 걸러지고, 라인/보드별 통계는 집계 테이블이 담당합니다.
+ *          시각 기준 커버링 인덱스가 ts_ms 단일 인덱스를 대신하므로 기존 idx_detections_ts_ms는 삭제합니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+static void migrate_detections_event_metadata(SQLite::Database& db)
+{
+    static const pair<const char*, const char*> columns[] = {
+        {"human_id", "INTEGER"}, {"rule_name", "TEXT"}, {"vehicle_id", "INTEGER"},
+        {"board_id", "INTEGER"}, {"similarity", "REAL"},
+    };
+
+    for (const auto& [name, type] : columns)
+    {
+        if (!column_exists(db, "detections", name))
+        {
+            cout << "[Migration] detections." << name << " 컬럼 추가" << endl;
+            db.exec(string("ALTER TABLE detections ADD COLUMN ") + name + " " + type);
+        }
+    }
+
+    db.exec("CREATE INDEX IF NOT EXISTS idx_detections_ts_event ON detections "
+            "(ts_ms, rule_name, board_id, human_id, vehicle_id, similarity)");
+    db.exec("DROP INDEX IF EXISTS idx_detections_ts_ms");
+}
+
+/**
+ * @brief 시간(1시간)/감지선/보드 단위 감지 건수 집계 테이블과 갱신 트리거를 생성합니다.
+ * @details detections에 행이 삽입될 때마다 AFTER INSERT 트리거가 해당 집계 행을 갱신하므로 통계 조회는 detections
+ *          크기와 무관하게 집계 테이블만 읽습니다. 집계 테이블을 처음 만들 때는 기존 detections로 한 번 채우며,
+ *          보존 작업으로 삭제된 감지는 집계에서 빼지 않습니다. 메타데이터가 없는 감지는 rule_name = '',
+ *          board_id = -1로 집계합니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+static void create_detection_rollups(SQLite::Database& db)
+{
+    if (db.tableExists("detection_rollup_hourly"))
+    {
+        return;
+    }
+
+    cout << "[Migration] detection_rollup_hourly 집계 테이블 생성 및 기존 감지 집계 중..." << endl;
+
+    db.exec("CREATE TABLE detection_rollup_hourly ("
+            "hour_ms INTEGER NOT NULL, "
+            "rule_name TEXT NOT NULL, "
+            "board_id INTEGER NOT NULL, "
+            "count INTEGER NOT NULL, "
+            "similarity_sum REAL NOT NULL, "
+            "PRIMARY KEY (hour_ms, rule_name, board_id)) WITHOUT ROWID");
+
+    db.exec("INSERT INTO detection_rollup_hourly (hour_ms, rule_name, board_id, count, similarity_sum) "
+            "SELECT (ts_ms / 3600000) * 3600000, COALESCE(rule_name, ''), COALESCE(board_id, -1), "
+            "count(*), total(similarity) FROM detections GROUP BY 1, 2, 3");
+
+    db.exec("CREATE TRIGGER IF NOT EXISTS trg_detections_rollup AFTER INSERT ON detections "
+            "BEGIN "
+            "INSERT INTO detection_rollup_hourly (hour_ms, rule_name, board_id, count, similarity_sum) "
+            "VALUES ((NEW.ts_ms / 3600000) * 3600000, COALESCE(NEW.rule_name, ''), COALESCE(NEW.board_id, -1), 1, "
+            "COALESCE(NEW.similarity, 0)) "
+            "ON CONFLICT (hour_ms, rule_name, board_id) DO UPDATE SET "
+            "count = count + 1, similarity_sum = similarity_sum + excluded.similarity_sum; "
+            "END");
+
+    int rows = db.execAndGet("SELECT count(*) FROM detection_rollup_hourly").getInt();
+    cout << "[Migration] detection_rollup_hourly 생성 완료 (" << rows << "행)" << endl;
+}
+
+/**
+ * @brief 설정 테이블 변경 버전(config_version) 테이블과 갱신 트리거를 생성합니다.
+ * @details control 프로세스는 이 값이 바뀌었을 때만 설정 테이블을 다시 읽습니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+static void create_config_version(SQLite::Database& db)
+{
+    db.exec("CREATE TABLE IF NOT EXISTS config_version ("
+            "id INTEGER PRIMARY KEY CHECK (id = 0), "
+            "version INTEGER NOT NULL)");
+    db.exec("INSERT OR IGNORE INTO config_version (id, version) VALUES (0, 0)");
+
+    for (const char* table : {"lines", "baseLines", "verticalLineEquations"})
+    {
+        for (const char* operation : {"INSERT", "UPDATE", "DELETE"})
+        {
+            db.exec(string("CREATE TRIGGER IF NOT EXISTS trg_") + table + "_" + operation + "_version AFTER " +
+                    operation + " ON " + table +
+                    " BEGIN UPDATE config_version SET version = version + 1 WHERE id = 0; END");
+        }
+    }
+}
+
+/**
+ * @brief 설정 테이블의 변경 버전을 조회합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @return 변경 버전
+ */
+int64_t select_config_version(SQLite::Database& db)
+{
+    return db.execAndGet("SELECT version FROM config_version WHERE id = 0").getInt64();
+}
+
+/**
+ * @brief 스키마 마이그레이션 단계 (적용 후 버전, 설명, 적용 함수)
+ */
+struct SchemaMigration
+{
+    int version;
+    const char* description;
+    void (*apply)(SQLite::Database&);
+};
+
+/**
+ * @brief PRAGMA user_version을 기준으로 아직 적용되지 않은 마이그레이션을 순서대로 적용합니다.
+ * @param db SQLite 데이터베이스 참조 (쓰기 가능)
+ * @return 적용 후 스키마 버전
+ */
+int run_schema_migrations(SQLite::Database& db)
+{
+    // 새 단계는 끝에만 추가하고 SCHEMA_VERSION을 함께 올림 (이미 배포된 단계는 수정하지 않음)
+    static const vector<SchemaMigration> migrations = {
+        {1, "기본 테이블 생성", create_base_tables},
+        {2, "detections.ts_ms 추가", migrate_detections_timestamp_ms},
+        {3, "detections 이벤트 메타데이터/커버링 인덱스", migrate_detections_event_metadata},
+        {4, "시간별 감지 집계 테이블/트리거", create_detection_rollups},
+        {5, "설정 변경 버전 테이블/트리거", create_config_version},
+    };
+
+    int version = db.execAndGet("PRAGMA user_version").getInt();
+    if (version > SCHEMA_VERSION)
+    {
+        cerr << "[Migration] DB 스키마 버전(" << version << ")이 코드가 아는 버전(" << SCHEMA_VERSION
+             << ")보다 높습니다. 마이그레이션을 건너뜁니다." << endl;
+        return version;
+    }
+
+    for (const auto& migration : migrations)
+    {
+        if (migration.version <= version)
+        {
+            continue;
+        }
+
+        // 다른 프로세스가 먼저 같은 단계를 적용했을 수 있으므로 쓰기 잠금을 잡은 뒤 버전을 다시 확인
+        db.exec("BEGIN IMMEDIATE");
+        try
+        {
+            version = db.execAndGet("PRAGMA user_version").getInt();
+            if (migration.version > version)
+            {
+                cout << "[Migration] 스키마 v" << migration.version << " 적용: " << migration.description << endl;
+                migration.apply(db);
+                db.exec("PRAGMA user_version = " + to_string(migration.version));
+                version = migration.version;
+            }
+            db.exec("COMMIT");
+        }
+        catch (...)
+        {
+            db.exec("ROLLBACK");
+            throw;
+        }
+    }
+
+    cout << "[DB] 스키마 버전 " << version << endl;
+    return version;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file db_schema.hpp
+ * @brief DB 스키마 마이그레이션 헤더 파일
+ * @details server와 control 프로세스가 시작 시 한 번 실행하는 버전 기반(PRAGMA user_version) 스키마 마이그레이션을
+ *          선언합니다. SQLiteCpp 외의 의존성이 없어 control 실행 파일에도 링크할 수 있습니다.
+ */
+
+#pragma once
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 테이블에 특정 컬럼이 존재하는지 확인합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param table 테이블 이름
+ * @param column 컬럼 이름
+ * @return 존재하면 true
+ */
+bool column_exists(SQLite::Database& db, const std::string& table, const std::string& column);
+
+/**
+ * @brief 현재 코드가 기대하는 스키마 버전 (PRAGMA user_version)
+ */
+constexpr int SCHEMA_VERSION = 5;
+
+/**
+ * @brief PRAGMA user_version을 기준으로 아직 적용되지 않은 마이그레이션을 순서대로 적용합니다.
+ * @details 마이그레이션은 다음 순서로 정의되며, 각 단계는 user_version 갱신과 함께 하나의 IMMEDIATE 트랜잭션으로
+ *          실행되므로 server와 control이 동시에 시작해도 같은 단계를 두 번 적용하지 않습니다.
+ *          1) 기본 테이블 생성, 2) detections.ts_ms 추가 및 변환, 3) 이벤트 메타데이터 컬럼과 커버링 인덱스,
+ *          4) 시간별 집계 테이블과 트리거, 5) 설정 테이블 변경 버전(config_version)과 트리거.
+ *          user_version이 없던(0) 기존 DB도 각 단계가 현재 상태를 확인하므로 안전하게 최신 버전으로 올라갑니다.
+ *          프로세스 시작 시 쓰기 연결에서 한 번만 호출합니다.
+ * @param db SQLite 데이터베이스 참조 (쓰기 가능)
+ * @return 적용 후 스키마 버전
+ * @throws SQLite::Exception 마이그레이션 실패 시 (실패한 단계는 롤백됨)
+ */
+int run_schema_migrations(SQLite::Database& db);
+
+/**
+ * @brief 설정 테이블(lines, baseLines, verticalLineEquations)의 변경 버전을 조회합니다.
+ * @details 세 테이블에 INSERT/UPDATE/DELETE가 일어날 때마다 트리거가 1씩 올리므로, 값이 바뀌었을 때만 설정을 다시
+ *          읽으면 됩니다.
+ * @param db SQLite 데이터베이스 참조
+ * @return 변경 버전
+ */
+int64_t select_config_version(SQLite::Database& db);
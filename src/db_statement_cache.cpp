@@ -0,0 +1,160 @@
+/**
+ * @file db_statement_cache.cpp
+ * @brief SQLite Prepared Statement 캐시 구현 파일
+ * @details 연결별 Statement 캐시 레지스트리와 SQL 디버그 로그를 구현합니다.
+ */
+
+#include "db_statement_cache.hpp"
+
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @brief SQL 디버그 로그(바인딩된 값이 포함된 SQL) 출력 여부
+ */
+atomic<bool> g_sql_logging(false);
+
+/**
+ * @brief 연결 하나에 캐시할 수 있는 최대 Statement 수 (동적 SQL이 무한히 쌓이지 않도록 제한)
+ */
+static const size_t MAX_STATEMENTS_PER_CONNECTION = 64;
+
+/**
+ * @brief 캐시된 Statement와 사용 중 여부
+ */
+struct CacheEntry
+{
+    unique_ptr<SQLite::Statement> statement;
+    bool in_use = false;
+};
+
+/**
+ * @brief 연결(sqlite3 핸들) → (SQL → CacheEntry) 레지스트리와 보호용 뮤텍스
+ * @details unordered_map의 노드는 rehash에도 이동하지 않으므로 빌려준 항목의 주소는 반납 전까지 유효합니다.
+ */
+static unordered_map<sqlite3*, unordered_map<string, CacheEntry>> statement_registry;
+static mutex registry_mutex;
+
+/**
+ * @brief 캐시 적중/미적중 횟수
+ */
+static atomic<long long> cache_hits(0);
+static atomic<long long> cache_misses(0);
+
+/**
+ * @brief 캐시에서 Statement를 빌리거나, 없으면 컴파일하여 캐시에 추가합니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param sql SQL 문자열 (캐시 키)
+ */
+CachedStatement::CachedStatement(SQLite::Database& db, const string& sql)
+{
+    CacheEntry* entry = nullptr;
+    {
+        lock_guard<mutex> lock(registry_mutex);
+        auto& statements = statement_registry[db.getHandle()];
+        auto it = statements.find(sql);
+        if (it != statements.end())
+        {
+            if (!it->second.in_use)
+            {
+                entry = &it->second;
+                entry->in_use = true;
+            }
+        }
+        else if (statements.size() < MAX_STATEMENTS_PER_CONNECTION)
+        {
+            entry = &statements[sql];
+            entry->in_use = true;
+        }
+    }
+
+    if (entry == nullptr)
+    {
+        // 같은 SQL이 이미 사용 중이거나 캐시가 가득 찬 경우
+        cache_misses++;
+        uncached = make_unique<SQLite::Statement>(db, sql);
+        statement = uncached.get();
+        return;
+    }
+
+    if (!entry->statement)
+    {
+        cache_misses++;
+        try
+        {
+            entry->statement = make_unique<SQLite::Statement>(db, sql);
+        }
+        catch (...)
+        {
+            entry->in_use = false;
+            throw;
+        }
+    }
+    else
+    {
+        cache_hits++;
+        entry->statement->reset();
+        entry->statement->clearBindings();
+    }
+    statement = entry->statement.get();
+    in_use = &entry->in_use;
+}
+
+/**
+ * @brief Statement를 reset하고 캐시에 반납합니다.
+ */
+CachedStatement::~CachedStatement()
+{
+    if (in_use == nullptr)
+    {
+        return;
+    }
+    try
+    {
+        statement->reset();
+    }
+    catch (...)
+    {
+        // reset은 마지막 실행의 오류 코드를 다시 보고할 수 있으며, 다음 사용 전 reset에서 정리됨
+    }
+    lock_guard<mutex> lock(registry_mutex);
+    *in_use = false;
+}
+
+/**
+ * @brief 연결에 대해 캐시된 Statement를 모두 finalize합니다.
+ * @param db SQLite 데이터베이스 참조
+ */
+void release_statement_cache(SQLite::Database& db)
+{
+    lock_guard<mutex> lock(registry_mutex);
+    statement_registry.erase(db.getHandle());
+}
+
+/**
+ * @brief 전체 캐시 적중/미적중 횟수를 반환합니다.
+ * @param hits 캐시 적중 횟수 (출력)
+ * @param misses 캐시 미적중(새로 컴파일) 횟수 (출력)
+ */
+void statement_cache_counters(long long& hits, long long& misses)
+{
+    hits = cache_hits.load();
+    misses = cache_misses.load();
+}
+
+/**
+ * @brief SQL 로그가 켜져 있으면 바인딩된 값이 포함된 SQL을 출력합니다.
+ * @details getExpandedSQL()은 매번 SQL 문자열을 새로 만들므로 로그가 꺼져 있으면 호출하지 않습니다.
+ * @param label 로그 구분용 이름
+ * @param query 출력할 Statement
+ */
+void log_sql(const char* label, SQLite::Statement& query)
+{
+    if (g_sql_logging.load(memory_order_relaxed))
+    {
+        cout << "Prepared SQL for " << label << ": " << query.getExpandedSQL() << endl;
+    }
+}
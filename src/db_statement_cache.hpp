@@ -0,0 +1,89 @@
+/**
+ * @file db_statement_cache.hpp
+ * @brief SQLite Prepared Statement 캐시 헤더 파일
+ * @details 연결(sqlite3 핸들)마다 SQL 문자열을 키로 컴파일된 Statement를 보관하여, 같은 쿼리를 다시 실행할 때
+ *          SQL 파싱과 실행 계획 수립을 생략합니다.
+ */
+
+#pragma once
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+/**
+ * @brief SQL 디버그 로그(바인딩된 값이 포함된 SQL) 출력 여부
+ */
+extern std::atomic<bool> g_sql_logging;
+
+/**
+ * @class CachedStatement
+ * @brief 연결별 캐시에서 빌려 쓰는 Prepared Statement
+ * @details 생성 시 캐시에서 Statement를 꺼내 reset/clearBindings 후 돌려주고, 소멸 시 다시 reset하여 읽기
+ *          트랜잭션이 열린 채로 남지 않게 합니다. 같은 연결에서 같은 SQL이 이미 사용 중이면 캐시하지 않은 임시
+ *          Statement를 사용합니다. 하나의 연결은 한 번에 한 스레드만 사용해야 합니다.
+ */
+class CachedStatement
+{
+public:
+    /**
+     * @brief 캐시에서 Statement를 빌리거나, 없으면 컴파일하여 캐시에 추가합니다.
+     * @param db SQLite 데이터베이스 참조
+     * @param sql SQL 문자열 (캐시 키)
+     */
+    CachedStatement(SQLite::Database& db, const std::string& sql);
+
+    /**
+     * @brief Statement를 reset하고 캐시에 반납합니다.
+     */
+    ~CachedStatement();
+
+    CachedStatement(const CachedStatement&) = delete;
+    CachedStatement& operator=(const CachedStatement&) = delete;
+
+    /**
+     * @brief 빌린 Statement에 접근합니다.
+     * @return SQLite::Statement 참조
+     */
+    SQLite::Statement& operator*() { return *statement; }
+    SQLite::Statement* operator->() { return statement; }
+
+private:
+    /**
+     * @brief 사용 중인 Statement (캐시 항목 또는 임시 Statement)
+     */
+    SQLite::Statement* statement = nullptr;
+
+    /**
+     * @brief 캐시 항목의 사용 중 플래그 (임시 Statement면 nullptr)
+     */
+    bool* in_use = nullptr;
+
+    /**
+     * @brief 캐시에 넣지 않은 임시 Statement
+     */
+    std::unique_ptr<SQLite::Statement> uncached;
+};
+
+/**
+ * @brief 연결에 대해 캐시된 Statement를 모두 finalize합니다.
+ * @details 연결을 닫기 전에 반드시 호출해야 합니다. (닫힌 핸들 주소가 재사용되면 잘못된 Statement를 꺼내게 됨)
+ * @param db SQLite 데이터베이스 참조
+ */
+void release_statement_cache(SQLite::Database& db);
+
+/**
+ * @brief 전체 캐시 적중/미적중 횟수를 반환합니다.
+ * @param hits 캐시 적중 횟수 (출력)
+ * @param misses 캐시 미적중(새로 컴파일) 횟수 (출력)
+ */
+void statement_cache_counters(long long& hits, long long& misses);
+
+/**
+ * @brief SQL 로그가 켜져 있으면 바인딩된 값이 포함된 SQL을 출력합니다.
+ * @param label 로그 구분용 이름
+ * @param query 출력할 Statement
+ */
+void log_sql(const char* label, SQLite::Statement& query);
@@ -0,0 +1,378 @@
+/**
+ * @file line_config_store.cpp
+ * @brief 감지선/기준선/수직선 설정 메모리 저장소 구현 파일
+ * @details DB write-through 변경과 스냅샷 교체를 구현합니다.
+ */
+
+#include "line_config_store.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+/**
+ * @brief server 전역 설정 저장소 인스턴스
+ */
+LineConfigStore g_line_config;
+
+/**
+ * @brief 감지선을 name 순으로 정렬합니다.
+ * @param lines 감지선 목록
+ */
+static void sort_lines(vector<CrossLine>& lines)
+{
+    sort(lines.begin(), lines.end(), [](const CrossLine& a, const CrossLine& b) { return a.name < b.name; });
+}
+
+/**
+ * @brief 두 감지선의 내용이 같은지 비교합니다.
+ * @param a 감지선
+ * @param b 감지선
+ * @return 모든 필드가 같으면 true
+ */
+static bool same_line(const CrossLine& a, const CrossLine& b)
+{
+    return a.index == b.index && a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2 && a.name == b.name &&
+           a.mode == b.mode;
+}
+
+/**
+ * @brief DB에서 세 테이블을 읽어 스냅샷에 채웁니다.
+ * @param db SQLite 데이터베이스 참조
+ * @param snapshot 채울 스냅샷 (실패 시 일부만 채워질 수 있으므로 공개하지 않을 임시 스냅샷을 넘김)
+ * @throws SQLite::Exception 조회 실패 시
+ */
+static void read_all(SQLite::Database& db, LineConfigSnapshot& snapshot)
+{
+    snapshot.lines = select_all_data_lines(db);
+    snapshot.baseLines = select_all_data_baseLines(db);
+    snapshot.verticalLineEquations = select_all_data_verticalLineEquations(db);
+}
+
+/**
+ * @brief DB에서 세 테이블을 읽어 첫 스냅샷을 공개합니다.
+ * @details 조회에 실패하면 빈 스냅샷을 공개하지 않고 이전 스냅샷을 그대로 둡니다.
+ * @param db_pool DB 연결 풀
+ * @return 성공 시 true, 실패 시 false
+ */
+bool LineConfigStore::load(DatabasePool& db_pool)
+{
+    lock_guard<mutex> lock(write_mutex);
+    this->db_pool = &db_pool;
+
+    auto next = make_shared<LineConfigSnapshot>();
+    try
+    {
+        db_pool.read([&](SQLite::Database& db) { read_all(db, *next); });
+    }
+    catch (const exception& e)
+    {
+        cerr << "[LineConfig] 설정 로드 실패: " << e.what() << endl;
+        return false;
+    }
+
+    publish(next);
+    cout << "[LineConfig] 설정 로드 완료 (감지선 " << next->lines.size() << "개, 기준선 " << next->baseLines.size()
+         << "개, 수직선 " << next->verticalLineEquations.size() << "개)" << endl;
+    return true;
+}
+
+/**
+ * @brief 현재 스냅샷을 반환합니다. (잠금 없음)
+ * @return 불변 스냅샷 포인터
+ */
+shared_ptr<const LineConfigSnapshot> LineConfigStore::snapshot() const
+{
+    return atomic_load(&current);
+}
+
+/**
+ * @brief 감지선을 추가합니다.
+ * @param line 추가할 감지선
+ * @return 성공 시 true
+ */
+bool LineConfigStore::insert_line(const CrossLine& line)
+{
+    lock_guard<mutex> lock(write_mutex);
+    bool success = db_pool->write([&](SQLite::Database& db) { return insert_data_lines(db, line); });
+    if (success)
+    {
+        auto next = copy_current();
+        next->lines.push_back(line);
+        sort_lines(next->lines);
+        publish(next);
+    }
+    return success;
+}
+
+/**
+ * @brief 여러 감지선을 하나의 트랜잭션으로 추가합니다.
+ * @param lines 추가할 감지선 목록
+ * @return 모두 성공 시 true (하나라도 실패하면 DB와 스냅샷 모두 변경되지 않음)
+ */
+bool LineConfigStore::insert_lines(const vector<CrossLine>& lines)
+{
+    lock_guard<mutex> lock(write_mutex);
+    if (lines.empty())
+    {
+        return true;
+    }
+
+    bool success = db_pool->write(
+        [&](SQLite::Database& db)
+        {
+            SQLite::Transaction transaction(db);
+            for (const auto& line : lines)
+            {
+                if (!insert_data_lines(db, line))
+                {
+                    return false;
+                }
+            }
+            transaction.commit();
+            return true;
+        });
+    if (!success)
+    {
+        cerr << "[LineConfig] 감지선 일괄 추가 실패, 롤백했습니다." << endl;
+        return false;
+    }
+
+    auto next = copy_current();
+    next->lines.insert(next->lines.end(), lines.begin(), lines.end());
+    sort_lines(next->lines);
+    publish(next);
+    return true;
+}
+
+/**
+ * @brief 감지선 전체를 주어진 목록으로 교체합니다.
+ * @details 현재 스냅샷과 indexNum 기준으로 비교하여 사라진 행은 삭제하고, 새로 생기거나 내용이 바뀐 행만
+ *          (삭제 후) 삽입합니다. 모든 변경은 하나의 트랜잭션(커밋 1회)으로 실행되며, 하나라도 실패하면 전체를
+ *          롤백하고 스냅샷도 그대로 둡니다. 바뀐 행이 없으면 DB에 쓰지 않습니다.
+ *          스냅샷과 DB가 어긋나 있어도 동기화가 실패하지 않도록, 이미 없는 행의 삭제(0행 변경)는 성공으로 보고
+ *          새로 삽입할 indexNum의 행도 먼저 지웁니다.
+ * @param lines 새 감지선 목록
+ * @return 성공 시 true
+ */
+bool LineConfigStore::replace_lines(const vector<CrossLine>& lines)
+{
+    lock_guard<mutex> lock(write_mutex);
+    auto base = atomic_load(&current);
+
+    unordered_map<int, const CrossLine*> existing;
+    for (const auto& line : base->lines)
+    {
+        existing.emplace(line.index, &line);
+    }
+
+    unordered_set<int> kept;
+    vector<int> removed;
+    vector<CrossLine> added;
+    for (const auto& line : lines)
+    {
+        kept.insert(line.index);
+        auto it = existing.find(line.index);
+        if (it == existing.end())
+        {
+            added.push_back(line);
+        }
+        else if (!same_line(*it->second, line))
+        {
+            removed.push_back(line.index);
+            added.push_back(line);
+        }
+    }
+    for (const auto& line : base->lines)
+    {
+        if (kept.count(line.index) == 0)
+        {
+            removed.push_back(line.index);
+        }
+    }
+
+    if (removed.empty() && added.empty())
+    {
+        return true;
+    }
+
+    vector<int> delete_indexes = removed;
+    for (const auto& line : added)
+    {
+        if (existing.count(line.index) == 0)
+        {
+            delete_indexes.push_back(line.index);
+        }
+    }
+
+    bool success = db_pool->write(
+        [&](SQLite::Database& db)
+        {
+            // 삭제를 먼저 실행해야 이름(UNIQUE)을 물려받는 행의 삽입이 충돌하지 않음
+            SQLite::Transaction transaction(db);
+            for (int index : delete_indexes)
+            {
+                if (!delete_data_lines(db, index, true))
+                {
+                    return false;
+                }
+            }
+            for (const auto& line : added)
+            {
+                if (!insert_data_lines(db, line))
+                {
+                    return false;
+                }
+            }
+            transaction.commit();
+            return true;
+        });
+    if (!success)
+    {
+        cerr << "[LineConfig] 감지선 동기화 실패, 롤백했습니다." << endl;
+        return false;
+    }
+
+    auto next = copy_current();
+    next->lines = lines;
+    sort_lines(next->lines);
+    publish(next);
+    cout << "[LineConfig] 감지선 동기화 (삭제 " << removed.size() << "개, 삽입 " << added.size() << "개)" << endl;
+    return true;
+}
+
+/**
+ * @brief 기준선을 추가하고, 이미 있으면 매트릭스 번호를 갱신합니다.
+ * @details insert_data_baseLines()는 indexNum이 이미 있으면 실패하고, update_data_baseLines()는 해당 indexNum의
+ *          matrixNum1/matrixNum2만 바꾸므로 메모리에도 같은 규칙을 적용합니다.
+ * @param baseLine 기준선
+ * @param insertSuccess 추가 성공 여부 (출력)
+ * @param updateSuccess 갱신 성공 여부 (출력)
+ */
+void LineConfigStore::upsert_baseline(const BaseLine& baseLine, bool& insertSuccess, bool& updateSuccess)
+{
+    lock_guard<mutex> lock(write_mutex);
+    db_pool->write(
+        [&](SQLite::Database& db)
+        {
+            SQLite::Transaction transaction(db);
+            insertSuccess = insert_data_baseLines(db, baseLine);
+            updateSuccess = update_data_baseLines(db, baseLine);
+            transaction.commit();
+        });
+    if (!insertSuccess && !updateSuccess)
+    {
+        return;
+    }
+
+    auto next = copy_current();
+    auto& baseLines = next->baseLines;
+    if (insertSuccess)
+    {
+        auto pos = lower_bound(baseLines.begin(), baseLines.end(), baseLine.index,
+                               [](const BaseLine& b, int index) { return b.index < index; });
+        baseLines.insert(pos, baseLine);
+    }
+    else
+    {
+        for (auto& existing : baseLines)
+        {
+            if (existing.index == baseLine.index)
+            {
+                existing.matrixNum1 = baseLine.matrixNum1;
+                existing.matrixNum2 = baseLine.matrixNum2;
+            }
+        }
+    }
+    publish(next);
+}
+
+/**
+ * @brief 수직선 방정식을 추가합니다.
+ * @param verticalLineEquation 추가할 수직선 방정식
+ * @return 성공 시 true
+ */
+bool LineConfigStore::insert_vertical_line(const VerticalLineEquation& verticalLineEquation)
+{
+    lock_guard<mutex> lock(write_mutex);
+    bool success = db_pool->write([&](SQLite::Database& db)
+                                  { return insert_data_verticalLineEquations(db, verticalLineEquation); });
+    if (success)
+    {
+        auto next = copy_current();
+        auto& equations = next->verticalLineEquations;
+        auto pos = lower_bound(equations.begin(), equations.end(), verticalLineEquation.index,
+                               [](const VerticalLineEquation& v, int index) { return v.index < index; });
+        equations.insert(pos, verticalLineEquation);
+        publish(next);
+    }
+    return success;
+}
+
+/**
+ * @brief 감지선, 기준선, 수직선을 모두 삭제합니다.
+ * @return 모두 성공 시 true
+ */
+bool LineConfigStore::clear_all()
+{
+    lock_guard<mutex> lock(write_mutex);
+    auto next = copy_current();
+    bool success = db_pool->write(
+        [&](SQLite::Database& db)
+        {
+            // 세 테이블 삭제를 한 번에 커밋하여 다른 연결이 일부만 지워진 상태를 보지 않도록 함
+            SQLite::Transaction transaction(db);
+            bool ok = delete_all_data_lines(db);
+            ok &= delete_all_data_baseLines(db);
+            ok &= delete_all_data_verticalLineEquations(db);
+            transaction.commit();
+            // 일부만 삭제된 경우 DB에 실제로 남은 상태를 다시 읽어 메모리와 맞춤 (재조회 실패 시 이전 스냅샷 유지)
+            if (!ok)
+            {
+                LineConfigSnapshot reloaded;
+                try
+                {
+                    read_all(db, reloaded);
+                    next->lines = std::move(reloaded.lines);
+                    next->baseLines = std::move(reloaded.baseLines);
+                    next->verticalLineEquations = std::move(reloaded.verticalLineEquations);
+                }
+                catch (const exception& e)
+                {
+                    cerr << "[LineConfig] 삭제 후 설정 재조회 실패, 이전 스냅샷 유지: " << e.what() << endl;
+                }
+            }
+            return ok;
+        });
+
+    if (success)
+    {
+        next->lines.clear();
+        next->baseLines.clear();
+        next->verticalLineEquations.clear();
+    }
+    publish(next);
+    return success;
+}
+
+/**
+ * @brief 새 스냅샷의 세대 번호를 매기고 원자적으로 교체합니다.
+ * @param next 공개할 스냅샷
+ */
+void LineConfigStore::publish(shared_ptr<LineConfigSnapshot> next)
+{
+    next->generation = atomic_load(&current)->generation + 1;
+    atomic_store(&current, shared_ptr<const LineConfigSnapshot>(std::move(next)));
+}
+
+/**
+ * @brief 현재 스냅샷의 수정 가능한 복사본을 만듭니다.
+ * @return 복사본
+ */
+shared_ptr<LineConfigSnapshot> LineConfigStore::copy_current() const
+{
+    return make_shared<LineConfigSnapshot>(*atomic_load(&current));
+}
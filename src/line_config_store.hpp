@@ -0,0 +1,128 @@
+/**
+ * @file line_config_store.hpp
+ * @brief 감지선/기준선/수직선 설정 메모리 저장소 헤더 파일
+ * @details lines, baseLines, verticalLineEquations 테이블을 시작 시 한 번 메모리로 읽어 두고, 변경은 DB에 먼저 기록한 뒤
+ *          (write-through) 새 불변 스냅샷을 원자적으로 교체하여 공개합니다. 조회 요청은 DB 연결이나 잠금 없이 현재
+ *          스냅샷만 읽습니다. 세 테이블은 server만 수정하므로 server의 메모리 모델이 기준(authoritative)이 됩니다.
+ */
+
+#pragma once
+
+#include "db_management.hpp"
+#include "db_pool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 특정 시점의 감지선/기준선/수직선 설정 (공개 후에는 수정하지 않음)
+ */
+struct LineConfigSnapshot
+{
+    std::vector<CrossLine> lines;                            ///< 감지선 (name 순, SELECT ... ORDER BY name과 동일)
+    std::vector<BaseLine> baseLines;                         ///< 기준선 (indexNum 순)
+    std::vector<VerticalLineEquation> verticalLineEquations; ///< 수직선 방정식 (indexNum 순)
+    uint64_t generation = 0;                                 ///< 공개될 때마다 1씩 증가하는 세대 번호
+};
+
+/**
+ * @class LineConfigStore
+ * @brief 설정 테이블의 write-through 메모리 저장소
+ * @details 변경 함수는 쓰기 뮤텍스 안에서 현재 스냅샷을 복사하고, DB 쓰기 큐에서 기존 insert/delete 함수를 실행한 뒤
+ *          DB 결과와 같은 변경을 복사본에 적용하여 교체합니다. DB 쓰기가 실패하면 스냅샷은 바뀌지 않습니다.
+ */
+class LineConfigStore
+{
+public:
+    /**
+     * @brief DB에서 세 테이블을 읽어 첫 스냅샷을 공개합니다. (실패 시 이전 스냅샷 유지)
+     * @param db_pool DB 연결 풀 (저장소를 사용하는 동안 유효해야 함)
+     * @return 성공 시 true, 실패 시 false
+     */
+    bool load(DatabasePool& db_pool);
+
+    /**
+     * @brief 현재 스냅샷을 반환합니다. (잠금 없음)
+     * @return 불변 스냅샷 포인터 (load 전이면 빈 스냅샷)
+     */
+    std::shared_ptr<const LineConfigSnapshot> snapshot() const;
+
+    /**
+     * @brief 감지선을 추가합니다.
+     * @param line 추가할 감지선
+     * @return 성공 시 true (indexNum/name 중복 등으로 실패하면 false)
+     */
+    bool insert_line(const CrossLine& line);
+
+    /**
+     * @brief 여러 감지선을 하나의 트랜잭션으로 추가합니다.
+     * @details 하나라도 실패하면 전체를 롤백하고 스냅샷도 그대로 둡니다.
+     * @param lines 추가할 감지선 목록
+     * @return 모두 성공 시 true
+     */
+    bool insert_lines(const std::vector<CrossLine>& lines);
+
+    /**
+     * @brief 감지선 전체를 주어진 목록으로 교체합니다.
+     * @details 바뀐 행만 하나의 트랜잭션으로 반영합니다. 실패하면 DB와 스냅샷 모두 변경되지 않습니다.
+     * @param lines 새 감지선 목록
+     * @return 성공 시 true
+     */
+    bool replace_lines(const std::vector<CrossLine>& lines);
+
+    /**
+     * @brief 기준선을 추가하고, 이미 있으면 매트릭스 번호를 갱신합니다.
+     * @param baseLine 기준선
+     * @param insertSuccess 추가 성공 여부 (출력)
+     * @param updateSuccess 갱신 성공 여부 (출력)
+     */
+    void upsert_baseline(const BaseLine& baseLine, bool& insertSuccess, bool& updateSuccess);
+
+    /**
+     * @brief 수직선 방정식을 추가합니다.
+     * @param verticalLineEquation 추가할 수직선 방정식
+     * @return 성공 시 true
+     */
+    bool insert_vertical_line(const VerticalLineEquation& verticalLineEquation);
+
+    /**
+     * @brief 감지선, 기준선, 수직선을 모두 삭제합니다.
+     * @return 모두 성공 시 true
+     */
+    bool clear_all();
+
+private:
+    /**
+     * @brief 새 스냅샷의 세대 번호를 매기고 원자적으로 교체합니다. (write_mutex 보유 상태에서 호출)
+     * @param next 공개할 스냅샷
+     */
+    void publish(std::shared_ptr<LineConfigSnapshot> next);
+
+    /**
+     * @brief 현재 스냅샷의 수정 가능한 복사본을 만듭니다.
+     * @return 복사본
+     */
+    std::shared_ptr<LineConfigSnapshot> copy_current() const;
+
+    /**
+     * @brief DB 연결 풀
+     */
+    DatabasePool* db_pool = nullptr;
+
+    /**
+     * @brief 현재 공개된 스냅샷 (std::atomic_load/atomic_store로만 접근)
+     */
+    std::shared_ptr<const LineConfigSnapshot> current = std::make_shared<const LineConfigSnapshot>();
+
+    /**
+     * @brief 변경 작업 직렬화용 뮤텍스 (조회는 사용하지 않음)
+     */
+    std::mutex write_mutex;
+};
+
+/**
+ * @brief server 전역 설정 저장소 인스턴스
+ */
+extern LineConfigStore g_line_config;
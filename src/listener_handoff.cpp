@@ -0,0 +1,458 @@
+/**
+ * @file listener_handoff.cpp
+ * @brief 무중단 재시작용 리스닝 소켓 인계 구현 파일
+ * @details SCM_RIGHTS 송수신, 이전 서버에서 소켓 넘겨받기, 다음 서버에 소켓 넘겨주기(확인 대기 포함)를 구현합니다.
+ *          메시지는 JSON 머리글 한 줄({"pid", "tcp", "local", "rtsp"})과 그 순서대로 붙인 소켓 디스크립터입니다.
+ */
+
+#include "listener_handoff.hpp"
+
+#include "json.hpp"
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * @brief 서버 전역 리스닝 소켓 인계 인스턴스
+ */
+ListenerHandoff g_listener_handoff;
+
+/**
+ * @brief 한 번에 넘길 수 있는 최대 소켓 수 (커널의 SCM_MAX_FD)
+ */
+static const size_t MAX_HANDOFF_FDS = 253;
+
+/**
+ * @brief 인계 완료 확인 바이트
+ */
+static const char HANDOFF_ACK = 'A';
+
+/**
+ * @brief 인계 소켓 주소를 만듭니다.
+ * @param path 소켓 파일 경로
+ * @param address 주소 (출력)
+ * @return 경로가 유효하면 true
+ */
+static bool make_address(const string& path, sockaddr_un& address)
+{
+    address = sockaddr_un{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        cerr << "[Handoff] 인계 소켓 경로가 비었거나 너무 깁니다: " << path << endl;
+        return false;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return true;
+}
+
+/**
+ * @brief 머리글과 소켓 디스크립터를 한 메시지로 보냅니다. (SCM_RIGHTS)
+ * @param socket 인계 연결
+ * @param header 머리글
+ * @param fds 보낼 디스크립터 (받는 프로세스에 복제되며, 보내는 쪽의 디스크립터는 그대로 남음)
+ * @return 성공 시 true
+ */
+static bool send_with_fds(int socket, const string& header, const vector<int>& fds)
+{
+    iovec iov{const_cast<char*>(header.data()), header.size()};
+    vector<char> control(CMSG_SPACE(sizeof(int) * max<size_t>(1, fds.size())));
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    if (!fds.empty())
+    {
+        message.msg_control = control.data();
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+    }
+    ssize_t sent;
+    do
+    {
+        sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    return sent == static_cast<ssize_t>(header.size());
+}
+
+/**
+ * @brief 디스크립터 목록을 모두 닫습니다.
+ * @param fds 디스크립터 목록
+ */
+static void close_all(const vector<int>& fds)
+{
+    for (int fd : fds)
+    {
+        close(fd);
+    }
+}
+
+/**
+ * @brief 소멸자. 인계 스레드를 중지함
+ */
+ListenerHandoff::~ListenerHandoff()
+{
+    stop(false);
+}
+
+/**
+ * @brief 이전 서버에서 리스닝 소켓을 넘겨받습니다.
+ * @param path 인계 소켓 파일 경로
+ * @return 소켓을 넘겨받았으면 true
+ */
+bool ListenerHandoff::inherit(const string& path)
+{
+    sockaddr_un address;
+    if (!make_address(path, address))
+    {
+        return false;
+    }
+    int predecessor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (predecessor < 0)
+    {
+        return false;
+    }
+    // 응답하는 서버가 없으면 처음 시작하는 것으로 보고 각 리스너가 소켓을 새로 엶
+    if (connect(predecessor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        close(predecessor);
+        return false;
+    }
+
+    timeval timeout{10, 0};
+    setsockopt(predecessor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char buffer[1024];
+    iovec iov{buffer, sizeof(buffer)};
+    vector<char> control(CMSG_SPACE(sizeof(int) * MAX_HANDOFF_FDS));
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    ssize_t received;
+    do
+    {
+        received = recvmsg(predecessor, &message, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+
+    vector<int> fds;
+    if (received > 0)
+    {
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                const int* data = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+                fds.insert(fds.end(), data, data + count);
+            }
+        }
+    }
+
+    json header = received > 0 ? json::parse(buffer, buffer + received, nullptr, false) : json();
+    size_t tcp = header.is_object() ? header.value("tcp", static_cast<size_t>(0)) : 0;
+    bool local = header.is_object() && header.value("local", false);
+    bool rtsp = header.is_object() && header.value("rtsp", false);
+    if (!header.is_object() || (message.msg_flags & MSG_CTRUNC) || fds.size() != tcp + local + rtsp)
+    {
+        cerr << "[Handoff] 이전 서버의 인계 메시지가 올바르지 않아 리스닝 소켓을 새로 엽니다." << endl;
+        close_all(fds);
+        close(predecessor);
+        return false;
+    }
+
+    lock_guard<std::mutex> lock(mutex);
+    inherited.tcp_fds.assign(fds.begin(), fds.begin() + tcp);
+    inherited.local_fd = local ? fds[tcp] : -1;
+    inherited.rtsp_fd = rtsp ? fds.back() : -1;
+    predecessor_fd = predecessor;
+    cout << "[Handoff] 이전 서버(pid=" << header.value("pid", 0) << ")에게서 리스닝 소켓을 넘겨받았습니다. (TCP " << tcp
+         << "개" << (local ? ", 로컬" : "") << (rtsp ? ", RTSP" : "") << ")" << endl;
+    return true;
+}
+
+/**
+ * @brief 넘겨받은 TCP 리스닝 소켓을 가져갑니다.
+ * @return 소켓 목록
+ */
+vector<int> ListenerHandoff::take_tcp()
+{
+    lock_guard<std::mutex> lock(mutex);
+    vector<int> fds;
+    fds.swap(inherited.tcp_fds);
+    return fds;
+}
+
+/**
+ * @brief 넘겨받은 로컬 Unix 리스닝 소켓을 가져갑니다.
+ * @return 소켓 (없으면 -1)
+ */
+int ListenerHandoff::take_local()
+{
+    lock_guard<std::mutex> lock(mutex);
+    int fd = inherited.local_fd;
+    inherited.local_fd = -1;
+    return fd;
+}
+
+/**
+ * @brief 넘겨받은 RTSP 리스닝 소켓을 가져갑니다.
+ * @return 소켓 (없으면 -1)
+ */
+int ListenerHandoff::take_rtsp()
+{
+    lock_guard<std::mutex> lock(mutex);
+    int fd = inherited.rtsp_fd;
+    inherited.rtsp_fd = -1;
+    return fd;
+}
+
+/**
+ * @brief 다음 서버에 넘길 RTSP 리스닝 소켓을 등록합니다.
+ * @param fd RTSP 리스닝 소켓
+ */
+void ListenerHandoff::set_rtsp_listener(int fd)
+{
+    lock_guard<std::mutex> lock(mutex);
+    rtsp_fd = fd;
+}
+
+/**
+ * @brief 이전 서버에 인계 완료를 알리고, 다음 서버의 인계 요청을 받는 스레드를 시작합니다.
+ * @param path 인계 소켓 파일 경로
+ * @param ack_timeout_sec 다음 서버가 준비를 마칠 때까지 기다리는 최대 시간(초)
+ * @param collect 인계할 TCP/로컬 리스닝 소켓을 모으는 콜백
+ * @param on_handed_off 다음 서버가 리스너를 모두 시작했을 때 호출되는 콜백
+ * @return 인계 소켓을 열었으면 true
+ */
+bool ListenerHandoff::serve(const string& path, int ack_timeout_sec, ListenerCollectCallback collect,
+                            function<void()> on_handed_off)
+{
+    if (running.load())
+    {
+        return true;
+    }
+
+    // 이전 서버는 이 확인을 받은 뒤에 수락을 멈추고 연결을 정리함
+    {
+        lock_guard<std::mutex> lock(mutex);
+        if (predecessor_fd >= 0)
+        {
+            if (send(predecessor_fd, &HANDOFF_ACK, 1, MSG_NOSIGNAL) == 1)
+            {
+                cout << "[Handoff] 이전 서버에 인계 완료를 알렸습니다." << endl;
+            }
+            close(predecessor_fd);
+            predecessor_fd = -1;
+        }
+    }
+
+    sockaddr_un address;
+    if (!make_address(path, address))
+    {
+        return false;
+    }
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+    {
+        cerr << "[Handoff] 소켓 생성 실패: " << strerror(errno) << endl;
+        return false;
+    }
+
+    // inherit()에서 응답이 없었거나 이미 인계를 마친 이전 서버의 파일이므로 지우고 새로 만듦 (소유자만 접속 가능)
+    // 프로세스 전체의 umask를 바꾸지 않도록 bind 전에 소켓 inode 권한을 소유자 전용으로 좁힘 (local_listener와 동일)
+    unlink(path.c_str());
+    if (fchmod(listen_fd, S_IRUSR | S_IWUSR) < 0 ||
+        ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        chmod(path.c_str(), S_IRUSR | S_IWUSR) < 0 || listen(listen_fd, 4) < 0)
+    {
+        cerr << "[Handoff] 인계 소켓 " << path << " 준비 실패: " << strerror(errno) << endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    this->path = path;
+    this->ack_timeout_sec = max(1, ack_timeout_sec);
+    this->collect = std::move(collect);
+    this->on_handed_off = std::move(on_handed_off);
+    running = true;
+    serve_thread = thread(&ListenerHandoff::serve_loop, this);
+    cout << "[Handoff] 리스닝 소켓 인계 대기 (" << path << ")" << endl;
+    return true;
+}
+
+/**
+ * @brief 인계 스레드를 중지하고, 가져가지 않은 넘겨받은 소켓과 확인 전의 이전 서버 연결을 닫습니다.
+ * @param unlink_path 인계 소켓 파일을 지울지 여부
+ */
+void ListenerHandoff::stop(bool unlink_path)
+{
+    if (listen_fd >= 0)
+    {
+        running = false;
+        // 리스닝 소켓을 shutdown하면 accept에서, 인계 연결을 shutdown하면 확인 대기에서 스레드가 깨어남
+        shutdown(listen_fd, SHUT_RDWR);
+        {
+            lock_guard<std::mutex> lock(mutex);
+            if (client_fd >= 0)
+            {
+                shutdown(client_fd, SHUT_RDWR);
+            }
+        }
+        if (serve_thread.joinable())
+        {
+            serve_thread.join();
+        }
+        close(listen_fd);
+        listen_fd = -1;
+        if (unlink_path)
+        {
+            unlink(path.c_str());
+        }
+    }
+    // 가져가지 않은 넘겨받은 소켓은 닫고, 확인을 보내기 전이면 이전 서버와의 연결도 닫아 이전 서버가 바로 계속
+    // 서비스하도록 함
+    lock_guard<std::mutex> lock(mutex);
+    close_all(inherited.tcp_fds);
+    inherited.tcp_fds.clear();
+    for (int* fd : {&inherited.local_fd, &inherited.rtsp_fd, &predecessor_fd})
+    {
+        if (*fd >= 0)
+        {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+/**
+ * @brief 인계 스레드 본체. 요청마다 소켓을 보내고 확인을 기다림
+ */
+void ListenerHandoff::serve_loop()
+{
+    while (running.load())
+    {
+        int client = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (running.load())
+            {
+                cerr << "[Handoff] 인계 요청 수락 실패: " << strerror(errno) << endl;
+            }
+            break;
+        }
+        {
+            lock_guard<std::mutex> lock(mutex);
+            client_fd = client;
+        }
+        bool handed_off = hand_off(client);
+        {
+            lock_guard<std::mutex> lock(mutex);
+            client_fd = -1;
+            close(client);
+        }
+        if (handed_off)
+        {
+            on_handed_off();
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 요청한 프로세스 하나에 리스닝 소켓을 보내고 확인을 기다립니다.
+ * @details 확인 전에 연결이 끊기거나 시간이 지나면 새 서버가 시작에 실패한 것으로 보고 계속 서비스합니다. 시간이
+ *          지난 경우에는 새 서버가 넘겨받은 소켓으로 수락하고 있을 수 있으므로 SO_PEERCRED의 pid로 새 서버를 종료하여
+ *          리스닝 소켓을 다시 혼자 사용합니다.
+ * @param client 인계 요청 연결
+ * @return 다음 서버가 확인을 보냈으면 true
+ */
+bool ListenerHandoff::hand_off(int client)
+{
+    ucred peer{};
+    socklen_t peer_len = sizeof(peer);
+    if (getsockopt(client, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) < 0 || (peer.uid != 0 && peer.uid != geteuid()))
+    {
+        cerr << "[Handoff] 서버와 다른 사용자의 인계 요청을 거부합니다. (pid=" << peer.pid << ", uid=" << peer.uid << ")"
+             << endl;
+        return false;
+    }
+
+    ListenerSockets sockets = collect();
+    {
+        lock_guard<std::mutex> lock(mutex);
+        sockets.rtsp_fd = rtsp_fd;
+    }
+    vector<int> fds = sockets.tcp_fds;
+    if (sockets.local_fd >= 0)
+    {
+        fds.push_back(sockets.local_fd);
+    }
+    if (sockets.rtsp_fd >= 0)
+    {
+        fds.push_back(sockets.rtsp_fd);
+    }
+    if (fds.size() > MAX_HANDOFF_FDS)
+    {
+        cerr << "[Handoff] 넘길 소켓이 너무 많습니다: " << fds.size() << endl;
+        return false;
+    }
+
+    json header;
+    header["pid"] = getpid();
+    header["tcp"] = sockets.tcp_fds.size();
+    header["local"] = sockets.local_fd >= 0;
+    header["rtsp"] = sockets.rtsp_fd >= 0;
+    if (!send_with_fds(client, header.dump(), fds))
+    {
+        cerr << "[Handoff] 리스닝 소켓 전송 실패: " << strerror(errno) << endl;
+        return false;
+    }
+    cout << "[Handoff] 새 서버(pid=" << peer.pid << ")에 리스닝 소켓 " << fds.size()
+         << "개를 보냈습니다. 준비 완료를 기다립니다..." << endl;
+
+    timeval timeout{ack_timeout_sec, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char ack = 0;
+    ssize_t received;
+    do
+    {
+        received = recv(client, &ack, 1, 0);
+    } while (received < 0 && errno == EINTR && running.load());
+    if (received == 1 && ack == HANDOFF_ACK)
+    {
+        cout << "[Handoff] 새 서버(pid=" << peer.pid << ")가 리스너를 시작했습니다. 연결 정리를 시작합니다." << endl;
+        return true;
+    }
+
+    // 확인 없이 시간이 지났으면 새 서버가 같은 리스닝 소켓으로 이미 수락하고 있을 수 있으므로, 두 서버가 함께
+    // 실행되지 않도록 새 서버를 종료함 (연결을 닫고 끝난 새 서버는 넘겨받은 소켓을 이미 닫았음)
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && peer.pid > 0)
+    {
+        cerr << "[Handoff] 새 서버(pid=" << peer.pid << ")가 " << ack_timeout_sec
+             << "초 안에 준비를 마치지 못해 종료합니다." << endl;
+        kill(peer.pid, SIGKILL);
+    }
+    cerr << "[Handoff] 새 서버가 준비를 마치지 못했습니다. 인계를 취소하고 계속 서비스합니다." << endl;
+    return false;
+}
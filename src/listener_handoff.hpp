@@ -0,0 +1,142 @@
+/**
+ * @file listener_handoff.hpp
+ * @brief 무중단 재시작용 리스닝 소켓 인계 헤더 파일
+ * @details 실행 중인 서버는 인계용 Unix 소켓(config.json의 restart.handoff_path)을 열어 둡니다. 새로 실행한 서버는
+ *          시작할 때 이 소켓에 연결하여 이전 서버의 리스닝 소켓(SO_REUSEPORT TCP 소켓들, 로컬 Unix 소켓, RTSP 소켓)을
+ *          SCM_RIGHTS로 넘겨받고, 모든 리스너를 시작한 뒤 확인 바이트를 보냅니다. 이전 서버는 확인을 받은 뒤에만 수락을
+ *          멈추고 연결을 정리(drain)하므로, 새 서버가 시작에 실패하면 이전 서버가 계속 서비스합니다.
+ *
+ *          리스닝 소켓 자체는 닫히지 않고 두 프로세스가 함께 가지므로, 인계 중 도착한 연결은 listen 백로그에 남았다가
+ *          새 서버가 수락합니다. (연결 거부나 재접속 폭주가 생기지 않음)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 프로세스 사이에 넘기는 리스닝 소켓 묶음 (없으면 -1)
+ */
+struct ListenerSockets
+{
+    std::vector<int> tcp_fds; ///< SO_REUSEPORT TCP 리스닝 소켓 (수락 스레드 순서)
+    int local_fd = -1;        ///< 로컬 Unix 소켓
+    int rtsp_fd = -1;         ///< RTSP 리스닝 소켓
+};
+
+/**
+ * @brief 인계할 TCP/로컬 리스닝 소켓을 모으는 콜백 (인계 스레드에서 호출, 소유권은 넘기지 않음)
+ */
+using ListenerCollectCallback = std::function<ListenerSockets()>;
+
+/**
+ * @class ListenerHandoff
+ * @brief 이전 서버에서 리스닝 소켓을 넘겨받고, 다음 서버에 넘겨주는 인계 지점
+ */
+class ListenerHandoff
+{
+public:
+    /**
+     * @brief 소멸자. 인계 스레드를 중지함
+     */
+    ~ListenerHandoff();
+
+    /**
+     * @brief 이전 서버에서 리스닝 소켓을 넘겨받습니다. (새 서버가 리스너를 열기 전에 한 번 호출)
+     * @details 인계 소켓에 응답하는 서버가 없으면 아무것도 받지 않고 false를 반환하며, 각 리스너는 소켓을 새로
+     *          엽니다. 이전 서버와의 연결은 serve()에서 확인 바이트를 보낼 때까지 유지합니다.
+     * @param path 인계 소켓 파일 경로
+     * @return 소켓을 넘겨받았으면 true
+     */
+    bool inherit(const std::string& path);
+
+    /**
+     * @brief 넘겨받은 TCP 리스닝 소켓을 가져갑니다. (소유권 이전, 없으면 빈 목록)
+     * @return 소켓 목록
+     */
+    std::vector<int> take_tcp();
+
+    /**
+     * @brief 넘겨받은 로컬 Unix 리스닝 소켓을 가져갑니다. (소유권 이전)
+     * @return 소켓 (없으면 -1)
+     */
+    int take_local();
+
+    /**
+     * @brief 넘겨받은 RTSP 리스닝 소켓을 가져갑니다. (소유권 이전)
+     * @return 소켓 (없으면 -1)
+     */
+    int take_rtsp();
+
+    /**
+     * @brief 다음 서버에 넘길 RTSP 리스닝 소켓을 등록합니다. (RTSP 서버가 소켓을 연 뒤 호출, 소유권은 넘기지 않음)
+     * @param fd RTSP 리스닝 소켓
+     */
+    void set_rtsp_listener(int fd);
+
+    /**
+     * @brief 이전 서버에 인계 완료를 알리고, 다음 서버의 인계 요청을 받는 스레드를 시작합니다.
+     * @details 모든 리스너를 시작한 뒤 호출합니다. 인계를 한 번 마치면 on_handed_off를 호출하고 스레드는 끝납니다.
+     * @param path 인계 소켓 파일 경로
+     * @param ack_timeout_sec 다음 서버가 준비를 마칠 때까지 기다리는 최대 시간(초)
+     * @param collect 인계할 TCP/로컬 리스닝 소켓을 모으는 콜백
+     * @param on_handed_off 다음 서버가 리스너를 모두 시작했을 때 호출되는 콜백 (인계 스레드에서 호출)
+     * @return 인계 소켓을 열었으면 true
+     */
+    bool serve(const std::string& path, int ack_timeout_sec, ListenerCollectCallback collect,
+               std::function<void()> on_handed_off);
+
+    /**
+     * @brief 인계 스레드를 중지하고, 가져가지 않은 넘겨받은 소켓과 확인 전의 이전 서버 연결을 닫습니다.
+     * @details 새 서버가 시작에 실패했을 때도 호출하여, 이전 서버가 바로 계속 서비스하도록 합니다.
+     * @param unlink_path 인계 소켓 파일을 지울지 여부 (다음 서버에 인계했으면 파일은 다음 서버의 것이므로 false)
+     */
+    void stop(bool unlink_path);
+
+private:
+    /**
+     * @brief 인계 스레드 본체. 요청마다 소켓을 보내고 확인을 기다림
+     */
+    void serve_loop();
+
+    /**
+     * @brief 요청한 프로세스 하나에 리스닝 소켓을 보내고 확인을 기다립니다. (확인 시간이 지나면 그 프로세스를 종료)
+     * @param client 인계 요청 연결
+     * @return 다음 서버가 확인을 보냈으면 true
+     */
+    bool hand_off(int client);
+
+    /**
+     * @brief 넘겨받은 소켓, 이전 서버와의 연결(확인 전), 등록된 RTSP 소켓, 처리 중인 인계 요청 연결, 보호용 뮤텍스
+     */
+    ListenerSockets inherited;
+    int predecessor_fd = -1;
+    int rtsp_fd = -1;
+    int client_fd = -1;
+    std::mutex mutex;
+
+    /**
+     * @brief 인계 소켓, 인계 스레드, 실행 상태
+     */
+    int listen_fd = -1;
+    std::thread serve_thread;
+    std::atomic<bool> running{false};
+
+    /**
+     * @brief 설정
+     */
+    std::string path;
+    int ack_timeout_sec = 60;
+    ListenerCollectCallback collect;
+    std::function<void()> on_handed_off;
+};
+
+/**
+ * @brief 서버 전역 리스닝 소켓 인계 인스턴스
+ */
+extern ListenerHandoff g_listener_handoff;
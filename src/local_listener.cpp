@@ -0,0 +1,269 @@
+/**
+ * @file local_listener.cpp
+ * @brief 로컬 클라이언트용 Unix 도메인 소켓 리스너 구현 파일
+ * @details 소켓 파일 생성(남은 파일 정리 포함), accept 루프, SO_PEERCRED 인증을 구현합니다.
+ */
+
+#include "local_listener.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 로컬 리스너 인스턴스
+ */
+LocalListener g_local_listener;
+
+/**
+ * @brief 소멸자. 리스너를 중지함
+ */
+LocalListener::~LocalListener()
+{
+    stop(true);
+}
+
+/**
+ * @brief 소켓 파일을 만들고 수락 스레드를 시작합니다.
+ * @param ctx 연결 핸들을 만들 SSL 컨텍스트
+ * @param path 소켓 파일 경로
+ * @param mode 소켓 파일 권한
+ * @param allowed_uids 추가로 허용할 uid 목록
+ * @param allowed_gids 허용할 gid 목록
+ * @param on_ready 인증을 통과한 연결을 넘겨받는 콜백
+ * @param inherited_fd 이전 서버에서 넘겨받은 리스닝 소켓 (없으면 -1)
+ * @return 성공 시 true
+ */
+bool LocalListener::start(SSL_CTX* ctx, const string& path, mode_t mode, vector<uid_t> allowed_uids,
+                          vector<gid_t> allowed_gids, LocalReadyCallback on_ready, int inherited_fd)
+{
+    if (running.load())
+    {
+        return true;
+    }
+    if (inherited_fd >= 0)
+    {
+        // 소켓 파일과 권한은 이전 서버가 만든 그대로 사용
+        listen_fd = inherited_fd;
+    }
+    else if (!create_socket(path, mode))
+    {
+        return false;
+    }
+
+    // 인계 중에는 두 프로세스가 같은 수락 큐를 보므로, 다른 쪽이 먼저 가져간 연결에서 accept가 멈추지 않게 함
+    int flags = fcntl(listen_fd, F_GETFL);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (flags < 0 || fcntl(listen_fd, F_SETFL, flags | O_NONBLOCK) < 0 || wake_fd < 0)
+    {
+        cerr << "[Local] 소켓 " << path << " 준비 실패: " << strerror(errno) << endl;
+        if (wake_fd >= 0)
+        {
+            close(wake_fd);
+            wake_fd = -1;
+        }
+        close(listen_fd);
+        listen_fd = -1;
+        if (inherited_fd < 0)
+        {
+            unlink(path.c_str());
+        }
+        return false;
+    }
+
+    this->ctx = ctx;
+    this->path = path;
+    this->allowed_uids = std::move(allowed_uids);
+    this->allowed_gids = std::move(allowed_gids);
+    this->on_ready = std::move(on_ready);
+
+    running = true;
+    accept_thread = thread(&LocalListener::accept_loop, this);
+    cout << "[Local] Unix 소켓 리스너 시작 (" << path << ", mode=0" << oct << mode << dec
+         << (inherited_fd >= 0 ? ", 넘겨받은 소켓" : "") << ")" << endl;
+    return true;
+}
+
+/**
+ * @brief 소켓 파일을 만들고 listen합니다.
+ * @details 같은 경로에 응답하지 않는 소켓 파일이 남아 있으면 지우고 다시 만들며, 다른 서버가 이미 듣고 있으면
+ *          실패합니다.
+ * @param path 소켓 파일 경로
+ * @param mode 소켓 파일 권한
+ * @return 성공 시 true
+ */
+bool LocalListener::create_socket(const string& path, mode_t mode)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        cerr << "[Local] 소켓 경로가 비었거나 너무 깁니다: " << path << endl;
+        return false;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+    {
+        cerr << "[Local] 소켓 생성 실패: " << strerror(errno) << endl;
+        return false;
+    }
+
+    // 이전 실행이 남긴 소켓 파일은 연결을 받지 않을 때만 지움 (다른 서버가 사용 중이면 실패)
+    struct stat info{};
+    if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+    {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool in_use = probe >= 0 && connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0)
+        {
+            close(probe);
+        }
+        if (in_use)
+        {
+            cerr << "[Local] 다른 프로세스가 이미 사용 중인 소켓입니다: " << path << endl;
+            close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    // Linux는 bind가 만드는 소켓 파일에 소켓 inode의 권한(umask 적용)을 쓰므로, 프로세스 전체의 umask를 바꾸지 않고
+    // bind 전에 fchmod로 소유자 전용 권한을 주어 bind 직후에도 다른 사용자가 접속하지 못하게 한 뒤 설정 권한으로 바꿈
+    if (fchmod(listen_fd, S_IRUSR | S_IWUSR) < 0 ||
+        ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        chmod(path.c_str(), mode) < 0 || listen(listen_fd, SOMAXCONN) < 0)
+    {
+        cerr << "[Local] 소켓 " << path << " 준비 실패: " << strerror(errno) << endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 수락 스레드를 중지하고 리스닝 소켓을 닫습니다.
+ * @param unlink_path 소켓 파일을 지울지 여부
+ */
+void LocalListener::stop(bool unlink_path)
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+    uint64_t one = 1;
+    (void)write(wake_fd, &one, sizeof(one));
+    if (accept_thread.joinable())
+    {
+        accept_thread.join();
+    }
+    close(listen_fd);
+    close(wake_fd);
+    listen_fd = -1;
+    wake_fd = -1;
+    if (unlink_path)
+    {
+        unlink(path.c_str());
+    }
+}
+
+/**
+ * @brief 리스닝 소켓을 반환합니다.
+ * @return 리스닝 소켓 (실행 중이 아니면 -1)
+ */
+int LocalListener::listen_socket() const
+{
+    return running.load() ? listen_fd : -1;
+}
+
+/**
+ * @brief 수락 스레드 본체
+ */
+void LocalListener::accept_loop()
+{
+    while (running.load())
+    {
+        pollfd fds[2] = {{listen_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0 && errno != EINTR)
+        {
+            cerr << "[Local] poll 실패: " << strerror(errno) << endl;
+            break;
+        }
+        if (!running.load())
+        {
+            break;
+        }
+        if (fds[0].revents & (POLLERR | POLLNVAL))
+        {
+            cerr << "[Local] 리스닝 소켓 오류로 수락을 중지합니다." << endl;
+            break;
+        }
+        if ((fds[0].revents & POLLIN) == 0)
+        {
+            continue;
+        }
+
+        int client_socket = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_socket < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                continue;
+            }
+            if (running.load())
+            {
+                cerr << "[Local] 연결 수락 실패: " << strerror(errno) << endl;
+            }
+            break;
+        }
+
+        ucred peer{};
+        socklen_t peer_len = sizeof(peer);
+        if (getsockopt(client_socket, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) < 0 || !authorized(peer))
+        {
+            cerr << "[Local] 허용되지 않은 로컬 클라이언트 연결을 닫습니다. (pid=" << peer.pid << ", uid=" << peer.uid
+                 << ", gid=" << peer.gid << ")" << endl;
+            close(client_socket);
+            continue;
+        }
+
+        SSL* ssl = create_plain_connection(ctx, client_socket);
+        if (!ssl)
+        {
+            cerr << "[Local] 연결 핸들 생성 실패" << endl;
+            close(client_socket);
+            continue;
+        }
+        cout << "[Local] 로컬 클라이언트 연결 수락 (pid=" << peer.pid << ", uid=" << peer.uid << ", gid=" << peer.gid
+             << ")" << endl;
+        on_ready(ssl, client_socket, peer);
+    }
+}
+
+/**
+ * @brief 상대 프로세스가 연결을 허용받은 사용자인지 확인합니다.
+ * @param peer 상대 프로세스의 pid/uid/gid
+ * @return 허용되면 true
+ */
+bool LocalListener::authorized(const ucred& peer) const
+{
+    if (peer.uid == 0 || peer.uid == geteuid())
+    {
+        return true;
+    }
+    return find(allowed_uids.begin(), allowed_uids.end(), peer.uid) != allowed_uids.end() ||
+           find(allowed_gids.begin(), allowed_gids.end(), peer.gid) != allowed_gids.end();
+}
@@ -0,0 +1,114 @@
+/**
+ * @file local_listener.hpp
+ * @brief 로컬 클라이언트용 Unix 도메인 소켓 리스너 헤더 파일
+ * @details 같은 장비의 진단 도구, 제어 데몬, 스크립트가 TLS 없이 서버에 요청할 수 있도록 AF_UNIX 스트림 소켓을 엽니다.
+ *          메시지 형식(4바이트 길이 접두사, 협상 요청 포함)과 요청 처리 함수는 TCP 연결과 같습니다. 소켓 파일 권한과
+ *          함께, 수락한 연결마다 SO_PEERCRED로 상대 프로세스의 uid/gid를 확인하여 허용된 사용자만 받습니다.
+ */
+
+#pragma once
+
+#include "ssl.hpp"
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 인증을 통과한 로컬 연결을 넘겨받는 콜백 (수락 스레드에서 호출)
+ * @param ssl TLS 없는 연결 핸들 (소유권 이전, is_plain_connection() == true)
+ * @param client_socket 클라이언트 소켓 디스크립터 (소유권 이전)
+ * @param peer 상대 프로세스의 pid/uid/gid
+ */
+using LocalReadyCallback = std::function<void(SSL* ssl, int client_socket, const ucred& peer)>;
+
+/**
+ * @class LocalListener
+ * @brief Unix 도메인 소켓을 수락하고 SO_PEERCRED로 상대를 인증하는 리스너
+ * @details root, 서버와 같은 uid, 허용 목록의 uid 또는 gid로 실행 중인 프로세스만 연결을 유지합니다.
+ */
+class LocalListener
+{
+public:
+    /**
+     * @brief 소멸자. 리스너를 중지함
+     */
+    ~LocalListener();
+
+    /**
+     * @brief 소켓 파일을 만들고 수락 스레드를 시작합니다.
+     * @details 같은 경로에 응답하지 않는 소켓 파일이 남아 있으면 지우고 다시 만들며, 다른 서버가 이미 듣고 있으면
+     *          실패합니다.
+     * @param ctx 연결 핸들을 만들 SSL 컨텍스트
+     * @param path 소켓 파일 경로
+     * @param mode 소켓 파일 권한
+     * @param allowed_uids 추가로 허용할 uid 목록
+     * @param allowed_gids 허용할 gid 목록
+     * @param on_ready 인증을 통과한 연결을 넘겨받는 콜백
+     * @param inherited_fd 이전 서버에서 넘겨받은 리스닝 소켓 (소유권 이전, 있으면 소켓 파일을 새로 만들지 않음, 없으면 -1)
+     * @return 성공 시 true
+     */
+    bool start(SSL_CTX* ctx, const std::string& path, mode_t mode, std::vector<uid_t> allowed_uids,
+               std::vector<gid_t> allowed_gids, LocalReadyCallback on_ready, int inherited_fd);
+
+    /**
+     * @brief 수락 스레드를 중지하고 리스닝 소켓을 닫습니다.
+     * @param unlink_path 소켓 파일을 지울지 여부 (다음 서버에 인계했으면 파일은 다음 서버가 쓰므로 false)
+     */
+    void stop(bool unlink_path);
+
+    /**
+     * @brief 리스닝 소켓을 반환합니다. (다음 서버에 인계할 때 사용, 소유권은 넘기지 않음)
+     * @return 리스닝 소켓 (실행 중이 아니면 -1)
+     */
+    int listen_socket() const;
+
+private:
+    /**
+     * @brief 소켓 파일을 만들고 listen합니다.
+     * @param path 소켓 파일 경로
+     * @param mode 소켓 파일 권한
+     * @return 성공 시 true
+     */
+    bool create_socket(const std::string& path, mode_t mode);
+
+    /**
+     * @brief 수락 스레드 본체
+     */
+    void accept_loop();
+
+    /**
+     * @brief 상대 프로세스가 연결을 허용받은 사용자인지 확인합니다.
+     * @param peer 상대 프로세스의 pid/uid/gid
+     * @return 허용되면 true
+     */
+    bool authorized(const ucred& peer) const;
+
+    /**
+     * @brief 리스닝 소켓, 중지 신호용 eventfd, 수락 스레드, 실행 상태
+     * @details 인계한 리스닝 소켓은 다음 서버와 함께 쓰므로 shutdown 대신 eventfd로 수락 스레드를 깨움
+     */
+    int listen_fd = -1;
+    int wake_fd = -1;
+    std::thread accept_thread;
+    std::atomic<bool> running{false};
+
+    /**
+     * @brief 설정
+     */
+    SSL_CTX* ctx = nullptr;
+    std::string path;
+    std::vector<uid_t> allowed_uids;
+    std::vector<gid_t> allowed_gids;
+    LocalReadyCallback on_ready;
+};
+
+/**
+ * @brief 서버 전역 로컬 리스너 인스턴스
+ */
+extern LocalListener g_local_listener;
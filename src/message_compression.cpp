@@ -0,0 +1,212 @@
+/**
+ * @file message_compression.cpp
+ * @brief 메시지 단위 압축 구현 파일
+ * @details zlib deflate와 zstd 단일 호출 API로 프레임 본문을 압축/해제하고, 스트림/컨텍스트를 재사용합니다.
+ */
+
+#include "message_compression.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief 압축 방식을 프로토콜 문자열("none", "deflate", "zstd")로 변환합니다.
+ * @param codec 압축 방식
+ * @return 압축 방식 문자열
+ */
+const char* compression_codec_name(CompressionCodec codec)
+{
+    switch (codec)
+    {
+    case CompressionCodec::Deflate:
+        return "deflate";
+    case CompressionCodec::Zstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+/**
+ * @brief 프로토콜 문자열을 압축 방식으로 변환합니다.
+ * @param name 압축 방식 문자열
+ * @return 이 빌드에서 지원하는 압축 방식 (모르거나 지원하지 않으면 CompressionCodec::None)
+ */
+CompressionCodec parse_compression_codec(const string& name)
+{
+    if (name == "deflate")
+    {
+        return CompressionCodec::Deflate;
+    }
+#ifdef HAVE_ZSTD
+    if (name == "zstd")
+    {
+        return CompressionCodec::Zstd;
+    }
+#endif
+    return CompressionCodec::None;
+}
+
+/**
+ * @brief 이 빌드에서 지원하는 압축 방식 목록을 서버 선호 순서로 반환합니다.
+ * @return 압축 방식 문자열 목록
+ */
+vector<string> supported_compression_codecs()
+{
+#ifdef HAVE_ZSTD
+    return {"zstd", "deflate"};
+#else
+    return {"deflate"};
+#endif
+}
+
+/**
+ * @brief 생성자
+ * @param codec 압축 방식 (CompressionCodec::None이면 compress/decompress가 항상 실패)
+ * @param level 압축 수준 (deflate 1~9, zstd 1~19)
+ */
+MessageCompressor::MessageCompressor(CompressionCodec codec, int level) : codec(codec), level(level)
+{
+    if (codec == CompressionCodec::Deflate)
+    {
+        deflate_ready = deflateInit(&deflate_stream, max(1, min(9, level))) == Z_OK;
+        inflate_ready = inflateInit(&inflate_stream) == Z_OK;
+    }
+#ifdef HAVE_ZSTD
+    else if (codec == CompressionCodec::Zstd)
+    {
+        zstd_cctx = ZSTD_createCCtx();
+        zstd_dctx = ZSTD_createDCtx();
+    }
+#endif
+}
+
+/**
+ * @brief 소멸자. 압축/해제 컨텍스트를 해제함
+ */
+MessageCompressor::~MessageCompressor()
+{
+    if (deflate_ready)
+    {
+        deflateEnd(&deflate_stream);
+    }
+    if (inflate_ready)
+    {
+        inflateEnd(&inflate_stream);
+    }
+#ifdef HAVE_ZSTD
+    ZSTD_freeCCtx(zstd_cctx);
+    ZSTD_freeDCtx(zstd_dctx);
+#endif
+}
+
+/**
+ * @brief 메시지 하나를 압축합니다.
+ * @param input 원본 메시지
+ * @param output 압축된 메시지 (출력)
+ * @return 성공 시 true
+ */
+bool MessageCompressor::compress(const string& input, string& output)
+{
+    if (codec == CompressionCodec::Deflate && deflate_ready)
+    {
+        // 이전 메시지의 상태를 지우고 할당된 내부 버퍼는 그대로 재사용
+        deflateReset(&deflate_stream);
+        output.resize(deflateBound(&deflate_stream, input.size()));
+        deflate_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        deflate_stream.avail_in = static_cast<uInt>(input.size());
+        deflate_stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+        deflate_stream.avail_out = static_cast<uInt>(output.size());
+        if (deflate(&deflate_stream, Z_FINISH) != Z_STREAM_END)
+        {
+            return false;
+        }
+        output.resize(deflate_stream.total_out);
+        return true;
+    }
+#ifdef HAVE_ZSTD
+    if (codec == CompressionCodec::Zstd && zstd_cctx)
+    {
+        output.resize(ZSTD_compressBound(input.size()));
+        size_t written = ZSTD_compressCCtx(zstd_cctx, &output[0], output.size(), input.data(), input.size(), level);
+        if (ZSTD_isError(written))
+        {
+            return false;
+        }
+        output.resize(written);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * @brief 압축된 메시지 하나를 해제합니다.
+ * @param data 압축된 메시지
+ * @param len 압축된 메시지 길이
+ * @param max_size 허용하는 최대 원본 크기 (압축 폭탄 방지)
+ * @param output 원본 메시지 (출력)
+ * @return 성공 시 true, 손상되었거나 max_size를 넘으면 false
+ */
+bool MessageCompressor::decompress(const char* data, size_t len, size_t max_size, string& output)
+{
+    if (codec == CompressionCodec::Deflate && inflate_ready)
+    {
+        inflateReset(&inflate_stream);
+        inflate_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        inflate_stream.avail_in = static_cast<uInt>(len);
+        output.resize(min(max_size, max<size_t>(4096, len * 4)));
+        size_t produced = 0;
+        while (true)
+        {
+            inflate_stream.next_out = reinterpret_cast<Bytef*>(&output[produced]);
+            inflate_stream.avail_out = static_cast<uInt>(output.size() - produced);
+            int ret = inflate(&inflate_stream, Z_NO_FLUSH);
+            produced = output.size() - inflate_stream.avail_out;
+            if (ret == Z_STREAM_END)
+            {
+                output.resize(produced);
+                return true;
+            }
+            if ((ret != Z_OK && ret != Z_BUF_ERROR) || (inflate_stream.avail_in == 0 && inflate_stream.avail_out != 0))
+            {
+                return false;
+            }
+            // 출력 버퍼가 찼으면 최대 크기까지 두 배씩 늘림
+            if (output.size() >= max_size)
+            {
+                return false;
+            }
+            output.resize(min(max_size, output.size() * 2));
+        }
+    }
+#ifdef HAVE_ZSTD
+    if (codec == CompressionCodec::Zstd && zstd_dctx)
+    {
+        // 압축할 때 원본 크기를 프레임에 기록하므로 크기를 먼저 확인하고 한 번에 해제
+        unsigned long long size = ZSTD_getFrameContentSize(data, len);
+        if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR || size > max_size)
+        {
+            return false;
+        }
+        output.resize(size);
+        size_t written = ZSTD_decompressDCtx(zstd_dctx, &output[0], output.size(), data, len);
+        if (ZSTD_isError(written) || written != size)
+        {
+            return false;
+        }
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * @brief 압축 방식을 반환합니다.
+ * @return 압축 방식
+ */
+CompressionCodec MessageCompressor::get_codec() const
+{
+    return codec;
+}
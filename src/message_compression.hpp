@@ -0,0 +1,132 @@
+/**
+ * @file message_compression.hpp
+ * @brief 메시지 단위 압축 헤더 파일
+ * @details 연결별로 협상한 압축 방식(zstd, deflate)으로 길이 접두사 프레임의 본문을 압축/해제합니다. 압축된 프레임은
+ *          4바이트 길이 접두사의 최상위 비트(FRAME_COMPRESSED_FLAG)로 표시하고, 나머지 31비트가 압축된 본문의
+ *          길이입니다. 프레임마다 독립적으로 압축하므로 어느 프레임이든 따로 해제할 수 있으며, 압축 컨텍스트는
+ *          연결 수명 동안 재사용하여 메시지마다 내부 버퍼를 새로 할당하지 않습니다.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @brief 길이 접두사에서 본문이 압축되었음을 나타내는 비트
+ */
+const uint32_t FRAME_COMPRESSED_FLAG = 0x80000000u;
+
+/**
+ * @brief 길이 접두사에서 본문 길이에 해당하는 비트
+ */
+const uint32_t FRAME_LENGTH_MASK = 0x7FFFFFFFu;
+
+/**
+ * @brief 메시지 압축 방식
+ */
+enum class CompressionCodec
+{
+    None,    ///< 압축하지 않음
+    Deflate, ///< zlib 형식 deflate (RFC 1950)
+    Zstd     ///< zstd 프레임 (원본 크기 포함, HAVE_ZSTD로 빌드한 경우만)
+};
+
+/**
+ * @brief 압축 방식을 프로토콜 문자열("none", "deflate", "zstd")로 변환합니다.
+ * @param codec 압축 방식
+ * @return 압축 방식 문자열
+ */
+const char* compression_codec_name(CompressionCodec codec);
+
+/**
+ * @brief 프로토콜 문자열을 압축 방식으로 변환합니다.
+ * @param name 압축 방식 문자열
+ * @return 이 빌드에서 지원하는 압축 방식 (모르거나 지원하지 않으면 CompressionCodec::None)
+ */
+CompressionCodec parse_compression_codec(const std::string& name);
+
+/**
+ * @brief 이 빌드에서 지원하는 압축 방식 목록을 서버 선호 순서로 반환합니다.
+ * @return 압축 방식 문자열 목록
+ */
+std::vector<std::string> supported_compression_codecs();
+
+/**
+ * @class MessageCompressor
+ * @brief 연결 하나의 재사용 가능한 압축/해제 컨텍스트
+ * @details 압축과 해제는 서로 다른 내부 컨텍스트를 사용하므로 송신 스레드와 수신 스레드가 동시에 호출해도 되지만,
+ *          같은 방향의 호출은 호출자가 직렬화해야 합니다.
+ */
+class MessageCompressor
+{
+public:
+    /**
+     * @brief 생성자
+     * @param codec 압축 방식 (CompressionCodec::None이면 compress/decompress가 항상 실패)
+     * @param level 압축 수준 (deflate 1~9, zstd 1~19)
+     */
+    MessageCompressor(CompressionCodec codec, int level);
+
+    /**
+     * @brief 소멸자. 압축/해제 컨텍스트를 해제함
+     */
+    ~MessageCompressor();
+
+    MessageCompressor(const MessageCompressor&) = delete;
+    MessageCompressor& operator=(const MessageCompressor&) = delete;
+
+    /**
+     * @brief 메시지 하나를 압축합니다.
+     * @param input 원본 메시지
+     * @param output 압축된 메시지 (출력)
+     * @return 성공 시 true
+     */
+    bool compress(const std::string& input, std::string& output);
+
+    /**
+     * @brief 압축된 메시지 하나를 해제합니다.
+     * @param data 압축된 메시지
+     * @param len 압축된 메시지 길이
+     * @param max_size 허용하는 최대 원본 크기 (압축 폭탄 방지)
+     * @param output 원본 메시지 (출력)
+     * @return 성공 시 true, 손상되었거나 max_size를 넘으면 false
+     */
+    bool decompress(const char* data, size_t len, size_t max_size, std::string& output);
+
+    /**
+     * @brief 압축 방식을 반환합니다.
+     * @return 압축 방식
+     */
+    CompressionCodec get_codec() const;
+
+private:
+    /**
+     * @brief 압축 방식과 압축 수준
+     */
+    CompressionCodec codec;
+    int level;
+
+    /**
+     * @brief deflate 압축/해제 스트림 (초기화 성공 여부 포함)
+     */
+    z_stream deflate_stream{};
+    z_stream inflate_stream{};
+    bool deflate_ready = false;
+    bool inflate_ready = false;
+
+#ifdef HAVE_ZSTD
+    /**
+     * @brief zstd 압축/해제 컨텍스트
+     */
+    ZSTD_CCtx* zstd_cctx = nullptr;
+    ZSTD_DCtx* zstd_dctx = nullptr;
+#endif
+};
@@ -0,0 +1,109 @@
+/**
+ * @file message_encoding.cpp
+ * @brief 메시지 인코딩(JSON, MessagePack, CBOR) 구현 파일
+ * @details nlohmann::json의 dump/parse, to_msgpack/from_msgpack, to_cbor/from_cbor를 인코딩별로 연결합니다.
+ */
+
+#include "message_encoding.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * @brief 인코딩을 프로토콜 문자열("json", "msgpack", "cbor")로 변환합니다.
+ * @param encoding 메시지 인코딩
+ * @return 인코딩 문자열
+ */
+const char* message_encoding_name(MessageEncoding encoding)
+{
+    switch (encoding)
+    {
+    case MessageEncoding::MessagePack:
+        return "msgpack";
+    case MessageEncoding::Cbor:
+        return "cbor";
+    default:
+        return "json";
+    }
+}
+
+/**
+ * @brief 프로토콜 문자열을 인코딩으로 변환합니다.
+ * @param name 인코딩 문자열
+ * @param encoding 메시지 인코딩 (출력)
+ * @return 알려진 인코딩이면 true
+ */
+bool parse_message_encoding(const string& name, MessageEncoding& encoding)
+{
+    if (name == "json")
+    {
+        encoding = MessageEncoding::Json;
+    }
+    else if (name == "msgpack")
+    {
+        encoding = MessageEncoding::MessagePack;
+    }
+    else if (name == "cbor")
+    {
+        encoding = MessageEncoding::Cbor;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 지원하는 인코딩 목록을 서버 선호 순서로 반환합니다.
+ * @return 인코딩 문자열 목록
+ */
+vector<string> supported_message_encodings()
+{
+    return {"msgpack", "cbor", "json"};
+}
+
+/**
+ * @brief 메시지를 지정한 인코딩으로 직렬화합니다.
+ * @param message 메시지
+ * @param encoding 메시지 인코딩
+ * @return 직렬화된 메시지
+ */
+string encode_message(const json& message, MessageEncoding encoding)
+{
+    string output;
+    switch (encoding)
+    {
+    case MessageEncoding::MessagePack:
+        json::to_msgpack(message, output);
+        break;
+    case MessageEncoding::Cbor:
+        json::to_cbor(message, output);
+        break;
+    default:
+        output = message.dump();
+        break;
+    }
+    return output;
+}
+
+/**
+ * @brief 지정한 인코딩으로 직렬화된 메시지를 읽습니다.
+ * @param data 직렬화된 메시지
+ * @param len 길이
+ * @param encoding 메시지 인코딩
+ * @return 메시지
+ * @throws nlohmann::json::parse_error 형식이 잘못된 경우
+ */
+json decode_message(const char* data, size_t len, MessageEncoding encoding)
+{
+    switch (encoding)
+    {
+    case MessageEncoding::MessagePack:
+        return json::from_msgpack(data, data + len);
+    case MessageEncoding::Cbor:
+        return json::from_cbor(data, data + len);
+    default:
+        return json::parse(data, data + len);
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file message_encoding.hpp
+ * @brief 메시지 인코딩(JSON, MessagePack, CBOR) 헤더 파일
+ * @details 요청 처리 함수는 항상 nlohmann::json 객체로 메시지를 만들고 읽습니다. 연결별로 협상한 인코딩에 따라 이
+ *          계층에서만 텍스트 JSON 또는 바이너리(MessagePack, CBOR)로 변환하므로, 인코딩을 바꿔도 요청 처리 함수는
+ *          바뀌지 않습니다.
+ */
+
+#pragma once
+
+#include "json.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 메시지 인코딩
+ */
+enum class MessageEncoding
+{
+    Json,        ///< 텍스트 JSON (기본값)
+    MessagePack, ///< MessagePack
+    Cbor         ///< CBOR (RFC 8949)
+};
+
+/**
+ * @brief 인코딩을 프로토콜 문자열("json", "msgpack", "cbor")로 변환합니다.
+ * @param encoding 메시지 인코딩
+ * @return 인코딩 문자열
+ */
+const char* message_encoding_name(MessageEncoding encoding);
+
+/**
+ * @brief 프로토콜 문자열을 인코딩으로 변환합니다.
+ * @param name 인코딩 문자열
+ * @param encoding 메시지 인코딩 (출력)
+ * @return 알려진 인코딩이면 true
+ */
+bool parse_message_encoding(const std::string& name, MessageEncoding& encoding);
+
+/**
+ * @brief 지원하는 인코딩 목록을 서버 선호 순서로 반환합니다.
+ * @return 인코딩 문자열 목록
+ */
+std::vector<std::string> supported_message_encodings();
+
+/**
+ * @brief 메시지를 지정한 인코딩으로 직렬화합니다.
+ * @param message 메시지
+ * @param encoding 메시지 인코딩
+ * @return 직렬화된 메시지
+ */
+std::string encode_message(const nlohmann::json& message, MessageEncoding encoding);
+
+/**
+ * @brief 지정한 인코딩으로 직렬화된 메시지를 읽습니다.
+ * @param data 직렬화된 메시지
+ * @param len 길이
+ * @param encoding 메시지 인코딩
+ * @return 메시지
+ * @throws nlohmann::json::parse_error 형식이 잘못된 경우
+ */
+nlohmann::json decode_message(const char* data, size_t len, MessageEncoding encoding);
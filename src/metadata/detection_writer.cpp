@@ -0,0 +1,235 @@
+/**
+ * @file detection_writer.cpp
+ * @brief 감지 캡처 비동기 저장(write-behind)을 위한 DetectionWriter 클래스 구현 파일
+ * @details 제한된 크기의 큐와 배치 트랜잭션 쓰기 스레드를 구현합니다.
+ */
+
+#include "detection_writer.h"
+#include "../db_pool.hpp"
+#include "../db_statement_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+
+/**
+ * @brief 트랜잭션 실패 후 재시도 전 대기 시간의 기본 단위(ms, 시도 횟수만큼 곱함)
+ */
+static const int RETRY_DELAY_MS = 500;
+
+/**
+ * @brief 소멸자. 남은 레코드를 저장하고 쓰기 스레드를 정리함
+ */
+DetectionWriter::~DetectionWriter()
+{
+    stop();
+}
+
+/**
+ * @brief 쓰기 연결(WAL 설정)을 열고 쓰기 스레드를 시작합니다.
+ * @param db_file DB 파일 경로
+ * @param busy_timeout_ms 잠금 대기 시간(ms)
+ * @param queue_capacity 큐에 대기할 수 있는 최대 레코드 수
+ * @param batch_size 트랜잭션 하나에 삽입할 최대 레코드 수
+ * @param max_attempts 레코드당 최대 저장 시도 횟수 (1 이상)
+ * @return 성공 시 true, 실패 시 false
+ */
+bool DetectionWriter::start(const string& db_file, int busy_timeout_ms, size_t queue_capacity, size_t batch_size,
+                            int max_attempts)
+{
+    try
+    {
+        db = make_unique<SQLite::Database>(db_file, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        configure_sqlite_connection(*db, busy_timeout_ms, true);
+    }
+    catch (const exception& e)
+    {
+        cerr << "[ERROR] Failed to open detection writer connection: " << e.what() << endl;
+        db.reset();
+        return false;
+    }
+
+    this->queue_capacity = max<size_t>(queue_capacity, 1);
+    this->batch_size = max<size_t>(batch_size, 1);
+    this->max_attempts = max(max_attempts, 1);
+    stopping = false;
+    writer_thread = thread(&DetectionWriter::writer_loop, this);
+    cout << "[INFO] Detection writer started (queue " << this->queue_capacity << ", batch " << this->batch_size
+         << ", attempts " << this->max_attempts << ")" << endl;
+    return true;
+}
+
+/**
+ * @brief 큐에 남은 레코드를 모두 저장한 뒤 쓰기 스레드와 연결을 닫습니다.
+ */
+void DetectionWriter::stop()
+{
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    if (!writer_thread.joinable())
+    {
+        return;
+    }
+    writer_thread.join();
+
+    release_statement_cache(*db);
+    db.reset();
+    DetectionWriterStats final_stats = get_stats();
+    cout << "[INFO] Detection writer stopped (written " << final_stats.written << ", dropped " << final_stats.dropped
+         << ", retried " << final_stats.retried << ", failed " << final_stats.failed << ")" << endl;
+}
+
+/**
+ * @brief 감지 레코드를 큐에 넣습니다. (기다리지 않음)
+ * @details 큐가 가득 차면 이미 대기 중인 레코드를 보존하고 새 레코드를 버립니다.
+ * @param record 저장할 레코드
+ * @return 큐에 넣었으면 true, 큐가 가득 찼거나 닫혀 있으면 false
+ */
+bool DetectionWriter::submit(DetectionRecord record)
+{
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        if (stopping || !db)
+        {
+            cerr << "[ERROR] Detection writer is not running. Record dropped: " << record.timestamp << endl;
+            return false;
+        }
+        if (queue.size() >= queue_capacity)
+        {
+            stats.dropped++;
+            cerr << "[ERROR] Detection queue full (" << queue.size() << "). Record dropped: " << record.timestamp
+                 << endl;
+            return false;
+        }
+        queue.push_back(std::move(record));
+    }
+    queue_cv.notify_one();
+    return true;
+}
+
+/**
+ * @brief 큐에 대기 중인 레코드 수를 반환합니다.
+ * @return 대기 중인 레코드 수
+ */
+size_t DetectionWriter::pending()
+{
+    lock_guard<mutex> lock(queue_mutex);
+    return queue.size();
+}
+
+/**
+ * @brief 누적 통계를 반환합니다.
+ * @return DetectionWriterStats 복사본
+ */
+DetectionWriterStats DetectionWriter::get_stats()
+{
+    lock_guard<mutex> lock(queue_mutex);
+    DetectionWriterStats snapshot = stats;
+    snapshot.pending = queue.size();
+    return snapshot;
+}
+
+/**
+ * @brief 쓰기 스레드 본체. 큐에 쌓인 레코드를 batch_size개씩 꺼내 저장
+ * @details 저장하는 동안 쌓인 레코드는 다음 트랜잭션에 함께 묶이므로, 감지가 몰릴수록 커밋(fsync) 횟수가 줄어듭니다.
+ *          트랜잭션이 실패하면 묶음을 순서대로 큐 앞에 되돌리고 잠시 기다린 뒤 재시도하며(큐 용량과 무관, 최대
+ *          batch_size개 초과), max_attempts번 실패한 레코드만 버립니다. 종료 요청 후에도 이미 큐에 들어온 레코드는
+ *          모두 저장을 시도합니다.
+ */
+void DetectionWriter::writer_loop()
+{
+    vector<DetectionRecord> batch;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+            {
+                break;
+            }
+            size_t count = min(queue.size(), batch_size);
+            batch.assign(make_move_iterator(queue.begin()), make_move_iterator(queue.begin() + count));
+            queue.erase(queue.begin(), queue.begin() + count);
+        }
+
+        if (write_batch(batch))
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            stats.written += batch.size();
+            batch.clear();
+            continue;
+        }
+
+        // 시도 횟수가 남은 레코드는 원래 순서대로 큐 앞에 되돌림
+        unique_lock<mutex> lock(queue_mutex);
+        int attempts = 0;
+        for (auto& record : batch)
+        {
+            attempts = max(attempts, ++record.attempts);
+            if (record.attempts >= max_attempts)
+            {
+                stats.failed++;
+                cerr << "[ERROR] Detection record dropped after " << record.attempts << " failed attempt(s): "
+                     << record.timestamp << endl;
+            }
+        }
+        for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+        {
+            if (it->attempts < max_attempts)
+            {
+                stats.retried++;
+                queue.push_front(std::move(*it));
+            }
+        }
+        batch.clear();
+
+        // 잠금 경합 등 일시적인 실패가 풀리도록 시도 횟수에 비례해 기다림 (종료 요청 시 바로 재시도)
+        queue_cv.wait_for(lock, chrono::milliseconds(RETRY_DELAY_MS * attempts), [this] { return stopping; });
+    }
+}
+
+/**
+ * @brief 레코드 묶음을 하나의 트랜잭션으로 삽입합니다.
+ * @param batch 삽입할 레코드 목록
+ * @return 커밋 성공 시 true (실패 시 묶음 전체가 롤백됨)
+ */
+bool DetectionWriter::write_batch(const vector<DetectionRecord>& batch)
+{
+    try
+    {
+        SQLite::Transaction transaction(*db);
+        for (const auto& record : batch)
+        {
+            CachedStatement query(*db, "INSERT INTO detections (image, timestamp, ts_ms, human_id, rule_name, "
+                                       "vehicle_id, board_id, similarity) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+            query->bind(1, record.image.data(), static_cast<int>(record.image.size()));
+            query->bind(2, record.timestamp);
+            query->bind(3, static_cast<int64_t>(record.timestamp_ms));
+            query->bind(4, record.human_id);
+            query->bind(5, record.rule_name);
+            query->bind(6, record.vehicle_id);
+            query->bind(7, record.board_id);
+            query->bind(8, record.similarity);
+            query->exec();
+        }
+        transaction.commit();
+    }
+    catch (const exception& e)
+    {
+        cerr << "[ERROR] Failed to insert " << batch.size() << " detection(s) into DB: " << e.what() << endl;
+        return false;
+    }
+
+    for (const auto& record : batch)
+    {
+        cout << "[INFO] Image data inserted to DB with timestamp: " << record.timestamp << endl;
+    }
+    return true;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file detection_writer.h
+ * @brief 감지 캡처 비동기 저장(write-behind)을 위한 DetectionWriter 클래스 헤더 파일
+ * @details 캡처 스레드는 감지 레코드를 제한된 크기의 큐에 넣고 바로 반환하며, 전용 쓰기 스레드가 하나의 장기 연결에서
+ *          큐에 쌓인 레코드를 여러 건씩 하나의 트랜잭션으로 삽입합니다. SD 카드 fsync 지연이 경고 경로에 걸리지 않습니다.
+ */
+
+#pragma once
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief detections 테이블에 저장할 감지 레코드 한 건
+ */
+struct DetectionRecord
+{
+    std::vector<unsigned char> image; ///< 캡처 이미지(JPEG)
+    std::string timestamp;            ///< 표시용 타임스탬프 문자열(KST)
+    long long timestamp_ms;           ///< 타임스탬프 (epoch 밀리초, 범위 조회용)
+    int human_id;                     ///< 감지선을 넘은 사람 객체 ID
+    std::string rule_name;            ///< 넘은 감지선 이름
+    int vehicle_id;                   ///< 접근 중인 차량 객체 ID
+    int board_id;                     ///< 가동한 dot matrix 보드 ID
+    double similarity;                ///< 차량 진행 방향과 감지선의 코사인 유사도
+    int attempts = 0;                 ///< 실패한 저장 시도 횟수 (쓰기 스레드만 사용)
+};
+
+/**
+ * @brief DetectionWriter 누적 통계
+ */
+struct DetectionWriterStats
+{
+    uint64_t written = 0; ///< 저장에 성공한 레코드 수
+    uint64_t dropped = 0; ///< 큐가 가득 차 버린 레코드 수
+    uint64_t retried = 0; ///< 트랜잭션 실패 후 큐 앞에 다시 넣은 레코드 수 (재시도 횟수 합)
+    uint64_t failed = 0;  ///< 최대 시도 횟수를 넘겨 유실된 레코드 수
+    size_t pending = 0;   ///< 현재 큐에 대기 중인 레코드 수
+};
+
+/**
+ * @class DetectionWriter
+ * @brief 감지 레코드를 큐에 모아 배치 트랜잭션으로 저장하는 쓰기 스레드
+ * @details submit()은 DB를 기다리지 않습니다. 큐가 가득 차면 새 레코드를 버리고 false를 반환하여, 저장이 밀려도
+ *          캡처 스레드와 메모리 사용량이 제한되도록 합니다. 트랜잭션이 실패한 묶음은 큐 앞에 다시 넣어 max_attempts번까지
+ *          재시도하고, 그래도 실패하면 버리고 통계의 failed로 셉니다.
+ */
+class DetectionWriter
+{
+public:
+    /**
+     * @brief 소멸자. 남은 레코드를 저장하고 쓰기 스레드를 정리함
+     */
+    ~DetectionWriter();
+
+    /**
+     * @brief 쓰기 연결(WAL 설정)을 열고 쓰기 스레드를 시작합니다.
+     * @param db_file DB 파일 경로
+     * @param busy_timeout_ms 잠금 대기 시간(ms)
+     * @param queue_capacity 큐에 대기할 수 있는 최대 레코드 수
+     * @param batch_size 트랜잭션 하나에 삽입할 최대 레코드 수
+     * @param max_attempts 레코드당 최대 저장 시도 횟수 (1 이상)
+     * @return 성공 시 true, 실패 시 false
+     */
+    bool start(const std::string& db_file, int busy_timeout_ms, size_t queue_capacity, size_t batch_size,
+               int max_attempts);
+
+    /**
+     * @brief 큐에 남은 레코드를 모두 저장한 뒤 쓰기 스레드와 연결을 닫습니다.
+     */
+    void stop();
+
+    /**
+     * @brief 감지 레코드를 큐에 넣습니다. (기다리지 않음)
+     * @param record 저장할 레코드
+     * @return 큐에 넣었으면 true, 큐가 가득 찼거나 닫혀 있으면 false
+     */
+    bool submit(DetectionRecord record);
+
+    /**
+     * @brief 큐에 대기 중인 레코드 수를 반환합니다.
+     * @return 대기 중인 레코드 수
+     */
+    size_t pending();
+
+    /**
+     * @brief 누적 통계를 반환합니다.
+     * @return DetectionWriterStats 복사본
+     */
+    DetectionWriterStats get_stats();
+
+private:
+    /**
+     * @brief 쓰기 스레드 본체. 큐에 쌓인 레코드를 batch_size개씩 꺼내 저장
+     */
+    void writer_loop();
+
+    /**
+     * @brief 레코드 묶음을 하나의 트랜잭션으로 삽입합니다.
+     * @param batch 삽입할 레코드 목록
+     * @return 커밋 성공 시 true (실패 시 묶음 전체가 롤백됨)
+     */
+    bool write_batch(const std::vector<DetectionRecord>& batch);
+
+    /**
+     * @brief 쓰기 전용 장기 연결
+     */
+    std::unique_ptr<SQLite::Database> db;
+
+    /**
+     * @brief 대기 큐와 보호용 뮤텍스/조건변수, 쓰기 스레드
+     */
+    std::deque<DetectionRecord> queue;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::thread writer_thread;
+    bool stopping = false;
+
+    /**
+     * @brief 큐 최대 길이, 트랜잭션당 최대 레코드 수, 레코드당 최대 저장 시도 횟수
+     */
+    size_t queue_capacity = 0;
+    size_t batch_size = 0;
+    int max_attempts = 1;
+
+    /**
+     * @brief 누적 통계 (queue_mutex로 보호, pending은 get_stats()에서 채움)
+     */
+    DetectionWriterStats stats;
+};
@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <deque>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <mutex>
@@ -19,7 +20,11 @@
 #include <vector>
 
 #include "../config_manager.hpp"
+#include "../db_pool.hpp"
+#include "../db_schema.hpp"
+#include "../utils.hpp"
 #include "board_control.h"
+#include "detection_writer.h"
 #include <SQLiteCpp/SQLiteCpp.h>
 #include <fcntl.h>
 #include <termios.h>
@@ -47,6 +52,19 @@ struct Line
     string name; ///< 라인 이름
 };
 
+/**
+ * @brief 경고가 발생한 감지 이벤트 정보 (detections 테이블 메타데이터)
+ */
+struct DetectionEvent
+{
+    int human_id;        ///< 감지선을 넘은 사람 객체 ID
+    string rule_name;    ///< 넘은 감지선 이름
+    int vehicle_id;      ///< 접근 중인 차량 객체 ID
+    int board_id;        ///< 가동한 dot matrix 보드 ID
+    float similarity;    ///< 차량 진행 방향과 감지선의 코사인 유사도
+    string utc_time_str; ///< 이벤트 발생 시간(UTC)
+};
+
 /**
  * @brief 보드 ID와 포트 경로 매핑 테이블
  */
@@ -70,6 +88,12 @@ std::string get_uart_port_for_board(int board_id)
 
 // --- 전역 상태 ---
 
+/**
+ * @brief 감지 캡처 비동기 저장용 쓰기 스레드
+ * @details 캡처 스레드는 레코드를 넣고 바로 반환하며, 삽입은 하나의 장기 연결에서 여러 건씩 배치로 커밋됩니다.
+ */
+DetectionWriter detection_writer;
+
 /**
  * @brief 데이터 보호용 재귀 뮤텍스
  */
@@ -124,10 +148,9 @@ float compute_cosine_similarity(const Point& a, const Point& b);
 
 /**
  * @brief 화면을 캡처하여 DB에 저장
- * @param db SQLite 데이터베이스 객체
- * @param utc_time_str UTC 시간 문자열
+ * @param event 감지 이벤트 정보
  */
-void capture_screen_and_save(SQLite::Database& db, const string& utc_time_str);
+void capture_screen_and_save(const DetectionEvent& event);
 
 /**
  * @brief 보드에 명령 전송
@@ -138,10 +161,9 @@ void control_board(int board_id, uint8_t cmd);
 
 /**
  * @brief 비동기 보드 제어 (스레드)
- * @param board_id 보드 ID
- * @param utc_time_str UTC 시간 문자열
+ * @param event 감지 이벤트 정보 (event.board_id 보드를 제어)
  */
-void control_board_async(int board_id, const string& utc_time_str);
+void control_board_async(DetectionEvent event);
 
 // --- 보드제어 관련 함수 ---
 
@@ -182,11 +204,11 @@ void control_board(int board_id, uint8_t cmd)
 
 /**
  * @brief 비동기(스레드)로 보드 제어 및 화면 캡처를 수행합니다.
- * @param board_id 보드 ID
- * @param utc_time_str UTC 시간 문자열
+ * @param event 감지 이벤트 정보 (event.board_id 보드를 제어)
  */
-void control_board_async(int board_id, const string& utc_time_str)
+void control_board_async(DetectionEvent event)
 {
+    int board_id = event.board_id;
     cout << "[INFO] Starting async board control for board " << board_id << endl;
 
     // 0x01 명령어 실행 (LCD ON)
@@ -194,14 +216,13 @@ void control_board_async(int board_id, const string& utc_time_str)
 
     // dot matrix 동작과 동시에 화면 캡처 시작
     std::thread capture_thread(
-        [utc_time_str]()
+        [event]()
         {
             try
             {
                 // 잠시 대기 후 캡처 (dot matrix가 켜진 상태에서 캡처)
                 sleep(1); // 1초 후 캡처하여 dot matrix 동작 상태를 기록
-                SQLite::Database db(g_config.db_file, SQLite::OPEN_READWRITE);
-                capture_screen_and_save(db, utc_time_str);
+                capture_screen_and_save(event);
             }
             catch (const std::exception& e)
             {
@@ -223,41 +244,6 @@ void control_board_async(int board_id, const string& utc_time_str)
 
 // --- DB 관련 함수 ---
 
-/**
- * @brief Detections 테이블을 생성합니다.
- * @param db SQLite 데이터베이스 객체
- */
-void create_detections_table(SQLite::Database& db)
-{
-    db.exec("CREATE TABLE IF NOT EXISTS detections ("
-            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-            "image BLOB, "
-            "timestamp DATETIME NOT NULL)");
-    cout << "[INFO] 'detections' table is ready." << endl;
-}
-
-/**
- * @brief DB에 이미지 데이터를 삽입합니다.
- * @param db SQLite 데이터베이스 객체
- * @param image_data 이미지 데이터 벡터
- * @param timestamp 타임스탬프 문자열
- */
-void insert_data(SQLite::Database& db, const vector<unsigned char>& image_data, const string& timestamp)
-{
-    try
-    {
-        SQLite::Statement query(db, "INSERT INTO detections (image, timestamp) VALUES (?, ?)");
-        query.bind(1, image_data.data(), image_data.size());
-        query.bind(2, timestamp);
-        query.exec();
-        cout << "[INFO] Image data inserted to DB with timestamp: " << timestamp << endl;
-    }
-    catch (const exception& e)
-    {
-        cerr << "[ERROR] Failed to insert data into DB: " << e.what() << endl;
-    }
-}
-
 /**
  * @brief 두 직선의 교차점을 계산합니다.
  * @param a1 첫 번째 직선의 시작점
@@ -363,6 +349,9 @@ void load_rule_lines(SQLite::Database& db)
     const float scale_x = g_config.scale_x / g_config.base_x;
     const float scale_y = g_config.scale_y / g_config.base_y;
 
+    // 삭제된 감지선이 남지 않도록 다시 채움
+    rule_lines.clear();
+
     try
     {
         SQLite::Statement query(db, "SELECT x1, y1, x2, y2, name, mode FROM lines LIMIT 8");
@@ -396,40 +385,26 @@ void load_rule_lines(SQLite::Database& db)
 
 /**
  * @brief 화면을 캡처하고 DB에 저장합니다.
- * @param db SQLite 데이터베이스 객체
- * @param utc_time_str UTC 시간 문자열
+ * @details ffmpeg 캡처는 호출 스레드에서 수행하고, 삽입은 detection_writer 큐에 넘긴 뒤 기다리지 않고 반환합니다.
+ * @param event 감지 이벤트 정보
  */
-void capture_screen_and_save(SQLite::Database& db, const string& utc_time_str)
+void capture_screen_and_save(const DetectionEvent& event)
 {
+    const string& utc_time_str = event.utc_time_str;
     if (utc_time_str.empty())
     {
         cerr << "[ERROR] Cannot capture screen. UTC time is empty." << endl;
         return;
     }
 
-    // 1. UTC 시간 문자열 파싱 및 KST로 변환
-    std::tm tm = {};
-    std::stringstream ss(utc_time_str);
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-    if (ss.fail())
+    // 1. UTC 시간 문자열 파싱 및 KST로 변환 (서버와 같은 파서 사용, 소수점 이하 초는 ts_ms에만 보존)
+    long long timestamp_ms = 0;
+    if (!parse_timestamp_ms(utc_time_str, timestamp_ms, true))
     {
         cerr << "[ERROR] Failed to parse UTC time string: " << utc_time_str << endl;
         return;
     }
-
-    time_t time_utc = timegm(&tm);
-    if (time_utc == -1)
-    {
-        cerr << "[ERROR] Failed to convert UTC tm to time_t." << endl;
-        return;
-    }
-
-    time_t time_kst = time_utc + (9 * 3600);
-    char kst_buffer[100];
-    struct tm kst_tm;
-    gmtime_r(&time_kst, &kst_tm);
-    std::strftime(kst_buffer, sizeof(kst_buffer), "%Y-%m-%dT%H:%M:%SKST", &kst_tm);
-    string kst_timestamp_str(kst_buffer);
+    string kst_timestamp_str = format_kst_timestamp(timestamp_ms);
 
     // 2. ffmpeg 캡처 명령어 생성 (이미지를 stdout으로 출력)
     string cmd = "ffmpeg -i " + get_rtsp_url() + " -vframes 1 -c:v mjpeg -f image2pipe - 2>/dev/null";
@@ -453,10 +428,12 @@ void capture_screen_and_save(SQLite::Database& db, const string& utc_time_str)
     }
     pclose(pipe);
 
-    // 4. DB에 데이터 삽입
+    // 4. DB 저장 큐에 넘김 (커밋은 쓰기 스레드가 배치로 수행)
     if (!image_data.empty())
     {
-        insert_data(db, image_data, kst_timestamp_str);
+        detection_writer.submit({std::move(image_data), kst_timestamp_str, timestamp_ms, event.human_id,
+                                 event.rule_name, event.vehicle_id, event.board_id,
+                                 static_cast<double>(event.similarity)});
     }
     else
     {
@@ -722,7 +699,8 @@ void analyze_risk_and_alert(SQLite::Database& db, int human_id, const string& ru
             cout << "(코사인 유사도 : " << similarity << ")\n" << endl;
 
             // 7. 보드 제어를 별도 스레드에서 비동기 실행
-            std::thread board_control_thread(control_board_async, board_id, utc_time_str);
+            DetectionEvent event = {human_id, rule_name, vehicle_id, board_id, similarity, utc_time_str};
+            std::thread board_control_thread(control_board_async, event);
             board_control_thread.detach(); // 스레드를 독립적으로 실행
         }
         else
@@ -771,24 +749,37 @@ void metadata_thread(SQLite::Database& db)
 
     deque<string> frame_cache;
 
-    auto last_reload = chrono::steady_clock::now();
-    const auto interval = chrono::seconds(30);
+    // 설정 테이블 변경 버전을 주기적으로 확인하여 바뀐 경우에만 재로딩 (확인은 한 행 조회)
+    // 시작 시 로드와 첫 확인 사이의 변경을 놓치지 않도록 첫 확인에서는 한 번 다시 읽음
+    auto last_check = chrono::steady_clock::now();
+    const auto interval = chrono::seconds(1);
+    int64_t loaded_version = -1;
 
     while (fgets(buffer, BUFFER_SIZE, pipe))
     {
         xml_buffer += buffer;
 
-        // 일정 시간마다 DB 설정값 Reload
+        // 설정 테이블이 바뀐 경우에만 DB 설정값 Reload
         auto now = chrono::steady_clock::now();
-        if (now - last_reload > interval)
+        if (now - last_check > interval)
         {
+            last_check = now;
+            try
             {
-                lock_guard<recursive_mutex> lock(data_mutex);
-                load_dots_and_center(db);
-                load_rule_lines(db);
-                cout << "[INFO] DB 설정값을 재로딩했습니다." << endl;
+                int64_t version = select_config_version(db);
+                if (version != loaded_version)
+                {
+                    lock_guard<recursive_mutex> lock(data_mutex);
+                    load_dots_and_center(db);
+                    load_rule_lines(db);
+                    loaded_version = version;
+                    cout << "[INFO] DB 설정값을 재로딩했습니다. (config_version=" << version << ")" << endl;
+                }
+            }
+            catch (const exception& e)
+            {
+                cerr << "[ERROR] Failed to read config_version: " << e.what() << endl;
             }
-            last_reload = now;
         }
 
         // XML 블럭 완성 여부 확인
@@ -874,11 +865,19 @@ int main()
 
     try
     {
-        // DB 파일 열기
+        // DB 파일 열기 (WAL 모드, server 프로세스와 동시에 접근하므로 busy timeout 적용)
         SQLite::Database db(g_config.db_file, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        configure_sqlite_connection(db, g_config.db_busy_timeout_ms, true);
 
-        // DB 테이블 생성 (없으면)
-        create_detections_table(db);
+        // 스키마 마이그레이션 (server와 같은 단계를 공유하며, 먼저 시작한 프로세스가 적용)
+        run_schema_migrations(db);
+
+        // 감지 캡처 저장용 쓰기 스레드 (읽기는 위의 연결에서 수행)
+        if (!detection_writer.start(g_config.db_file, g_config.db_busy_timeout_ms, g_config.detection_queue_capacity,
+                                    g_config.detection_batch_size, g_config.detection_max_attempts))
+        {
+            return 1;
+        }
 
         // DB에서 설정값 로드
         load_dots_and_center(db);
@@ -892,6 +891,9 @@ int main()
 
         // 메타데이터 처리 스레드 시작 (DB 객체 전달)
         metadata_thread(db);
+
+        // 큐에 남은 감지 레코드를 저장한 뒤 종료
+        detection_writer.stop();
     }
     catch (const std::exception& e)
     {
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <regex>
 
+#include "client_session.hpp"
 #include "config_manager.hpp"
 #include "ssl.hpp"
 #include <arpa/inet.h>
@@ -329,21 +330,11 @@ bool send_bboxes_to_client(SSL* ssl)
                                {"bboxes", bbox_array},
                                {"buffer_info", {{"buffer_size", buffer_size}, {"processed_count", processed_count}}}};
 
-    std::string json_str = response.dump();
-    uint32_t res_len = json_str.length();
-    uint32_t net_res_len = htonl(res_len);
-
-    // 먼저 4바이트 길이 접두사 전송
-    if (sendAll(ssl, reinterpret_cast<const char*>(&net_res_len), sizeof(net_res_len), 0) == -1)
+    // 4바이트 길이 접두사와 메시지를 한 번에 전송 (요청 응답, 카메라 명령 알림과 섞이지 않도록 세션 단위로 직렬화)
+    if (!send_framed_json(ssl, response))
     {
-        std::cout << "[TCP Server] Failed to send length prefix" << std::endl;
+        std::cout << "[TCP Server] Failed to send bboxes" << std::endl;
         return false;
     }
-    // 그 다음 실제 JSON 데이터 전송
-    int ret = sendAll(ssl, json_str.c_str(), res_len, 0);
-    if (ret == -1)
-    {
-        std::cout << "[TCP Server] Failed to send JSON data" << std::endl;
-    }
-    return ret != -1;
+    return true;
 }
\ No newline at end of file
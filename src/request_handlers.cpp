@@ -6,16 +6,26 @@
  */
 
 #include "request_handlers.hpp"
+#include "camera_command_queue.hpp"
+#include "camera_line_cache.hpp"
+#include "client_session.hpp"
+#include "config_manager.hpp"
 #include "curl_camera.hpp"
+#include "db_retention.hpp"
 #include "hash.hpp"
+#include "line_config_store.hpp"
 #include "metadata_parser.hpp"
 #include "otp/otp_manager.hpp"
 #include "tcp_server.hpp"
 #include "utils.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <limits>
 #include <memory>
 #include <random>
+#include <unordered_set>
 
 // OTP 관련 전역 변수
 static OTPManager otp_manager;
@@ -24,18 +34,86 @@ static OTPManager otp_manager;
 
 /**
  * @brief JSON 객체를 직렬화하여 SSL을 통해 클라이언트로 전송합니다.
- * @details 이 함수는 JSON 객체를 문자열로 변환한 후, SSL을 통해 클라이언트로 전송합니다.
+ * @details 이 함수는 JSON 객체를 연결에서 협상한 인코딩(기본값 JSON 텍스트)으로 직렬화한 후, SSL을 통해 클라이언트로
+ * 전송합니다.
  * @param ssl OpenSSL SSL 포인터
  * @param response 전송할 JSON 객체
  */
 void send_json_response(SSL* ssl, const json& response)
 {
-    string json_string = response.dump();
-    uint32_t res_len = json_string.length();
-    uint32_t net_res_len = htonl(res_len);
+    // 같은 연결에 쓰는 다른 스레드(BBox push, 카메라 명령 알림)와 섞이지 않도록 세션 단위로 직렬화
+    send_framed_json(ssl, response);
+}
+
+/**
+ * @brief 카메라 명령 완료를 클라이언트에 알리는 콜백을 만듭니다. (request_id == 40)
+ * @details 콜백은 연결 세션을 weak_ptr로만 보관하므로, 명령이 끝나기 전에 연결이 끊겼으면 알림을 보내지 않습니다.
+ * @param ssl OpenSSL SSL 포인터 (요청을 처리 중인 연결)
+ * @param source_request_id 명령을 만든 요청의 request_id
+ * @return 완료 콜백
+ */
+static CameraCommandCallback camera_command_notifier(SSL* ssl, int source_request_id)
+{
+    weak_ptr<ClientSession> weak_session = ClientSession::from(ssl);
+    return [weak_session, source_request_id](const CameraCommandResult& result)
+    {
+        auto session = weak_session.lock();
+        if (!session)
+        {
+            return;
+        }
 
-    sendAll(ssl, reinterpret_cast<const char*>(&net_res_len), sizeof(net_res_len), 0);
-    sendAll(ssl, json_string.c_str(), res_len, 0);
+        json root;
+        root["request_id"] = 40;
+        root["command_id"] = result.command_id;
+        root["source_request_id"] = source_request_id;
+        root["status"] = camera_command_status_name(result.status);
+        root["indexes"] = result.indexes;
+        root["failed_indexes"] = result.failed_indexes;
+        session->send_json(root);
+    };
+}
+
+/**
+ * @brief 조회 범위의 시작/종료 타임스탬프를 epoch 밀리초로 변환합니다.
+ * @details 생략된 경계는 호출자가 넣어 둔 기본값을 유지합니다. 형식이 잘못된 경계를 열린 범위로 바꾸어 조회하지 않도록
+ *          오류 응답({"request_id": response_id, "error": "invalid_timestamp", ...})을 보내고 false를 반환합니다.
+ * @param ssl OpenSSL SSL 포인터
+ * @param response_id 오류 응답에 사용할 request_id
+ * @param start_ts 시작 타임스탬프 문자열 (빈 문자열이면 생략)
+ * @param end_ts 종료 타임스탬프 문자열 (빈 문자열이면 생략)
+ * @param start_ms 시작 epoch 밀리초 (입출력)
+ * @param end_ms 종료 epoch 밀리초 (입출력)
+ * @return 두 경계가 모두 유효하면 true, 오류 응답을 보냈으면 false
+ */
+static bool parse_timestamp_range(SSL* ssl, int response_id, const string& start_ts, const string& end_ts,
+                                  long long& start_ms, long long& end_ms)
+{
+    string invalid_field, invalid_value;
+    if (!start_ts.empty() && !parse_timestamp_ms(start_ts, start_ms))
+    {
+        invalid_field = "start_timestamp";
+        invalid_value = start_ts;
+    }
+    else if (!end_ts.empty() && !parse_timestamp_ms(end_ts, end_ms))
+    {
+        invalid_field = "end_timestamp";
+        invalid_value = end_ts;
+    }
+    else
+    {
+        return true;
+    }
+
+    cerr << "[Thread " << std::this_thread::get_id() << "] 타임스탬프 형식 오류 (" << invalid_field
+         << "): " << invalid_value << endl;
+    json root;
+    root["request_id"] = response_id;
+    root["error"] = "invalid_timestamp";
+    root["field"] = invalid_field;
+    root["message"] = "타임스탬프 형식이 올바르지 않습니다: " + invalid_value;
+    send_json_response(ssl, root);
+    return false;
 }
 
 // ==================== 요청 처리 함수들 ====================
@@ -44,22 +122,36 @@ void send_json_response(SSL* ssl, const json& response)
  * @brief 감지 데이터 조회 요청을 처리합니다. (request_id == 1)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_detection_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_detection_request(SSL* ssl, const json& received_json, DatabasePool& db_pool)
 {
     // request_id == 1: 클라이언트의 이미지&텍스트 요청(select) 신호
     string start_ts = received_json["data"].value("start_timestamp", "");
     string end_ts = received_json["data"].value("end_timestamp", "");
+    // include_image == false이면 이미지 없이 목록(id, 시각)만 응답 (BLOB 페이지를 읽지 않음)
+    bool include_image = received_json["data"].value("include_image", true);
+
+    // 시간 범위를 epoch 밀리초로 변환 (생략된 경계는 열린 범위, 형식이 잘못된 경계는 오류 응답)
+    long long start_ms = 0;
+    long long end_ms = numeric_limits<long long>::max();
+    if (!parse_timestamp_range(ssl, 10, start_ts, end_ts, start_ms, end_ms))
+    {
+        return;
+    }
 
     vector<Detection> detections;
-    // --- DB 접근 시 Mutex로 보호 ---
+    // --- 읽기 전용 연결에서 조회 (다른 클라이언트의 조회와 동시에 실행됨) ---
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작 (Lock 획득)" << endl;
-        detections = select_data_for_timestamp_range_detections(db, start_ts, end_ts);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료 (Lock 해제)" << endl;
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작" << endl;
+        detections = db_pool.read(
+            [&](SQLite::Database& db)
+            {
+                if (include_image)
+                    return select_data_for_timestamp_range_detections(db, start_ms, end_ms);
+                return select_list_for_timestamp_range_detections(db, start_ms, end_ms);
+            });
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료" << endl;
     }
 
     json root;
@@ -68,8 +160,11 @@ void handle_detection_request(SSL* ssl, const json& received_json, SQLite::Datab
     for (const auto& detection : detections)
     {
         json d_obj;
-        d_obj["image"] = base64_encode(detection.imageBlob);
+        d_obj["id"] = detection.id;
+        if (include_image)
+            d_obj["image"] = base64_encode(detection.imageBlob);
         d_obj["timestamp"] = detection.timestamp;
+        d_obj["timestamp_ms"] = detection.timestamp_ms;
         data_array.push_back(d_obj);
     }
     root["data"] = data_array;
@@ -85,10 +180,8 @@ void handle_detection_request(SSL* ssl, const json& received_json, SQLite::Datab
  * @brief 감지선 좌표값 삽입 요청을 처리합니다. (request_id == 2)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_line_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_line_insert_request(SSL* ssl, const json& received_json)
 {
     // request_id == 2: 클라이언트의 감지선 좌표값 삽입(insert) 신호
     int index = received_json["data"].value("index", -1);
@@ -105,35 +198,32 @@ void handle_line_insert_request(SSL* ssl, const json& received_json, SQLite::Dat
 
     bool mappingSuccess;
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 시작 (Lock 획득)" << endl;
-        mappingSuccess = insert_data_lines(db, insertCrossLine);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 완료 (Lock 해제)" << endl;
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 요청 (쓰기 큐)" << endl;
+        mappingSuccess = g_line_config.insert_line(insertCrossLine);
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 완료" << endl;
     }
 
     if (camera_type == "CCTV")
     {
-        putLines(curlCrossLine);
+        // CCTV 반영은 명령 큐에서 비동기로 실행하고 바로 응답 (반영되면 request_id 40으로 알림)
+        uint64_t commandId = g_camera_commands.submit_put({curlCrossLine}, camera_command_notifier(ssl, 2));
 
         json root;
         root["request_id"] = 11;
         root["mapping_success"] = (mappingSuccess == true) ? 1 : 0;
+        root["camera_status"] = "accepted";
+        root["camera_command_id"] = commandId;
         send_json_response(ssl, root);
     }
     else
     {
-        vector<CrossLine> dbLines;
-        {
-            std::lock_guard<std::mutex> lock(db_mutex);
-            cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작 (Lock 획득)" << endl;
-            dbLines = select_all_data_lines(db);
-            cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료 (Lock 해제)" << endl;
-        }
+        // 메모리 스냅샷에서 조회 (DB 접근 없음)
+        auto config = g_line_config.snapshot();
 
         json root;
         root["request_id"] = 18;
         json data_array = json::array();
-        for (const auto& line : dbLines)
+        for (const auto& line : config->lines)
         {
             json d_obj;
             d_obj["index"] = line.index;
@@ -153,69 +243,202 @@ void handle_line_insert_request(SSL* ssl, const json& received_json, SQLite::Dat
 }
 
 /**
- * @brief 감지선 전체 조회 요청을 처리합니다. (request_id == 3)
+ * @brief 여러 감지선 일괄 삽입 요청을 처리합니다. (request_id == 33)
+ * @details DB에는 하나의 트랜잭션으로 반영하고, CCTV에는 명령 큐를 통해 모든 감지선을 담은 PUT 요청으로 반영합니다.
  * @param ssl OpenSSL SSL 포인터
- * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param received_json 수신된 JSON 요청 ("data" 배열의 각 항목은 request_id 2의 "data"와 같은 형식)
  */
-void handle_line_select_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_line_batch_insert_request(SSL* ssl, const json& received_json)
 {
-    // request_id == 3: 클라이언트의 감지선 좌표값 요청(select all) 신호
-    vector<CrossLine> httpLines;
-    json j = json::parse(getLines());
+    // request_id == 33: 클라이언트의 감지선 좌표값 일괄 삽입(insert) 신호
+    string camera_type = received_json.value("camera_type", "CCTV");
 
-    // "lineCrossing" 배열의 첫 번째 요소 안에 있는 "line" 배열을 순회
-    for (const auto& item : j["lineCrossing"][0]["line"])
+    vector<CrossLine> curlCrossLines;
+    vector<CrossLine> insertCrossLines;
+    for (const auto& item : received_json.value("data", json::array()))
     {
-        CrossLine cl;
-        cl.index = item["index"];
-        cl.name = item["name"];
-        cl.mode = item["mode"];
-        cl.x1 = item["lineCoordinates"][0]["x"];
-        cl.y1 = item["lineCoordinates"][0]["y"];
-        cl.x2 = item["lineCoordinates"][1]["x"];
-        cl.y2 = item["lineCoordinates"][1]["y"];
-        httpLines.push_back(cl);
+        int index = item.value("index", -1);
+        int x1 = item.value("x1", -1);
+        int y1 = item.value("y1", -1);
+        int x2 = item.value("x2", -1);
+        int y2 = item.value("y2", -1);
+        string name = item.value("name", "name1");
+        string mode = item.value("mode", "BothDirections");
+
+        curlCrossLines.push_back({index, x1 * 4, y1 * 4, x2 * 4, y2 * 4, name, mode});
+        insertCrossLines.push_back({index, x1, y1, x2, y2, name, mode});
     }
 
-    vector<CrossLine> dbLines;
+    bool mappingSuccess;
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작 (Lock 획득)" << endl;
-        dbLines = select_all_data_lines(db);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료 (Lock 해제)" << endl;
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 일괄 삽입 요청 (쓰기 큐, " << insertCrossLines.size()
+             << "개)" << endl;
+        mappingSuccess = g_line_config.insert_lines(insertCrossLines);
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 일괄 삽입 완료" << endl;
     }
 
-    // 일치하는 라인만 찾기
-    vector<CrossLine> realLines;
-    for (auto httpLine : httpLines)
+    json root;
+    root["request_id"] = 34;
+    root["mapping_success"] = (mappingSuccess == true) ? 1 : 0;
+    root["count"] = insertCrossLines.size();
+    if (camera_type == "CCTV")
+    {
+        // CCTV 반영은 명령 큐에서 비동기로 실행하고 바로 응답 (반영되면 request_id 40으로 알림)
+        root["camera_status"] = "accepted";
+        root["camera_command_id"] = g_camera_commands.submit_put(curlCrossLines, camera_command_notifier(ssl, 33));
+    }
+    else
     {
-        for (auto dbLine : dbLines)
+        // 메모리 스냅샷에서 조회 (DB 접근 없음)
+        auto config = g_line_config.snapshot();
+
+        json data_array = json::array();
+        for (const auto& line : config->lines)
         {
-            if (httpLine.index == dbLine.index)
-            {
-                realLines.push_back(dbLine);
-            }
+            json d_obj;
+            d_obj["index"] = line.index;
+            d_obj["x1"] = line.x1;
+            d_obj["y1"] = line.y1;
+            d_obj["x2"] = line.x2;
+            d_obj["y2"] = line.y2;
+            d_obj["name"] = line.name;
+            d_obj["mode"] = line.mode;
+            data_array.push_back(d_obj);
+        }
+        root["data"] = data_array;
+    }
+    send_json_response(ssl, root);
+    cout << "[Thread " << std::this_thread::get_id() << "] 응답 전송 완료." << endl;
+}
+
+/**
+ * @brief 연결별 메시지 압축/인코딩 협상 요청을 처리합니다. (request_id == 37)
+ * @details data.compression에 클라이언트가 해제할 수 있는 압축 방식을, data.encoding에 읽을 수 있는 메시지
+ *          인코딩("msgpack", "cbor", "json")을 선호 순서대로 받아 각각 서버가 지원하는 첫 번째 방식을 고릅니다.
+ *          생략한 항목은 압축 없음, JSON으로 정합니다. 응답(request_id 38)은 협상 전 인코딩으로 압축하지 않고
+ *          보내며, 이후 이 연결의 메시지는 양방향 모두 새 인코딩으로 직렬화하고 임계값 이상이면 길이 접두사의
+ *          최상위 비트를 켜고 압축합니다.
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_codec_negotiation_request(SSL* ssl, const json& received_json)
+{
+    // request_id == 37: 압축 방식과 메시지 인코딩 협상 (각 목록에서 서버가 지원하는 첫 항목 선택)
+    json data = received_json.value("data", json::object());
+    CompressionCodec codec = CompressionCodec::None;
+    for (const auto& name : data.value("compression", json::array()))
+    {
+        if (name.is_string() && (codec = parse_compression_codec(name.get<string>())) != CompressionCodec::None)
+        {
+            break;
         }
     }
+    MessageEncoding encoding = MessageEncoding::Json;
+    for (const auto& name : data.value("encoding", json::array()))
+    {
+        if (name.is_string() && parse_message_encoding(name.get<string>(), encoding))
+        {
+            break;
+        }
+    }
+
+    json root;
+    root["request_id"] = 38;
+    root["compression"] = compression_codec_name(codec);
+    root["compression_threshold"] = g_config.compression_threshold_bytes;
+    root["supported_compression"] = supported_compression_codecs();
+    root["encoding"] = message_encoding_name(encoding);
+    root["supported_encoding"] = supported_message_encodings();
+
+    // 응답은 이전 인코딩, 압축 없이 보내고 그 다음 메시지부터 양방향 모두 새 방식 적용
+    auto session = ClientSession::from(ssl);
+    if (!session)
+    {
+        send_json_response(ssl, root);
+        return;
+    }
+    session->send_json_and_switch_encoding(root, encoding);
+    int level = codec == CompressionCodec::Zstd ? g_config.compression_zstd_level : g_config.compression_deflate_level;
+    session->enable_compression(codec, level, g_config.compression_threshold_bytes,
+                                g_config.compression_max_message_bytes);
+    cout << "[Thread " << std::this_thread::get_id() << "] 코덱 협상 완료 (압축 " << compression_codec_name(codec)
+         << ", 인코딩 " << message_encoding_name(encoding) << ")" << endl;
+}
 
-    // lines 테이블 비우고 실제 CCTV에 있는 가상선으로만 DB 채우기
+/**
+ * @brief 연결 유지 확인(heartbeat) 요청을 처리합니다. (request_id == 35)
+ * @details 첫 heartbeat부터 이 연결에 수신 유휴 시간 초과를 적용합니다. 클라이언트는 idle_timeout_sec보다 짧은
+ *          간격(1/3 권장)으로 heartbeat를 보내야 하며, 그 사이 다른 요청을 보내도 유휴 시간은 다시 시작됩니다.
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_heartbeat_request(SSL* ssl, const json& received_json)
+{
+    // request_id == 35: 연결 유지 확인 (seq는 그대로 돌려줌)
+    auto session = ClientSession::from(ssl);
+    if (session)
+    {
+        session->enable_idle_timeout(chrono::seconds(max(0, g_config.connection_idle_timeout_sec)));
+    }
+
+    json root;
+    root["request_id"] = 36;
+    root["idle_timeout_sec"] = g_config.connection_idle_timeout_sec;
+    root["server_time_ms"] =
+        chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    if (received_json.contains("seq"))
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삭제 시작 (Lock 획득)" << endl;
-        delete_all_data_lines(db);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삭제 완료 (Lock 해제)" << endl;
+        root["seq"] = received_json["seq"];
     }
+    send_json_response(ssl, root);
+}
 
-    for (auto realLine : realLines)
+/**
+ * @brief 감지선 전체 조회 요청을 처리합니다. (request_id == 3)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_line_select_all_request(SSL* ssl, const json& received_json)
+{
+    // request_id == 3: 클라이언트의 감지선 좌표값 요청(select all) 신호
+    // 아직 CCTV에 반영되지 않은 추가 명령의 감지선은 CCTV에 있는 것으로 취급 (캐시보다 먼저 읽어야 누락이 없음)
+    vector<int> pendingIndexes = g_camera_commands.pending_put_indexes();
+
+    // CCTV 감지선은 캐시에서 조회 (카메라에 접근하지 않음, 최신 여부는 스냅샷보다 먼저 확인)
+    bool cameraCurrent = g_camera_lines.is_current();
+    auto camera = g_camera_lines.lines();
+
+    // 메모리 스냅샷에서 조회 (DB 접근 없음)
+    auto config = g_line_config.snapshot();
+
+    vector<CrossLine> realLines;
+    if (!camera->valid || !cameraCurrent)
     {
+        // CCTV 상태를 모르거나 반영된 쓰기가 아직 캐시에 없으면 DB를 건드리지 않고 저장된 감지선으로 응답
+        cerr << "[Thread " << std::this_thread::get_id() << "] CCTV 감지선 캐시가 최신이 아니어서 DB 감지선으로 "
+             << "응답합니다." << endl;
+        realLines = config->lines;
+    }
+    else
+    {
+        // 실제 CCTV에 있는 index의 라인만 찾기 (해시 집합으로 O(n + m))
+        unordered_set<int> cameraIndexes(pendingIndexes.begin(), pendingIndexes.end());
+        for (const auto& cameraLine : camera->lines)
         {
-            std::lock_guard<std::mutex> lock(db_mutex);
-            cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 시작 (Lock 획득)" << endl;
-            insert_data_lines(db, realLine);
-            cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 완료 (Lock 해제)" << endl;
+            cameraIndexes.insert(cameraLine.index);
+        }
+        for (const auto& dbLine : config->lines)
+        {
+            if (cameraIndexes.count(dbLine.index) > 0)
+            {
+                realLines.push_back(dbLine);
+            }
         }
+
+        // CCTV에 없는 가상선만 DB에서 삭제 (바뀐 행만 하나의 트랜잭션으로 반영)
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 동기화 요청 (쓰기 큐)" << endl;
+        g_line_config.replace_lines(realLines);
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 동기화 완료" << endl;
     }
 
     json root;
@@ -242,39 +465,45 @@ void handle_line_select_all_request(SSL* ssl, const json& received_json, SQLite:
  * @brief 감지선, 기준선, 수직선 전체 삭제 요청을 처리합니다. (request_id == 4)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_line_delete_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_line_delete_all_request(SSL* ssl, const json& received_json)
 {
     // request_id == 4: 클라이언트의 감지선, 기준선, 수직선 전체 삭제 신호
-    vector<int> indexs;
-    json j = json::parse(getLines());
-
-    for (const auto& item : j["lineCrossing"][0]["line"])
+    // CCTV에 있거나 반영 대기 중인 감지선을 모두 삭제 대상으로 (대기 중인 추가 명령은 삭제로 대체됨)
+    // CCTV 감지선은 카메라에 접근하지 않고 캐시 스냅샷으로 조회
+    vector<int> indexs = g_camera_commands.pending_put_indexes();
+    bool cameraCurrent = g_camera_lines.is_current();
+    auto camera = g_camera_lines.lines();
+    for (const auto& cameraLine : camera->lines)
     {
-        indexs.push_back(item["index"]);
+        indexs.push_back(cameraLine.index);
     }
-
-    for (int index : indexs)
+    // 캐시가 최신이 아니면 이미 반영되었지만 아직 캐시에 없는 감지선이 있을 수 있으므로 저장된 감지선도 포함
+    if (!camera->valid || !cameraCurrent)
     {
-        deleteLines(index);
+        for (const auto& line : g_line_config.snapshot()->lines)
+        {
+            indexs.push_back(line.index);
+        }
     }
+    sort(indexs.begin(), indexs.end());
+    indexs.erase(unique(indexs.begin(), indexs.end()), indexs.end());
+
+    // CCTV 삭제는 명령 큐에서 동시 DELETE로 실행하고 바로 응답 (반영되면 request_id 40으로 알림)
+    uint64_t commandId = g_camera_commands.submit_delete(indexs, camera_command_notifier(ssl, 4));
 
     bool deleteSuccess = true;
     // DB에서 모든 라인 데이터 삭제
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작 (Lock 획득)" << endl;
-        deleteSuccess &= delete_all_data_lines(db);
-        deleteSuccess &= delete_all_data_baseLines(db);
-        deleteSuccess &= delete_all_data_verticalLineEquations(db);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료 (Lock 해제)" << endl;
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삭제 요청 (쓰기 큐)" << endl;
+        deleteSuccess = g_line_config.clear_all();
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삭제 완료" << endl;
     }
 
     json root;
     root["request_id"] = 13;
     root["delete_success"] = (deleteSuccess == true) ? 1 : 0;
+    root["camera_command_id"] = commandId;
     send_json_response(ssl, root);
     cout << "[Thread " << std::this_thread::get_id() << "] 응답 전송 완료." << endl;
 }
@@ -283,10 +512,8 @@ void handle_line_delete_all_request(SSL* ssl, const json& received_json, SQLite:
  * @brief 도로 기준선 삽입 요청을 처리합니다. (request_id == 5)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_baseline_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_baseline_insert_request(SSL* ssl, const json& received_json)
 {
     // request_id == 5: 클라이언트의 도로기준선 insert 신호
     int index = received_json["data"].value("index", -1);
@@ -301,11 +528,9 @@ void handle_baseline_insert_request(SSL* ssl, const json& received_json, SQLite:
 
     bool insertSuccess, updateSuccess;
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 시작 (Lock 획득)" << endl;
-        insertSuccess = insert_data_baseLines(db, baseLine);
-        updateSuccess = update_data_baseLines(db, baseLine);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입/수정 완료 (Lock 해제)" << endl;
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 요청 (쓰기 큐)" << endl;
+        g_line_config.upsert_baseline(baseLine, insertSuccess, updateSuccess);
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입/수정 완료" << endl;
     }
 
     json root;
@@ -320,11 +545,8 @@ void handle_baseline_insert_request(SSL* ssl, const json& received_json, SQLite:
  * @brief 감지선의 수직선 방정식 삽입 요청을 처리합니다. (request_id == 6)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_vertical_line_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db,
-                                         std::mutex& db_mutex)
+void handle_vertical_line_insert_request(SSL* ssl, const json& received_json)
 {
     // request_id == 6: 클라이언트 감지선의 수직선 방정식 insert 신호
     int index = received_json["data"].value("index", -1);
@@ -335,10 +557,9 @@ void handle_vertical_line_insert_request(SSL* ssl, const json& received_json, SQ
 
     bool insertSuccess;
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 시작 (Lock 획득)" << endl;
-        insertSuccess = insert_data_verticalLineEquations(db, verticalLineEquation);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 완료 (Lock 해제)" << endl;
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 요청 (쓰기 큐)" << endl;
+        insertSuccess = g_line_config.insert_vertical_line(verticalLineEquation);
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 삽입 완료" << endl;
     }
 
     json root;
@@ -352,24 +573,17 @@ void handle_vertical_line_insert_request(SSL* ssl, const json& received_json, SQ
  * @brief 도로 기준선 전체 조회 요청을 처리합니다. (request_id == 7)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_baseline_select_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_baseline_select_all_request(SSL* ssl, const json& received_json)
 {
     // request_id == 7: 클라이언트 도로기준선 select all(동기화) 신호
-    vector<BaseLine> baseLines;
-    {
-        std::lock_guard<std::mutex> lock(db_mutex);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작 (Lock 획득)" << endl;
-        baseLines = select_all_data_baseLines(db);
-        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료 (Lock 해제)" << endl;
-    }
+    // 메모리 스냅샷에서 조회 (DB 접근 없음)
+    auto config = g_line_config.snapshot();
 
     json root;
     root["request_id"] = 16;
     json data_array = json::array();
-    for (const auto& baseLine : baseLines)
+    for (const auto& baseLine : config->baseLines)
     {
         json d_obj;
         d_obj["index"] = baseLine.index;
@@ -390,10 +604,9 @@ void handle_baseline_select_all_request(SSL* ssl, const json& received_json, SQL
  * @brief 1단계 로그인 요청(ID/PW 검증)을 처리합니다. (request_id == 8)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_login_step1_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_login_step1_request(SSL* ssl, const json& received_json, DatabasePool& db_pool)
 {
     // request_id == 8: 1단계 로그인 요청 (ID/PW 검증)
     cout << "[로그인] 1단계 로그인 요청 수신 (ID/PW 검증)" << endl;
@@ -409,9 +622,8 @@ void handle_login_step1_request(SSL* ssl, const json& received_json, SQLite::Dat
 
     Account* accountPtr = nullptr;
     {
-        std::lock_guard<std::mutex> lock(db_mutex);
         cout << "[DB] ID로 계정 조회 시도 (ID: " << id << ")" << endl;
-        accountPtr = get_account_by_id(db, id);
+        accountPtr = db_pool.read([&](SQLite::Database& db) { return get_account_by_id(db, id); });
     }
 
     json root;
@@ -466,10 +678,9 @@ void handle_login_step1_request(SSL* ssl, const json& received_json, SQLite::Dat
  * @brief 2단계 로그인 요청(OTP/복구코드 검증)을 처리합니다. (request_id == 22)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_login_step2_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_login_step2_request(SSL* ssl, const json& received_json, DatabasePool& db_pool)
 {
     // request_id == 22: OTP/복구코드 검증 요청
     cout << "[로그인] 2단계 로그인 요청 수신 (OTP/복구코드 검증)" << endl;
@@ -502,23 +713,23 @@ void handle_login_step2_request(SSL* ssl, const json& received_json, SQLite::Dat
         }
         else
         {
-            // 복구 코드 검증
+            // 복구 코드 검증 (해시마다 argon2 검증을 하므로 읽기 연결로 목록만 가져와 쓰기 스레드 밖에서 비교)
+            cout << "[DB] 복구 코드 검증 시도 (ID: " << id << ")" << endl;
+            vector<string> hashed_codes =
+                db_pool.read([&](SQLite::Database& db) { return get_hashed_recovery_codes(db, id); });
+            string matched_hash = match_recovery_code(hashed_codes, input);
+
+            // 쓰기 스레드에서는 아직 사용되지 않은 경우에만 무효화 (동시에 같은 코드를 쓴 요청은 하나만 성공)
+            if (!matched_hash.empty() &&
+                db_pool.write([&](SQLite::Database& db) { return consume_recovery_code(db, id, matched_hash); }))
             {
-                std::lock_guard<std::mutex> lock(db_mutex);
-                cout << "[DB] 복구 코드 검증 시도 (ID: " << id << ")" << endl;
-                if (verify_recovery_code(db, id, input))
-                {
-                    cout << "[로그인] 복구 코드 검증 성공 (ID: " << id << ")" << endl;
-                    finalLoginSuccess = true;
-                    is_recovery_code = true;
-                    // 사용된 복구 코드 무효화
-                    invalidate_recovery_code(db, id, input);
-                    cout << "[DB] 사용된 복구 코드 무효화 완료 (ID: " << id << ")" << endl;
-                }
-                else
-                {
-                    cout << "[로그인] 복구 코드 검증 실패 (ID: " << id << ")" << endl;
-                }
+                cout << "[로그인] 복구 코드 검증 성공, 사용된 복구 코드 무효화 완료 (ID: " << id << ")" << endl;
+                finalLoginSuccess = true;
+                is_recovery_code = true;
+            }
+            else
+            {
+                cout << "[로그인] 복구 코드 검증 실패 (ID: " << id << ")" << endl;
             }
         }
     }
@@ -553,10 +764,9 @@ void handle_login_step2_request(SSL* ssl, const json& received_json, SQLite::Dat
  * @brief 회원가입 요청을 처리합니다. (request_id == 9)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_signup_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex)
+void handle_signup_request(SSL* ssl, const json& received_json, DatabasePool& db_pool)
 {
     // request_id == 9: 회원가입 요청
     cout << "[회원가입] 회원가입 요청 수신" << endl;
@@ -598,20 +808,32 @@ void handle_signup_request(SSL* ssl, const json& received_json, SQLite::Database
         }
 
         Account account = {id, hashed_passwd, otp_secret, use_otp};
+        // 복구 코드 해싱은 쓰기 스레드를 오래 점유하지 않도록 미리 수행
+        vector<string> hashed_codes;
+        if (use_otp)
         {
-            std::lock_guard<std::mutex> lock(db_mutex);
-            cout << "[DB] 계정 정보 삽입 시도 (ID: " << id << ")" << endl;
-            signUpSuccess = insert_data_accounts(db, account);
-
-            if (signUpSuccess && use_otp)
-            {
-                // OTP secret 저장
-                store_otp_secret(db, id, otp_secret);
-                // 복구 코드 저장
-                auto hashed_codes = hash_recovery_codes(recovery_codes);
-                store_recovery_codes(db, id, hashed_codes);
-            }
+            hashed_codes = hash_recovery_codes(recovery_codes);
         }
+        db_pool.write(
+            [&](SQLite::Database& db)
+            {
+                // 계정, OTP secret, 복구 코드를 한 트랜잭션으로 저장 (하나라도 실패하면 계정도 만들지 않음)
+                SQLite::Transaction transaction(db);
+                cout << "[DB] 계정 정보 삽입 시도 (ID: " << id << ")" << endl;
+                signUpSuccess = insert_data_accounts(db, account);
+
+                if (signUpSuccess && use_otp)
+                {
+                    // OTP secret 저장
+                    signUpSuccess = store_otp_secret(db, id, otp_secret);
+                    // 복구 코드 저장
+                    signUpSuccess = signUpSuccess && store_recovery_codes(db, id, hashed_codes);
+                }
+                if (signUpSuccess)
+                {
+                    transaction.commit();
+                }
+            });
 
         if (signUpSuccess)
         {
@@ -653,6 +875,187 @@ void handle_signup_request(SSL* ssl, const json& received_json, SQLite::Database
     cout << "[Debug] 복구 코드 메모리에서 삭제 완료." << endl;
 }
 
+/**
+ * @brief 감지 데이터 보존 상태 조회 요청을 처리합니다. (request_id == 24)
+ * @details DB 파일/사용 크기와 보존 스레드의 삭제 통계를 응답합니다.
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_retention_stats_request(SSL* ssl, const json& received_json)
+{
+    // request_id == 24: 감지 데이터 보존 상태 조회
+    RetentionStats stats = g_retention.get_stats();
+
+    json root;
+    root["request_id"] = 25;
+    root["file_bytes"] = stats.file_bytes;
+    root["used_bytes"] = stats.used_bytes;
+    root["freelist_bytes"] = stats.freelist_bytes;
+    root["total_purged_rows"] = stats.total_purged_rows;
+    root["last_purged_rows"] = stats.last_purged_rows;
+    root["total_vacuumed_pages"] = stats.total_vacuumed_pages;
+    root["runs"] = stats.runs;
+    root["last_run_duration_ms"] = stats.last_run_duration_ms;
+    root["last_run_epoch_sec"] = stats.last_run_epoch_sec;
+    root["incremental_vacuum"] = stats.incremental_vacuum ? 1 : 0;
+    send_json_response(ssl, root);
+    cout << "[Thread " << std::this_thread::get_id() << "] 응답 전송 완료." << endl;
+}
+
+/**
+ * @brief 감지 이벤트 필터 조회 요청을 처리합니다. (request_id == 26)
+ * @details 감지선(rule_name), 보드(board_id), 시간 범위로 필터링하여 이미지 없이 건수 또는 목록을 응답합니다.
+ *          mode == "count"이면 bucket_sec 단위 구간별 건수를, mode == "list"이면 이벤트 메타데이터 목록을 응답합니다.
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ * @param db_pool DB 연결 풀
+ */
+void handle_detection_event_query_request(SSL* ssl, const json& received_json, DatabasePool& db_pool)
+{
+    // request_id == 26: 감지 이벤트 필터 조회 (이미지 제외)
+    const json data = received_json.value("data", json::object());
+    string start_ts = data.value("start_timestamp", "");
+    string end_ts = data.value("end_timestamp", "");
+    string mode = data.value("mode", "count");
+    long long bucket_sec = data.value("bucket_sec", 0LL);
+
+    DetectionFilter filter;
+    filter.end_ms = numeric_limits<long long>::max();
+    filter.rule_name = data.value("rule_name", "");
+    filter.board_id = data.value("board_id", -1);
+    filter.limit = data.value("limit", 0);
+    if (!parse_timestamp_range(ssl, 27, start_ts, end_ts, filter.start_ms, filter.end_ms))
+    {
+        return;
+    }
+
+    json root;
+    root["request_id"] = 27;
+    root["mode"] = mode;
+
+    if (mode == "list")
+    {
+        vector<Detection> detections;
+        {
+            cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작" << endl;
+            detections = db_pool.read([&](SQLite::Database& db) { return select_events_detections(db, filter); });
+            cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료" << endl;
+        }
+
+        json data_array = json::array();
+        for (const auto& detection : detections)
+        {
+            json d_obj;
+            d_obj["id"] = detection.id;
+            d_obj["timestamp"] = detection.timestamp;
+            d_obj["timestamp_ms"] = detection.timestamp_ms;
+            d_obj["human_id"] = detection.human_id;
+            d_obj["rule_name"] = detection.rule_name;
+            d_obj["vehicle_id"] = detection.vehicle_id;
+            d_obj["board_id"] = detection.board_id;
+            d_obj["similarity"] = detection.similarity;
+            data_array.push_back(d_obj);
+        }
+        root["total"] = data_array.size();
+        root["data"] = data_array;
+    }
+    else
+    {
+        vector<DetectionBucket> buckets;
+        {
+            cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작" << endl;
+            buckets = db_pool.read([&](SQLite::Database& db)
+                                   { return count_detections_by_bucket(db, filter, bucket_sec * 1000); });
+            cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료" << endl;
+        }
+
+        long long total = 0;
+        json bucket_array = json::array();
+        for (const auto& bucket : buckets)
+        {
+            total += bucket.count;
+            if (bucket_sec > 0)
+            {
+                json b_obj;
+                b_obj["start_ms"] = bucket.bucket_start_ms;
+                b_obj["start"] = format_kst_timestamp(bucket.bucket_start_ms);
+                b_obj["count"] = bucket.count;
+                bucket_array.push_back(b_obj);
+            }
+        }
+        root["total"] = total;
+        root["bucket_sec"] = bucket_sec;
+        root["buckets"] = bucket_array;
+    }
+
+    send_json_response(ssl, root);
+    cout << "[Thread " << std::this_thread::get_id() << "] 응답 전송 완료." << endl;
+}
+
+/**
+ * @brief 감지 통계(집계) 조회 요청을 처리합니다. (request_id == 28)
+ * @details 1시간 단위 집계 테이블에서 bucket("hour" 또는 "day") 구간별, group_by("line", "board", "none") 기준 감지
+ *          건수를 응답합니다. 시작/종료 시각을 생략하면 최근 30일을 조회합니다.
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ * @param db_pool DB 연결 풀
+ */
+void handle_detection_rollup_request(SSL* ssl, const json& received_json, DatabasePool& db_pool)
+{
+    // request_id == 28: 감지 통계(집계) 조회
+    const json data = received_json.value("data", json::object());
+    string start_ts = data.value("start_timestamp", "");
+    string end_ts = data.value("end_timestamp", "");
+    string bucket = data.value("bucket", "hour");
+    string group_by = data.value("group_by", "none");
+    long long bucket_ms = (bucket == "day") ? 24LL * 3600 * 1000 : 3600LL * 1000;
+
+    long long now_ms = static_cast<long long>(time(nullptr)) * 1000;
+    DetectionFilter filter;
+    filter.start_ms = now_ms - 30LL * 24 * 3600 * 1000;
+    filter.end_ms = now_ms;
+    filter.rule_name = data.value("rule_name", "");
+    filter.board_id = data.value("board_id", -1);
+    if (!parse_timestamp_range(ssl, 29, start_ts, end_ts, filter.start_ms, filter.end_ms))
+    {
+        return;
+    }
+
+    vector<DetectionRollup> rollups;
+    {
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 시작" << endl;
+        rollups = db_pool.read([&](SQLite::Database& db)
+                               { return select_detection_rollups(db, filter, bucket_ms, group_by); });
+        cout << "[Thread " << std::this_thread::get_id() << "] DB 조회 완료" << endl;
+    }
+
+    json root;
+    root["request_id"] = 29;
+    root["bucket"] = (bucket == "day") ? "day" : "hour";
+    root["group_by"] = group_by;
+    long long total = 0;
+    json data_array = json::array();
+    for (const auto& rollup : rollups)
+    {
+        json r_obj;
+        r_obj["start_ms"] = rollup.bucket_start_ms;
+        r_obj["start"] = format_kst_timestamp(rollup.bucket_start_ms);
+        if (group_by == "line")
+            r_obj["rule_name"] = rollup.rule_name;
+        if (group_by == "board")
+            r_obj["board_id"] = rollup.board_id;
+        r_obj["count"] = rollup.count;
+        r_obj["avg_similarity"] = rollup.avg_similarity;
+        data_array.push_back(r_obj);
+        total += rollup.count;
+    }
+    root["total"] = total;
+    root["data"] = data_array;
+
+    send_json_response(ssl, root);
+    cout << "[Thread " << std::this_thread::get_id() << "] 응답 전송 완료." << endl;
+}
+
 /**
  * @brief BBox push 시작 요청을 처리합니다. (request_id == 31)
  * @param ssl OpenSSL SSL 포인터
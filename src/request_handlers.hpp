@@ -12,6 +12,7 @@
 #include <thread>
 
 #include "db_management.hpp"
+#include "db_pool.hpp"
 #include "json.hpp"
 #include "ssl.hpp"
 
@@ -22,93 +23,119 @@ using json = nlohmann::json;
  * @brief 감지 데이터 조회 요청을 처리합니다. (request_id == 1)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_detection_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_detection_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 감지선 좌표값 삽입 요청을 처리합니다. (request_id == 2)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_line_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_line_insert_request(SSL* ssl, const json& received_json);
+
+/**
+ * @brief 여러 감지선 일괄 삽입 요청을 처리합니다. (request_id == 33)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_line_batch_insert_request(SSL* ssl, const json& received_json);
+
+/**
+ * @brief 연결별 메시지 압축/인코딩 협상 요청을 처리합니다. (request_id == 37)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_codec_negotiation_request(SSL* ssl, const json& received_json);
+
+/**
+ * @brief 연결 유지 확인(heartbeat) 요청을 처리합니다. (request_id == 35)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_heartbeat_request(SSL* ssl, const json& received_json);
 
 /**
  * @brief 감지선 전체 조회 요청을 처리합니다. (request_id == 3)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_line_select_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_line_select_all_request(SSL* ssl, const json& received_json);
 
 /**
  * @brief 감지선, 기준선, 수직선 전체 삭제 요청을 처리합니다. (request_id == 4)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_line_delete_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_line_delete_all_request(SSL* ssl, const json& received_json);
 
 /**
  * @brief 도로 기준선 삽입 요청을 처리합니다. (request_id == 5)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_baseline_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_baseline_insert_request(SSL* ssl, const json& received_json);
 
 /**
  * @brief 감지선의 수직선 방정식 삽입 요청을 처리합니다. (request_id == 6)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_vertical_line_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db,
-                                         std::mutex& db_mutex);
+void handle_vertical_line_insert_request(SSL* ssl, const json& received_json);
 
 /**
  * @brief 도로 기준선 전체 조회 요청을 처리합니다. (request_id == 7)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
  */
-void handle_baseline_select_all_request(SSL* ssl, const json& received_json, SQLite::Database& db,
-                                        std::mutex& db_mutex);
+void handle_baseline_select_all_request(SSL* ssl, const json& received_json);
 
 /**
  * @brief 1단계 로그인 요청(ID/PW 검증)을 처리합니다. (request_id == 8)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_login_step1_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_login_step1_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 2단계 로그인 요청(OTP/복구코드 검증)을 처리합니다. (request_id == 22)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_login_step2_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_login_step2_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 회원가입 요청을 처리합니다. (request_id == 9)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
+ */
+void handle_signup_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
+
+/**
+ * @brief 감지 데이터 보존 상태 조회 요청을 처리합니다. (request_id == 24)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_retention_stats_request(SSL* ssl, const json& received_json);
+
+/**
+ * @brief 감지 이벤트 필터 조회 요청을 처리합니다. (request_id == 26)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ * @param db_pool DB 연결 풀
+ */
+void handle_detection_event_query_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
+
+/**
+ * @brief 감지 통계(집계) 조회 요청을 처리합니다. (request_id == 28)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ * @param db_pool DB 연결 풀
  */
-void handle_signup_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_detection_rollup_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief BBox push 시작 요청을 처리합니다. (request_id == 31)
@@ -9,12 +9,71 @@
 
 #include "rtsp_server.hpp"
 #include "config_manager.hpp"
+#include "listener_handoff.hpp"
+
+#include <mutex>
 
 #define CCTV_RTSP_PORT "8554"
 #define CCTV_MOUNT_POINT "/original"
 #define CCTV_MOUNT_POINT_ALT "/retransmit" // 기존 클라이언트 호환성을 위한 대체 경로
 #define NIGHT_CCTV_MOUNT_POINT "/night"
 
+/**
+ * @brief 실행 중인 메인 루프, 종료 요청 여부, 보호용 뮤텍스 (메인 루프를 만들기 전에 들어온 종료 요청도 놓치지 않기 위함)
+ */
+static GMainLoop* g_rtsp_loop = NULL;
+static bool g_rtsp_stop_requested = false;
+static std::mutex g_rtsp_loop_mutex;
+
+/**
+ * @brief 메인 루프 스레드에서 메인 루프를 멈춥니다.
+ * @param loop 멈출 메인 루프
+ * @return G_SOURCE_REMOVE (한 번만 실행)
+ */
+static gboolean quit_main_loop(gpointer loop)
+{
+    g_main_loop_quit(static_cast<GMainLoop*>(loop));
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief RTSP 리스닝 소켓을 열거나 이전 서버에서 넘겨받은 소켓을 사용해 서버를 기본 메인 컨텍스트에 붙입니다.
+ * @details gst_rtsp_server_attach()와 같이 소켓의 수신 이벤트를 gst_rtsp_server_io_func으로 처리하며, 다음
+ *          서버에 넘길 수 있도록 소켓을 인계 지점에 등록합니다.
+ * @param server RTSP 서버
+ * @return 붙인 소스 (참조 하나를 가짐, 실패 시 NULL)
+ */
+static GSource* attach_rtsp_server(GstRTSPServer* server)
+{
+    GError* error = NULL;
+    int inherited_fd = g_listener_handoff.take_rtsp();
+    GSocket* socket = inherited_fd >= 0 ? g_socket_new_from_fd(inherited_fd, &error)
+                                        : gst_rtsp_server_create_socket(server, NULL, &error);
+    if (!socket)
+    {
+        g_printerr("RTSP 리스닝 소켓 준비 실패: %s\n", error ? error->message : "unknown");
+        if (error)
+        {
+            g_error_free(error);
+        }
+        return NULL;
+    }
+
+    GSource* source = g_socket_create_source(socket, (GIOCondition)(G_IO_IN | G_IO_ERR | G_IO_HUP | G_IO_NVAL), NULL);
+    g_source_set_callback(source, (GSourceFunc)gst_rtsp_server_io_func, g_object_ref(server),
+                          (GDestroyNotify)g_object_unref);
+    g_source_attach(source, NULL);
+
+    g_listener_handoff.set_rtsp_listener(g_socket_get_fd(socket));
+    if (inherited_fd >= 0)
+    {
+        cout << "[INFO] 이전 서버의 RTSP 리스닝 소켓을 넘겨받았습니다." << endl;
+    }
+    // 소스가 소켓 참조를 가지므로 여기서 놓아도 소켓은 열려 있음
+    g_object_unref(socket);
+    return source;
+}
+
 /**
  * @brief RTSP 서버를 실행합니다. (GStreamer 기반)
  * @param argc 인자 개수
@@ -91,7 +150,8 @@ void rtsp_run(int argc, char* argv[])
     g_object_unref(mounts);
 
     // RTSP 서버 시작
-    if (gst_rtsp_server_attach(server, NULL) == 0)
+    GSource* listen_source = attach_rtsp_server(server);
+    if (!listen_source)
     {
         cerr << "RTSP 서버 Attach 실패\n";
         return;
@@ -100,10 +160,45 @@ void rtsp_run(int argc, char* argv[])
     cout << "\nCCTV RTSP middle server is running on " << port << CCTV_MOUNT_POINT << " AND " << NIGHT_CCTV_MOUNT_POINT
          << "\n";
 
-    // 메인 루프 실행
+    // 메인 루프 실행 (rtsp_stop()이 먼저 호출되었으면 바로 종료)
     GMainLoop* loop = g_main_loop_new(NULL, FALSE);
-    g_main_loop_run(loop);
+    bool stop_requested;
+    {
+        lock_guard<mutex> lock(g_rtsp_loop_mutex);
+        g_rtsp_loop = loop;
+        stop_requested = g_rtsp_stop_requested;
+    }
+    if (!stop_requested)
+    {
+        g_main_loop_run(loop);
+    }
+    {
+        lock_guard<mutex> lock(g_rtsp_loop_mutex);
+        g_rtsp_loop = NULL;
+    }
 
+    // 다음 서버에 넘긴 소켓은 다음 서버가 계속 사용하므로, 여기서 닫아도 새 RTSP 연결은 끊기지 않음
+    g_listener_handoff.set_rtsp_listener(-1);
+    g_source_destroy(listen_source);
+    g_source_unref(listen_source);
     g_main_loop_unref(loop);
+    g_object_unref(server);
+    cout << "[INFO] RTSP 서버를 종료했습니다." << endl;
     return;
+}
+
+/**
+ * @brief 실행 중인 RTSP 서버의 메인 루프를 멈춥니다.
+ * @details 메인 루프 종료는 기본 메인 컨텍스트에서 실행되도록 넘기므로, g_main_loop_run 직전에 호출되어도
+ *          종료 요청이 사라지지 않습니다.
+ */
+void rtsp_stop()
+{
+    lock_guard<mutex> lock(g_rtsp_loop_mutex);
+    g_rtsp_stop_requested = true;
+    if (g_rtsp_loop)
+    {
+        g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, quit_main_loop, g_main_loop_ref(g_rtsp_loop),
+                                   (GDestroyNotify)g_main_loop_unref);
+    }
 }
\ No newline at end of file
@@ -21,4 +21,9 @@ using namespace std;
  * @param argc 인자 개수
  * @param argv 인자 배열
  */
-void rtsp_run(int argc, char* argv[]);
\ No newline at end of file
+void rtsp_run(int argc, char* argv[]);
+
+/**
+ * @brief 실행 중인 RTSP 서버의 메인 루프를 멈춥니다. (다른 스레드에서 호출, rtsp_run이 반환됨)
+ */
+void rtsp_stop();
\ No newline at end of file
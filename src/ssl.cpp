@@ -5,6 +5,20 @@
  */
 
 #include "ssl.hpp"
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 
 /**
@@ -72,9 +86,357 @@ void configure_ssl_context(SSL_CTX* ctx)
     }
 }
 
+// ==================== 세션 재개 ====================
+
+/**
+ * @brief 세션 티켓 암호화 키 (이름은 티켓 앞부분에 평문으로 실려 복호화 키를 고르는 데 쓰임)
+ */
+struct TicketKey
+{
+    unsigned char name[16];
+    unsigned char aes_key[32];
+    unsigned char hmac_key[32];
+    time_t created;
+};
+
+/**
+ * @brief 현재/직전 티켓 키, 보호용 뮤텍스, 교체 주기(초)
+ */
+static std::mutex ticket_key_mutex;
+static TicketKey current_ticket_key;
+static TicketKey previous_ticket_key;
+static bool has_previous_ticket_key = false;
+static int ticket_key_rotation_sec = 3600;
+
+/**
+ * @brief 핸드셰이크 누적 카운터
+ */
+static std::atomic<uint64_t> full_handshakes(0);
+static std::atomic<uint64_t> resumed_handshakes(0);
+static std::atomic<uint64_t> failed_handshakes(0);
+static std::atomic<uint64_t> ktls_connections(0);
+
+/**
+ * @brief kTLS를 요청했는지, 사용자 공간 암호화로 돌아간 연결을 이미 알렸는지 여부
+ */
+static std::atomic<bool> ktls_requested(false);
+static std::atomic<bool> ktls_fallback_reported(false);
+
+/**
+ * @brief 세션 캐시를 다른 애플리케이션과 구분하는 ID 컨텍스트
+ */
+static const unsigned char SESSION_ID_CONTEXT[] = "raspi-server";
+
+/**
+ * @brief 새 티켓 키를 무작위로 만듭니다.
+ * @param key 채울 키 (출력)
+ * @return 성공 시 true
+ */
+static bool generate_ticket_key(TicketKey& key)
+{
+    if (RAND_bytes(key.name, sizeof(key.name)) != 1 || RAND_bytes(key.aes_key, sizeof(key.aes_key)) != 1 ||
+        RAND_bytes(key.hmac_key, sizeof(key.hmac_key)) != 1)
+    {
+        return false;
+    }
+    key.created = time(nullptr);
+    return true;
+}
+
+/**
+ * @brief 현재 키가 교체 주기를 넘겼으면 새 키로 바꾸고 현재 키를 직전 키로 남깁니다. (ticket_key_mutex 보유 상태에서 호출)
+ */
+static void rotate_ticket_key_locked()
+{
+    if (time(nullptr) - current_ticket_key.created < ticket_key_rotation_sec)
+    {
+        return;
+    }
+    TicketKey next;
+    if (!generate_ticket_key(next))
+    {
+        std::cerr << "[TLS] 세션 티켓 키 생성 실패, 기존 키를 계속 사용합니다." << std::endl;
+        return;
+    }
+    previous_ticket_key = current_ticket_key;
+    has_previous_ticket_key = true;
+    current_ticket_key = next;
+    std::cout << "[TLS] 세션 티켓 키 교체" << std::endl;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/**
+ * @brief 세션 티켓 암호화/복호화 키를 고르는 OpenSSL 콜백
+ * @details 발급(enc == 1)은 항상 현재 키로 하고, 복호화는 티켓의 키 이름으로 현재 또는 직전 키를 찾습니다.
+ * @param key_name 티켓 키 이름 (발급 시 출력, 복호화 시 입력)
+ * @param iv 초기화 벡터 (발급 시 출력, 복호화 시 입력)
+ * @param cipher_ctx 초기화할 암호화 컨텍스트
+ * @param mac_ctx 초기화할 HMAC 컨텍스트
+ * @param enc 발급이면 1, 복호화면 0
+ * @return 1(성공), 2(직전 키로 복호화 성공, 새 키로 재발급), 0(알 수 없는 키, 전체 핸드셰이크), -1(오류)
+ */
+static int ticket_key_callback(SSL*, unsigned char* key_name, unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx,
+                               EVP_MAC_CTX* mac_ctx, int enc)
+{
+    std::lock_guard<std::mutex> lock(ticket_key_mutex);
+    rotate_ticket_key_locked();
+
+    const TicketKey* key = &current_ticket_key;
+    int result = 1;
+    if (enc)
+    {
+        memcpy(key_name, key->name, sizeof(key->name));
+        if (RAND_bytes(iv, EVP_CIPHER_get_iv_length(EVP_aes_256_cbc())) != 1 ||
+            EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key->aes_key, iv) != 1)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        if (memcmp(key_name, current_ticket_key.name, sizeof(current_ticket_key.name)) != 0)
+        {
+            if (!has_previous_ticket_key ||
+                memcmp(key_name, previous_ticket_key.name, sizeof(previous_ticket_key.name)) != 0)
+            {
+                return 0;
+            }
+            key = &previous_ticket_key;
+            result = 2;
+        }
+        if (EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key->aes_key, iv) != 1)
+        {
+            return -1;
+        }
+    }
+
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<unsigned char*>(key->hmac_key),
+                                          sizeof(key->hmac_key)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end()};
+    if (EVP_MAC_CTX_set_params(mac_ctx, params) != 1)
+    {
+        return -1;
+    }
+    return result;
+}
+#endif
+
+/**
+ * @brief SSL 컨텍스트에 세션 재개(세션 티켓 + 서버 세션 캐시)를 설정합니다.
+ * @details 직전 키까지만 복호화하므로 티켓은 발급 후 최소 ticket_key_rotation_sec 동안 재개에 쓸 수 있습니다.
+ *          session_timeout_sec를 교체 주기보다 길게 잡아도 그보다 오래된 티켓은 전체 핸드셰이크로 처리됩니다.
+ * @param ctx SSL_CTX 포인터
+ * @param cache_size 서버 세션 캐시 최대 세션 수
+ * @param session_timeout_sec 세션(티켓 포함) 유효 시간(초)
+ * @param ticket_key_rotation_sec 티켓 키 교체 주기(초)
+ */
+void configure_session_resumption(SSL_CTX* ctx, long cache_size, long session_timeout_sec,
+                                  int ticket_key_rotation_sec)
+{
+    SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx, std::max(1L, cache_size));
+    SSL_CTX_set_timeout(ctx, std::max(1L, session_timeout_sec));
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    {
+        std::lock_guard<std::mutex> lock(ticket_key_mutex);
+        ::ticket_key_rotation_sec = std::max(60, ticket_key_rotation_sec);
+        if (!generate_ticket_key(current_ticket_key))
+        {
+            std::cerr << "[TLS] 세션 티켓 키 생성 실패, 세션 티켓을 끕니다." << std::endl;
+            SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+            return;
+        }
+        has_previous_ticket_key = false;
+    }
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, ticket_key_callback);
+    std::cout << "[TLS] 세션 재개 설정 (cache_size=" << cache_size << ", timeout=" << session_timeout_sec
+              << "s, ticket_key_rotation=" << ::ticket_key_rotation_sec << "s)" << std::endl;
+#else
+    // OpenSSL 1.1에서는 OpenSSL이 만든 티켓 키를 교체 없이 사용
+    std::cout << "[TLS] 세션 재개 설정 (cache_size=" << cache_size << ", timeout=" << session_timeout_sec
+              << "s, 티켓 키 교체 미지원)" << std::endl;
+#endif
+}
+
+// ==================== 커널 TLS ====================
+
+/**
+ * @brief SSL 컨텍스트에 커널 TLS(kTLS) 오프로드를 설정합니다.
+ * @details OpenSSL은 핸드셰이크가 끝날 때 setsockopt(TCP_ULP, "tls")로 커널 오프로드를 시도하고, 실패하면 조용히
+ *          사용자 공간 암호화를 계속 사용합니다. 실제 사용 여부는 연결별로 ktls_send_active()로 확인합니다.
+ * @param ctx SSL_CTX 포인터
+ * @param enable kTLS 사용 여부
+ */
+void configure_ktls(SSL_CTX* ctx, bool enable)
+{
+    if (!enable)
+    {
+        std::cout << "[TLS] kTLS 꺼짐 (설정)" << std::endl;
+        return;
+    }
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+    ktls_requested = true;
+    std::cout << "[TLS] kTLS 송신 오프로드 요청 (커널/암호 미지원 시 사용자 공간 암호화)" << std::endl;
+#else
+    (void)ctx;
+    std::cout << "[TLS] 이 OpenSSL은 kTLS를 지원하지 않아 사용자 공간 암호화를 사용합니다." << std::endl;
+#endif
+}
+
+/**
+ * @brief 연결의 송신 경로가 kTLS로 오프로드되었는지 확인합니다.
+ * @param ssl 핸드셰이크를 마친 SSL 포인터
+ * @return kTLS 송신 중이면 true
+ */
+bool ktls_send_active(SSL* ssl)
+{
+    BIO* wbio = SSL_get_wbio(ssl);
+    return wbio && BIO_get_ktls_send(wbio);
+}
+
+/**
+ * @brief 핸드셰이크 결과를 통계에 기록합니다.
+ * @details kTLS를 요청했는데 오프로드되지 않은 첫 연결에서 한 번만 경고를 남깁니다. (커널 tls 모듈 없음 등)
+ * @param ssl SSL_accept를 마친 SSL 포인터
+ * @param success SSL_accept 성공 여부
+ * @return 세션이 재개되었으면 true
+ */
+bool record_handshake(SSL* ssl, bool success)
+{
+    if (!success)
+    {
+        failed_handshakes++;
+        return false;
+    }
+    bool resumed = SSL_session_reused(ssl) == 1;
+    (resumed ? resumed_handshakes : full_handshakes)++;
+
+    if (ktls_send_active(ssl))
+    {
+        ktls_connections++;
+    }
+    else if (ktls_requested.load() && !ktls_fallback_reported.exchange(true))
+    {
+        std::cerr << "[TLS] kTLS 오프로드 실패, 사용자 공간 암호화로 송신합니다. (커널 tls 모듈 또는 암호 "
+                  << SSL_get_cipher_name(ssl) << " 미지원)" << std::endl;
+    }
+    return resumed;
+}
+
+/**
+ * @brief 현재까지의 핸드셰이크 통계를 반환합니다.
+ * @return 핸드셰이크 통계
+ */
+TlsHandshakeStats get_handshake_stats()
+{
+    return {full_handshakes.load(), resumed_handshakes.load(), failed_handshakes.load(), ktls_connections.load()};
+}
+
+// ==================== 평문 로컬 연결 ====================
+
+/**
+ * @brief 로컬 연결 표시를 저장하는 SSL ex_data 인덱스를 반환합니다. (처음 호출 시 한 번 할당)
+ * @return ex_data 인덱스
+ */
+static int plain_ex_index()
+{
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+/**
+ * @brief 로컬 연결 표시로 ex_data에 저장하는 주소
+ */
+static char plain_marker;
+
+/**
+ * @brief TLS 없이 소켓에 직접 송수신하는 로컬 연결 핸들을 만듭니다.
+ * @param ctx SSL 컨텍스트
+ * @param socket 연결된 소켓 디스크립터
+ * @return 연결 핸들, 실패 시 nullptr
+ */
+SSL* create_plain_connection(SSL_CTX* ctx, int socket)
+{
+    SSL* ssl = SSL_new(ctx);
+    if (!ssl)
+    {
+        return nullptr;
+    }
+    SSL_set_fd(ssl, socket);
+    SSL_set_ex_data(ssl, plain_ex_index(), &plain_marker);
+    return ssl;
+}
+
+/**
+ * @brief 연결 핸들이 TLS 없는 로컬 연결인지 확인합니다.
+ * @param ssl 연결 핸들
+ * @return create_plain_connection()으로 만든 핸들이면 true
+ */
+bool is_plain_connection(SSL* ssl)
+{
+    return SSL_get_ex_data(ssl, plain_ex_index()) == &plain_marker;
+}
+
+/**
+ * @brief 소켓에서 지정한 길이만큼 데이터를 수신합니다.
+ * @param fd 소켓 디스크립터
+ * @param buffer 수신 버퍼
+ * @param len 수신할 바이트 수
+ * @return 성공 시 true, 연결 종료 또는 오류 시 false
+ */
+static bool recv_plain(int fd, char* buffer, size_t len)
+{
+    size_t total_received = 0;
+    while (total_received < len)
+    {
+        ssize_t bytes_received = recv(fd, buffer + total_received, len - total_received, 0);
+        if (bytes_received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytes_received <= 0)
+        {
+            return false;
+        }
+        total_received += bytes_received;
+    }
+    return true;
+}
+
+/**
+ * @brief 소켓에 지정한 길이만큼 데이터를 송신합니다.
+ * @param fd 소켓 디스크립터
+ * @param buffer 송신할 데이터 버퍼
+ * @param len 송신할 바이트 수
+ * @return 송신한 바이트 수, 실패 시 -1
+ */
+static ssize_t send_plain(int fd, const char* buffer, size_t len)
+{
+    size_t total_sent = 0;
+    while (total_sent < len)
+    {
+        ssize_t bytes_sent = send(fd, buffer + total_sent, len - total_sent, MSG_NOSIGNAL);
+        if (bytes_sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytes_sent <= 0)
+        {
+            return -1;
+        }
+        total_sent += bytes_sent;
+    }
+    return total_sent;
+}
+
 // SSL 버전의 송수신 함수
 /**
- * @brief SSL을 통해 지정한 길이만큼 데이터를 수신합니다.
+ * @brief SSL을 통해 지정한 길이만큼 데이터를 수신합니다. (로컬 연결은 소켓에서 직접 수신)
  * @param ssl OpenSSL SSL 포인터
  * @param buffer 수신 버퍼
  * @param len 수신할 바이트 수
@@ -82,6 +444,11 @@ void configure_ssl_context(SSL_CTX* ctx)
  */
 bool recvAll(SSL* ssl, char* buffer, size_t len)
 {
+    if (is_plain_connection(ssl))
+    {
+        return recv_plain(SSL_get_fd(ssl), buffer, len);
+    }
+
     size_t total_received = 0;
     while (total_received < len)
     {
@@ -94,6 +461,14 @@ bool recvAll(SSL* ssl, char* buffer, size_t len)
             {
                 continue;
             }
+#ifdef SSL_R_UNEXPECTED_EOF_WHILE_READING
+            // close_notify 없이 끊긴 연결은 일반 연결 종료로 처리 (오류 로그 없음, 세션은 SSL_free에서 캐시에서 지워짐)
+            if (error == SSL_ERROR_SSL && ERR_GET_REASON(ERR_peek_error()) == SSL_R_UNEXPECTED_EOF_WHILE_READING)
+            {
+                ERR_clear_error();
+                return false;
+            }
+#endif
             ERR_print_errors_fp(stderr);
             return false;
         }
@@ -103,15 +478,20 @@ bool recvAll(SSL* ssl, char* buffer, size_t len)
 }
 
 /**
- * @brief SSL을 통해 지정한 길이만큼 데이터를 송신합니다.
+ * @brief SSL을 통해 지정한 길이만큼 데이터를 송신합니다. (로컬 연결은 소켓에 직접 송신)
  * @param ssl OpenSSL SSL 포인터
  * @param buffer 송신할 데이터 버퍼
  * @param len 송신할 바이트 수
  * @param flags (미사용)
  * @return 송신한 바이트 수, 실패 시 -1
  */
-ssize_t sendAll(SSL* ssl, const char* buffer, size_t len, int flags)
+ssize_t sendAll(SSL* ssl, const char* buffer, size_t len, int /*flags*/)
 {
+    if (is_plain_connection(ssl))
+    {
+        return send_plain(SSL_get_fd(ssl), buffer, len);
+    }
+
     size_t total_sent = 0;
     while (total_sent < len)
     {
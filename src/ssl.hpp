@@ -5,6 +5,7 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <mutex>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
@@ -43,7 +44,78 @@ SSL_CTX* create_ssl_context();
 void configure_ssl_context(SSL_CTX* ctx);
 
 /**
- * @brief SSL을 통해 지정한 길이만큼 데이터를 수신합니다.
+ * @brief TLS 핸드셰이크 누적 통계
+ */
+struct TlsHandshakeStats
+{
+    uint64_t full;    ///< 전체(비대칭 키 교환) 핸드셰이크 수
+    uint64_t resumed; ///< 세션 티켓/세션 캐시로 재개된 핸드셰이크 수
+    uint64_t failed;  ///< 실패한 핸드셰이크 수
+    uint64_t ktls;    ///< 송신이 커널 TLS(kTLS)로 오프로드된 연결 수
+};
+
+/**
+ * @brief SSL 컨텍스트에 세션 재개(세션 티켓 + 서버 세션 캐시)를 설정합니다.
+ * @details 세션 티켓은 서버 메모리에만 있는 키로 암호화하며, 키는 rotation_sec마다 새로 만들고 직전 키 하나를
+ *          복호화용으로 남겨 둡니다. 직전 키로 복호화한 티켓은 현재 키로 다시 발급합니다. 티켓을 쓰지 않는 TLS 1.2
+ *          클라이언트는 크기가 제한된 서버 세션 캐시(세션 ID)로 재개합니다.
+ * @param ctx SSL_CTX 포인터
+ * @param cache_size 서버 세션 캐시 최대 세션 수
+ * @param session_timeout_sec 세션(티켓 포함) 유효 시간(초)
+ * @param ticket_key_rotation_sec 티켓 키 교체 주기(초)
+ */
+void configure_session_resumption(SSL_CTX* ctx, long cache_size, long session_timeout_sec,
+                                  int ticket_key_rotation_sec);
+
+/**
+ * @brief SSL 컨텍스트에 커널 TLS(kTLS) 오프로드를 설정합니다.
+ * @details 켜면 핸드셰이크 후 레코드 암호화를 커널에 맡겨 SSL_write가 평문을 바로 소켓에 씁니다. 커널 tls 모듈이
+ *          없거나 협상된 암호를 커널이 지원하지 않으면 OpenSSL이 연결별로 사용자 공간 암호화로 돌아갑니다.
+ * @param ctx SSL_CTX 포인터
+ * @param enable kTLS 사용 여부
+ */
+void configure_ktls(SSL_CTX* ctx, bool enable);
+
+/**
+ * @brief 연결의 송신 경로가 kTLS로 오프로드되었는지 확인합니다.
+ * @param ssl 핸드셰이크를 마친 SSL 포인터
+ * @return kTLS 송신 중이면 true
+ */
+bool ktls_send_active(SSL* ssl);
+
+/**
+ * @brief 핸드셰이크 결과를 통계에 기록합니다.
+ * @param ssl SSL_accept를 마친 SSL 포인터
+ * @param success SSL_accept 성공 여부
+ * @return 세션이 재개되었으면 true
+ */
+bool record_handshake(SSL* ssl, bool success);
+
+/**
+ * @brief 현재까지의 핸드셰이크 통계를 반환합니다.
+ * @return 핸드셰이크 통계
+ */
+TlsHandshakeStats get_handshake_stats();
+
+/**
+ * @brief TLS 없이 소켓에 직접 송수신하는 로컬 연결 핸들을 만듭니다.
+ * @details 요청 처리 함수와 연결 세션은 모두 SSL 포인터를 연결 핸들로 사용하므로, 로컬(Unix 도메인 소켓) 연결에도
+ *          핸드셰이크하지 않은 SSL 객체를 만들어 넘깁니다. recvAll/sendAll은 이 객체의 소켓을 직접 읽고 씁니다.
+ * @param ctx SSL 컨텍스트
+ * @param socket 연결된 소켓 디스크립터
+ * @return 연결 핸들, 실패 시 nullptr
+ */
+SSL* create_plain_connection(SSL_CTX* ctx, int socket);
+
+/**
+ * @brief 연결 핸들이 TLS 없는 로컬 연결인지 확인합니다.
+ * @param ssl 연결 핸들
+ * @return create_plain_connection()으로 만든 핸들이면 true
+ */
+bool is_plain_connection(SSL* ssl);
+
+/**
+ * @brief SSL을 통해 지정한 길이만큼 데이터를 수신합니다. (로컬 연결은 소켓에서 직접 수신)
  * @param ssl OpenSSL SSL 포인터
  * @param buffer 수신 버퍼
  * @param len 수신할 바이트 수
@@ -52,7 +124,7 @@ void configure_ssl_context(SSL_CTX* ctx);
 bool recvAll(SSL* ssl, char* buffer, size_t len);
 
 /**
- * @brief SSL을 통해 지정한 길이만큼 데이터를 송신합니다.
+ * @brief SSL을 통해 지정한 길이만큼 데이터를 송신합니다. (로컬 연결은 소켓에 직접 송신)
  * @param ssl OpenSSL SSL 포인터
  * @param buffer 송신할 데이터 버퍼
  * @param len 송신할 바이트 수
@@ -0,0 +1,392 @@
+/**
+ * @file tcp_acceptor.cpp
+ * @brief SO_REUSEPORT 다중 수락 스레드 구현 파일
+ * @details 리스닝 소켓 생성, 코어 고정, epoll 수락 루프, 수락 큐 통계 수집을 구현합니다.
+ */
+
+#include "tcp_acceptor.hpp"
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 TCP 수락 스레드 묶음 인스턴스
+ */
+TcpAcceptorGroup g_tcp_acceptors;
+
+/**
+ * @brief 커널 전체의 수락 큐 넘침/버림 횟수를 읽습니다. (/proc/net/netstat의 TcpExt)
+ * @param overflows ListenOverflows (수락 큐가 가득 차 버린 연결 수, 출력)
+ * @param drops ListenDrops (넘침을 포함해 리스닝 소켓에서 버린 연결 수, 출력)
+ * @return 읽었으면 true
+ */
+static bool read_listen_overflows(uint64_t& overflows, uint64_t& drops)
+{
+    ifstream netstat("/proc/net/netstat");
+    string names;
+    string values;
+    while (getline(netstat, names) && getline(netstat, values))
+    {
+        if (names.rfind("TcpExt:", 0) != 0)
+        {
+            continue;
+        }
+        istringstream name_stream(names);
+        istringstream value_stream(values);
+        string name;
+        string value;
+        bool found = false;
+        while (name_stream >> name && value_stream >> value)
+        {
+            if (name == "ListenOverflows")
+            {
+                overflows = stoull(value);
+                found = true;
+            }
+            else if (name == "ListenDrops")
+            {
+                drops = stoull(value);
+            }
+        }
+        return found;
+    }
+    return false;
+}
+
+/**
+ * @brief 소멸자. 수락 스레드를 중지함
+ */
+TcpAcceptorGroup::~TcpAcceptorGroup()
+{
+    stop();
+}
+
+/**
+ * @brief 리스닝 소켓을 열고 수락 스레드를 시작합니다.
+ * @param port TCP 포트
+ * @param count 리스닝 소켓(수락 스레드) 수 (0이면 CPU 코어 수)
+ * @param backlog 소켓별 listen 백로그
+ * @param pin_threads 수락 스레드를 코어에 하나씩 고정할지 여부
+ * @param on_accept 수락한 연결을 넘겨받는 콜백
+ * @param inherited 이전 서버에서 넘겨받은 리스닝 소켓 (소유권 이전)
+ * @return 모든 소켓을 열었으면 true
+ */
+bool TcpAcceptorGroup::start(int port, int count, int backlog, bool pin_threads, TcpAcceptCallback on_accept,
+                             vector<int> inherited)
+{
+    if (running.load())
+    {
+        return true;
+    }
+    int cpus = max(1, static_cast<int>(thread::hardware_concurrency()));
+    count = count > 0 ? count : cpus;
+    backlog = max(1, backlog);
+    if (!inherited.empty() && static_cast<int>(inherited.size()) != count)
+    {
+        cout << "[Accept] 넘겨받은 리스닝 소켓 " << inherited.size() << "개를 그대로 사용합니다. (설정 " << count
+             << "개)" << endl;
+    }
+    count = inherited.empty() ? count : static_cast<int>(inherited.size());
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0)
+    {
+        cerr << "[Accept] eventfd 생성 실패: " << strerror(errno) << endl;
+        for (int fd : inherited)
+        {
+            close(fd);
+        }
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+    for (int i = 0; i < count; ++i)
+    {
+        auto acceptor = make_unique<Acceptor>();
+        acceptor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        bool ok;
+        if (!inherited.empty())
+        {
+            // 넘겨받은 소켓은 이미 bind/listen된 상태이며, listen을 다시 호출하면 백로그 설정만 바뀜
+            acceptor->listen_fd = inherited[i];
+            inherited[i] = -1;
+            int flags = fcntl(acceptor->listen_fd, F_GETFL, 0);
+            ok = acceptor->epoll_fd >= 0 && flags >= 0 &&
+                 fcntl(acceptor->listen_fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+                 listen(acceptor->listen_fd, backlog) == 0;
+        }
+        else
+        {
+            acceptor->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            int opt = 1;
+            ok = acceptor->listen_fd >= 0 && acceptor->epoll_fd >= 0 &&
+                 setsockopt(acceptor->listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == 0 &&
+                 setsockopt(acceptor->listen_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == 0 &&
+                 ::bind(acceptor->listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                 listen(acceptor->listen_fd, backlog) == 0;
+        }
+        if (ok)
+        {
+            epoll_event listen_event{};
+            listen_event.events = EPOLLIN;
+            listen_event.data.fd = acceptor->listen_fd;
+            epoll_event wake_event{};
+            wake_event.events = EPOLLIN;
+            wake_event.data.fd = wake_fd;
+            ok = epoll_ctl(acceptor->epoll_fd, EPOLL_CTL_ADD, acceptor->listen_fd, &listen_event) == 0 &&
+                 epoll_ctl(acceptor->epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event) == 0;
+        }
+        if (!ok)
+        {
+            cerr << "[Accept] 리스닝 소켓 " << i << " 준비 실패 (port " << port << "): " << strerror(errno) << endl;
+            if (acceptor->listen_fd >= 0)
+            {
+                close(acceptor->listen_fd);
+            }
+            if (acceptor->epoll_fd >= 0)
+            {
+                close(acceptor->epoll_fd);
+            }
+            for (int fd : inherited)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+            stop();
+            return false;
+        }
+        sample_queue(*acceptor);
+        acceptors.push_back(std::move(acceptor));
+    }
+
+    base_overflows = 0;
+    base_drops = 0;
+    read_listen_overflows(base_overflows, base_drops);
+    reported_accepted = 0;
+    reported_overflows = 0;
+    reported_queue_full = 0;
+
+    this->on_accept = std::move(on_accept);
+    running = true;
+    for (int i = 0; i < count; ++i)
+    {
+        acceptors[i]->thread = thread(&TcpAcceptorGroup::accept_loop, this, i, pin_threads ? i % cpus : -1);
+    }
+
+    uint32_t effective_backlog = acceptors.front()->backlog.load();
+    cout << "[Accept] 수락 스레드 " << count << "개 시작 (SO_REUSEPORT, backlog=" << effective_backlog
+         << (pin_threads ? ", 코어 고정" : "") << (inherited.empty() ? "" : ", 넘겨받은 소켓") << ")" << endl;
+    if (effective_backlog != 0 && effective_backlog < static_cast<uint32_t>(backlog))
+    {
+        cerr << "[Accept] listen 백로그가 net.core.somaxconn(" << effective_backlog << ")으로 줄었습니다. (요청 "
+             << backlog << ")" << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief 수락 스레드를 중지하고 리스닝 소켓을 닫습니다.
+ */
+void TcpAcceptorGroup::stop()
+{
+    if (running.exchange(false))
+    {
+        uint64_t one = 1;
+        (void)write(wake_fd, &one, sizeof(one));
+    }
+    for (auto& acceptor : acceptors)
+    {
+        if (acceptor->thread.joinable())
+        {
+            acceptor->thread.join();
+        }
+        close(acceptor->listen_fd);
+        close(acceptor->epoll_fd);
+    }
+    acceptors.clear();
+    if (wake_fd >= 0)
+    {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+}
+
+/**
+ * @brief 수락 스레드 본체. 리스닝 소켓이 준비되면 큐가 빌 때까지 수락
+ * @param index 수락 스레드 번호
+ * @param cpu 고정할 코어 번호 (음수면 고정하지 않음)
+ */
+void TcpAcceptorGroup::accept_loop(int index, int cpu)
+{
+    if (cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (error != 0)
+        {
+            cerr << "[Accept] 수락 스레드 " << index << " 코어 " << cpu << " 고정 실패: " << strerror(error) << endl;
+        }
+    }
+
+    Acceptor& acceptor = *acceptors[index];
+    epoll_event events[2];
+    while (running.load())
+    {
+        // 준비 알림이 없어도 1초마다 큐 길이를 표본으로 남김
+        int count = epoll_wait(acceptor.epoll_fd, events, 2, 1000);
+        if (count < 0 && errno != EINTR)
+        {
+            cerr << "[Accept] epoll_wait 실패: " << strerror(errno) << endl;
+            break;
+        }
+        if (!running.load())
+        {
+            break;
+        }
+        sample_queue(acceptor);
+
+        bool readable = false;
+        for (int i = 0; i < count; ++i)
+        {
+            readable = readable || events[i].data.fd == acceptor.listen_fd;
+        }
+        while (readable && running.load())
+        {
+            int client_socket = accept4(acceptor.listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client_socket < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                {
+                    // 디스크립터 부족(EMFILE, ENFILE) 등은 잠시 뒤 다시 시도 (연결은 큐에 남음)
+                    cerr << "[Accept] 연결 수락 실패: " << strerror(errno) << endl;
+                    this_thread::sleep_for(chrono::milliseconds(100));
+                }
+                break;
+            }
+            acceptor.accepted++;
+            on_accept(client_socket, index);
+            // 콜백이 막혀 있던 동안(동시 핸드셰이크 상한) 쌓인 큐 길이를 기록
+            sample_queue(acceptor);
+        }
+    }
+}
+
+/**
+ * @brief 리스닝 소켓의 현재 수락 큐 길이를 표본으로 기록합니다.
+ * @details 리스닝 소켓의 TCP_INFO는 tcpi_unacked에 현재 수락 큐 길이를, tcpi_sacked에 최대 길이(백로그)를 담습니다.
+ * @param acceptor 수락 스레드
+ */
+void TcpAcceptorGroup::sample_queue(Acceptor& acceptor)
+{
+    tcp_info info{};
+    socklen_t len = sizeof(info);
+    if (getsockopt(acceptor.listen_fd, IPPROTO_TCP, TCP_INFO, &info, &len) < 0)
+    {
+        return;
+    }
+    acceptor.backlog = info.tcpi_sacked;
+    if (info.tcpi_unacked > acceptor.queue_peak.load())
+    {
+        acceptor.queue_peak = info.tcpi_unacked;
+    }
+    if (info.tcpi_sacked > 0 && info.tcpi_unacked >= info.tcpi_sacked)
+    {
+        acceptor.queue_full++;
+    }
+}
+
+/**
+ * @brief 리스닝 소켓 목록을 반환합니다.
+ * @return 리스닝 소켓 (수락 스레드 순서)
+ */
+vector<int> TcpAcceptorGroup::listen_fds() const
+{
+    vector<int> fds;
+    for (const auto& acceptor : acceptors)
+    {
+        fds.push_back(acceptor->listen_fd);
+    }
+    return fds;
+}
+
+/**
+ * @brief 수락 스레드별 통계를 반환합니다.
+ * @return 통계 (수락 스레드 순서)
+ */
+vector<TcpAcceptorStats> TcpAcceptorGroup::stats() const
+{
+    vector<TcpAcceptorStats> result;
+    for (const auto& acceptor : acceptors)
+    {
+        TcpAcceptorStats entry;
+        entry.accepted = acceptor->accepted.load();
+        entry.queue_peak = acceptor->queue_peak.load();
+        entry.backlog = acceptor->backlog.load();
+        entry.queue_full = acceptor->queue_full.load();
+        result.push_back(entry);
+    }
+    return result;
+}
+
+/**
+ * @brief 직전 보고 이후 수락이나 넘침이 있었으면 통계를 로그로 남깁니다.
+ */
+void TcpAcceptorGroup::report()
+{
+    auto all = stats();
+    uint64_t accepted = 0;
+    uint64_t queue_full = 0;
+    ostringstream per_acceptor;
+    for (size_t i = 0; i < all.size(); ++i)
+    {
+        accepted += all[i].accepted;
+        queue_full += all[i].queue_full;
+        per_acceptor << (i ? " / " : "") << all[i].accepted << "(큐 최대 " << all[i].queue_peak << ")";
+    }
+
+    uint64_t overflows = base_overflows;
+    uint64_t drops = base_drops;
+    read_listen_overflows(overflows, drops);
+    overflows -= base_overflows;
+    drops -= base_drops;
+    if (accepted == reported_accepted && overflows == reported_overflows && queue_full == reported_queue_full)
+    {
+        return;
+    }
+
+    (overflows > reported_overflows || queue_full > reported_queue_full ? cerr : cout)
+        << "[Accept] 누적 수락 " << accepted << "건 [" << per_acceptor.str() << "], backlog "
+        << (all.empty() ? 0 : all.front().backlog) << ", 큐 가득 참 관찰 " << queue_full << "회, 커널 수락 큐 넘침 "
+        << overflows << "건 / 버림 " << drops << "건 (시작 이후 전체 리스너)" << endl;
+    reported_accepted = accepted;
+    reported_overflows = overflows;
+    reported_queue_full = queue_full;
+}
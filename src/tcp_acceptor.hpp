@@ -0,0 +1,142 @@
+/**
+ * @file tcp_acceptor.hpp
+ * @brief SO_REUSEPORT 다중 수락 스레드 헤더 파일
+ * @details 같은 포트에 SO_REUSEPORT로 리스닝 소켓을 여러 개 열고, 소켓마다 전용 이벤트 루프 스레드(epoll)가 연결을
+ *          수락합니다. 커널이 새 연결을 4-튜플 해시로 소켓들에 나누어 넣으므로, 네트워크 단절 뒤 재접속이 몰려도 수락
+ *          큐 하나에 쌓이지 않습니다. 스레드는 서로 다른 코어에 고정할 수 있습니다. 리스닝 소켓마다 수락 큐 길이(TCP_INFO)를
+ *          표본으로 모아 최대 길이와 큐가 가득 찬 횟수를 세고, 커널 전체의 수락 큐 넘침/버림 횟수(/proc/net/netstat의
+ *          ListenOverflows, ListenDrops)는 시작 시점 대비 증가분으로 보고합니다.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 수락한 연결을 넘겨받는 콜백 (수락 스레드에서 호출)
+ * @param client_socket 수락된 클라이언트 소켓 (소유권 이전, 차단 모드)
+ * @param acceptor 수락한 스레드 번호
+ */
+using TcpAcceptCallback = std::function<void(int client_socket, int acceptor)>;
+
+/**
+ * @brief 수락 스레드 하나의 통계
+ */
+struct TcpAcceptorStats
+{
+    uint64_t accepted = 0;    ///< 수락한 연결 수
+    uint32_t queue_peak = 0;  ///< 표본 중 최대 수락 큐 길이
+    uint32_t backlog = 0;     ///< 커널이 적용한 수락 큐 최대 길이
+    uint64_t queue_full = 0;  ///< 수락 큐가 가득 찬 채로 관찰된 횟수
+};
+
+/**
+ * @class TcpAcceptorGroup
+ * @brief SO_REUSEPORT 리스닝 소켓과 소켓별 수락 스레드 묶음
+ */
+class TcpAcceptorGroup
+{
+public:
+    /**
+     * @brief 소멸자. 수락 스레드를 중지함
+     */
+    ~TcpAcceptorGroup();
+
+    /**
+     * @brief 리스닝 소켓을 열고 수락 스레드를 시작합니다.
+     * @param port TCP 포트
+     * @param count 리스닝 소켓(수락 스레드) 수 (0이면 CPU 코어 수)
+     * @param backlog 소켓별 listen 백로그 (net.core.somaxconn을 넘으면 커널이 줄임)
+     * @param pin_threads 수락 스레드를 코어에 하나씩 고정할지 여부
+     * @param on_accept 수락한 연결을 넘겨받는 콜백
+     * @param inherited 이전 서버에서 넘겨받은 리스닝 소켓 (소유권 이전, 비어 있지 않으면 count 대신 이 소켓들을 사용)
+     * @return 모든 소켓을 열었으면 true, 하나라도 실패하면 연 소켓을 닫고 false
+     */
+    bool start(int port, int count, int backlog, bool pin_threads, TcpAcceptCallback on_accept,
+               std::vector<int> inherited);
+
+    /**
+     * @brief 수락 스레드를 중지하고 리스닝 소켓을 닫습니다.
+     */
+    void stop();
+
+    /**
+     * @brief 리스닝 소켓 목록을 반환합니다. (다음 서버에 인계할 때 사용, 소유권은 넘기지 않음)
+     * @return 리스닝 소켓 (수락 스레드 순서)
+     */
+    std::vector<int> listen_fds() const;
+
+    /**
+     * @brief 수락 스레드별 통계를 반환합니다.
+     * @return 통계 (수락 스레드 순서)
+     */
+    std::vector<TcpAcceptorStats> stats() const;
+
+    /**
+     * @brief 직전 보고 이후 수락이나 넘침이 있었으면 통계를 로그로 남깁니다.
+     */
+    void report();
+
+private:
+    /**
+     * @brief 리스닝 소켓 하나와 수락 스레드
+     */
+    struct Acceptor
+    {
+        int listen_fd = -1;
+        int epoll_fd = -1;
+        std::thread thread;
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint32_t> queue_peak{0};
+        std::atomic<uint32_t> backlog{0};
+        std::atomic<uint64_t> queue_full{0};
+    };
+
+    /**
+     * @brief 수락 스레드 본체. 리스닝 소켓이 준비되면 큐가 빌 때까지 수락
+     * @param index 수락 스레드 번호
+     * @param cpu 고정할 코어 번호 (음수면 고정하지 않음)
+     */
+    void accept_loop(int index, int cpu);
+
+    /**
+     * @brief 리스닝 소켓의 현재 수락 큐 길이를 표본으로 기록합니다.
+     * @param acceptor 수락 스레드
+     */
+    static void sample_queue(Acceptor& acceptor);
+
+    /**
+     * @brief 리스닝 소켓과 수락 스레드
+     */
+    std::vector<std::unique_ptr<Acceptor>> acceptors;
+
+    /**
+     * @brief 모든 수락 스레드를 깨우는 eventfd (중지 시 한 번 쓰고 읽지 않음)와 실행 상태
+     */
+    int wake_fd = -1;
+    std::atomic<bool> running{false};
+
+    /**
+     * @brief 수락한 연결을 넘겨받는 콜백
+     */
+    TcpAcceptCallback on_accept;
+
+    /**
+     * @brief 시작 시점의 커널 수락 큐 넘침/버림 횟수와 직전 보고 시점의 값
+     */
+    uint64_t base_overflows = 0;
+    uint64_t base_drops = 0;
+    uint64_t reported_accepted = 0;
+    uint64_t reported_overflows = 0;
+    uint64_t reported_queue_full = 0;
+};
+
+/**
+ * @brief 서버 전역 TCP 수락 스레드 묶음 인스턴스
+ */
+extern TcpAcceptorGroup g_tcp_acceptors;
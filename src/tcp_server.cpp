@@ -10,63 +10,147 @@
 #include "request_handlers.hpp"
 #include "utils.hpp"
 
+#include "camera_command_queue.hpp"
+#include "camera_line_cache.hpp"
+#include "client_session.hpp"
 #include "config_manager.hpp"
-
+#include "db_retention.hpp"
+#include "db_schema.hpp"
+#include "db_statement_cache.hpp"
+#include "line_config_store.hpp"
+#include "listener_handoff.hpp"
+#include "local_listener.hpp"
+#include "tcp_acceptor.hpp"
+#include "timer_wheel.hpp"
+#include "tls_handshaker.hpp"
+
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+
+#include <condition_variable>
+#include <csignal>
 #include <memory>
 #include <random>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "metadata_parser.hpp"
 
 #include <thread>
 
-// ==================== 유틸리티 함수들 ====================
+// ==================== 연결 추적과 종료 정리 ====================
+
+/**
+ * @brief 처리 중인 클라이언트 연결의 소켓, 보호용 뮤텍스, 연결이 끝날 때마다 알리는 신호
+ * @details 종료 전 정리(drain)에서 남은 연결의 수신을 닫고 처리 스레드가 모두 끝날 때까지 기다리는 데 사용
+ */
+static unordered_set<int> g_client_sockets;
+static mutex g_client_sockets_mutex;
+static condition_variable g_client_sockets_cv;
+
+/**
+ * @brief 종료 정리 중 여부와 정리 마감 시각 (g_draining을 켜기 전에 마감 시각을 기록)
+ */
+static atomic<bool> g_draining(false);
+static chrono::steady_clock::time_point g_drain_deadline;
+
+/**
+ * @brief 종료 요청(SIGTERM/SIGINT 또는 다음 서버로의 인계 완료)을 메인 스레드에 알리는 eventfd, 인계 완료 여부
+ */
+static int g_shutdown_fd = -1;
+static atomic<bool> g_handed_off(false);
+
+/**
+ * @brief 요청 처리에 쓰는 DB 연결 풀과 준비(마이그레이션, 라인 설정 로드) 완료 여부 (tcp_prepare 참고)
+ */
+static DatabasePool g_db_pool;
+static bool g_db_prepared = false;
+
+/**
+ * @brief 메인 스레드에 종료를 요청합니다. (시그널 핸들러에서 호출 가능)
+ */
+static void request_shutdown()
+{
+    uint64_t one = 1;
+    (void)write(g_shutdown_fd, &one, sizeof(one));
+}
 
 /**
- * @brief 클라이언트 소켓에 대해 SSL 연결을 설정합니다.
+ * @brief SIGTERM/SIGINT 핸들러. 종료 정리는 메인 스레드가 하도록 eventfd에 쓰기만 함
+ * @param signal_number 시그널 번호
+ */
+static void handle_shutdown_signal(int signal_number)
+{
+    (void)signal_number;
+    int saved_errno = errno;
+    request_shutdown();
+    errno = saved_errno;
+}
+
+/**
+ * @brief 처리 스레드를 시작할 연결을 등록합니다. (처리 스레드를 만들기 전에 호출)
  * @param client_socket 클라이언트 소켓 디스크립터
- * @return SSL 포인터, 실패 시 nullptr
  */
-SSL* setup_ssl_connection(int client_socket)
+static void track_client_socket(int client_socket)
 {
-    SSL* ssl = SSL_new(ssl_ctx);
-    if (!ssl)
-    {
-        ERR_print_errors_fp(stderr);
-        close(client_socket);
-        return nullptr;
-    }
+    lock_guard<mutex> lock(g_client_sockets_mutex);
+    g_client_sockets.insert(client_socket);
+}
 
-    SSL_set_fd(ssl, client_socket);
-    if (SSL_accept(ssl) <= 0)
+/**
+ * @brief 끝난 연결의 등록을 해제합니다. (같은 번호로 수락된 새 연결을 건드리지 않도록 소켓을 닫기 전에 호출)
+ * @param client_socket 클라이언트 소켓 디스크립터
+ */
+static void untrack_client_socket(int client_socket)
+{
     {
-        ERR_print_errors_fp(stderr);
-        SSL_free(ssl);
-        close(client_socket);
-        return nullptr;
+        lock_guard<mutex> lock(g_client_sockets_mutex);
+        g_client_sockets.erase(client_socket);
     }
-
-    printNowTimeKST();
-    cout << " [Thread " << std::this_thread::get_id() << "] SSL 클라이언트 처리 시작." << endl;
-    return ssl;
+    g_client_sockets_cv.notify_all();
 }
 
 /**
- * @brief 데이터베이스의 모든 테이블을 초기화(생성)합니다.
- * @param db SQLite 데이터베이스 참조
+ * @brief 처리 중인 연결을 정리하고 처리 스레드가 모두 끝날 때까지 기다립니다.
+ * @details 수신만 닫으면 처리 중인 요청은 응답까지 보내고, 다음 수신이 끝나 처리 스레드가 정리(bbox push 스레드
+ *          종료 포함)를 시작합니다. 마감 시각까지 끝나지 않은 연결은 송신까지 닫아 멈춘 전송을 깨웁니다.
+ * @param deadline 정리 마감 시각
+ * @return 모든 처리 스레드가 끝났으면 true
  */
-void initialize_database_tables(SQLite::Database& db)
+static bool drain_client_connections(chrono::steady_clock::time_point deadline)
 {
-    create_table_detections(db);
-    create_table_lines(db);
-    create_table_baseLines(db);
-    create_table_verticalLineEquations(db);
-    create_table_accounts(db);
-    create_table_recovery_codes(db);
+    unique_lock<mutex> lock(g_client_sockets_mutex);
+    g_drain_deadline = deadline;
+    g_draining = true;
+    printNowTimeKST();
+    cout << " [Drain] 처리 중인 연결 " << g_client_sockets.size() << "개의 수신을 닫습니다." << endl;
+    for (int client_socket : g_client_sockets)
+    {
+        shutdown(client_socket, SHUT_RD);
+    }
+    if (g_client_sockets_cv.wait_until(lock, deadline, [] { return g_client_sockets.empty(); }))
+    {
+        return true;
+    }
+
+    cerr << "[Drain] 마감 시각까지 끝나지 않은 연결 " << g_client_sockets.size() << "개를 닫습니다." << endl;
+    for (int client_socket : g_client_sockets)
+    {
+        shutdown(client_socket, SHUT_RDWR);
+    }
+    if (!g_client_sockets_cv.wait_for(lock, chrono::seconds(5), [] { return g_client_sockets.empty(); }))
+    {
+        cerr << "[Drain] 처리 스레드 " << g_client_sockets.size() << "개가 끝나지 않았습니다." << endl;
+        return false;
+    }
+    return true;
 }
 
+// ==================== 유틸리티 함수들 ====================
+
 /**
- * @brief SSL을 통해 JSON 메시지를 수신합니다.
+ * @brief SSL을 통해 메시지 하나를 수신합니다. (연결에서 협상한 압축과 인코딩을 풀어 JSON 객체로 반환)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 파싱된 JSON 객체 (출력)
  * @return 성공 시 true, 실패 시 false
@@ -79,7 +163,10 @@ bool receive_json_message(SSL* ssl, json& received_json)
         return false;
     }
 
-    uint32_t json_len = ntohl(net_len);
+    // 최상위 비트는 압축 여부, 나머지 31비트는 본문 길이
+    uint32_t header = ntohl(net_len);
+    bool compressed = (header & FRAME_COMPRESSED_FLAG) != 0;
+    uint32_t json_len = header & FRAME_LENGTH_MASK;
     if (json_len == 0)
     {
         cerr << "[Thread " << std::this_thread::get_id() << "] 비정상적인 데이터 길이 수신: " << json_len << endl;
@@ -92,7 +179,13 @@ bool receive_json_message(SSL* ssl, json& received_json)
         return false;
     }
 
-    received_json = json::parse(json_buffer);
+    // 압축 해제와 디코딩(JSON, MessagePack, CBOR)은 연결 세션이 협상한 방식으로 처리
+    auto session = ClientSession::from(ssl);
+    if (!session || !session->receive_frame(json_buffer, compressed, received_json))
+    {
+        cerr << "[Thread " << std::this_thread::get_id() << "] 수신 메시지를 읽을 수 없어 연결을 종료합니다." << endl;
+        return false;
+    }
     return true;
 }
 
@@ -102,48 +195,56 @@ bool receive_json_message(SSL* ssl, json& received_json)
  * @brief request_id에 따라 적절한 요청 처리 함수를 호출합니다.
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  * @param bbox_push_enabled BBox push 활성화 플래그
  * @param push_thread BBox push 스레드 참조
  * @param metadata_thread 메타데이터 파싱 스레드 참조
  */
-void route_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex,
-                   std::atomic<bool>& bbox_push_enabled, std::thread& push_thread, std::thread& metadata_thread)
+void route_request(SSL* ssl, const json& received_json, DatabasePool& db_pool, std::atomic<bool>& bbox_push_enabled,
+                   std::thread& push_thread, std::thread& metadata_thread)
 {
     int request_id = received_json.value("request_id", -1);
 
     switch (request_id)
     {
     case 1:
-        handle_detection_request(ssl, received_json, db, db_mutex);
+        handle_detection_request(ssl, received_json, db_pool);
         break;
     case 2:
-        handle_line_insert_request(ssl, received_json, db, db_mutex);
+        handle_line_insert_request(ssl, received_json);
         break;
     case 3:
-        handle_line_select_all_request(ssl, received_json, db, db_mutex);
+        handle_line_select_all_request(ssl, received_json);
         break;
     case 4:
-        handle_line_delete_all_request(ssl, received_json, db, db_mutex);
+        handle_line_delete_all_request(ssl, received_json);
         break;
     case 5:
-        handle_baseline_insert_request(ssl, received_json, db, db_mutex);
+        handle_baseline_insert_request(ssl, received_json);
         break;
     case 6:
-        handle_vertical_line_insert_request(ssl, received_json, db, db_mutex);
+        handle_vertical_line_insert_request(ssl, received_json);
         break;
     case 7:
-        handle_baseline_select_all_request(ssl, received_json, db, db_mutex);
+        handle_baseline_select_all_request(ssl, received_json);
         break;
     case 8:
-        handle_login_step1_request(ssl, received_json, db, db_mutex);
+        handle_login_step1_request(ssl, received_json, db_pool);
         break;
     case 9:
-        handle_signup_request(ssl, received_json, db, db_mutex);
+        handle_signup_request(ssl, received_json, db_pool);
         break;
     case 22:
-        handle_login_step2_request(ssl, received_json, db, db_mutex);
+        handle_login_step2_request(ssl, received_json, db_pool);
+        break;
+    case 24:
+        handle_retention_stats_request(ssl, received_json);
+        break;
+    case 26:
+        handle_detection_event_query_request(ssl, received_json, db_pool);
+        break;
+    case 28:
+        handle_detection_rollup_request(ssl, received_json, db_pool);
         break;
     case 31:
         handle_bbox_start_request(ssl, bbox_push_enabled, push_thread, metadata_thread);
@@ -151,6 +252,15 @@ void route_request(SSL* ssl, const json& received_json, SQLite::Database& db, st
     case 32:
         handle_bbox_stop_request(ssl, bbox_push_enabled, push_thread, metadata_thread);
         break;
+    case 33:
+        handle_line_batch_insert_request(ssl, received_json);
+        break;
+    case 35:
+        handle_heartbeat_request(ssl, received_json);
+        break;
+    case 37:
+        handle_codec_negotiation_request(ssl, received_json);
+        break;
     default:
         cout << "[에러] 알 수 없는 request_id: " << request_id << endl;
         break;
@@ -176,29 +286,84 @@ void cleanup_client_connection(SSL* ssl, int client_socket, std::atomic<bool>& b
     if (metadata_thread.joinable())
         metadata_thread.join();
 
+    // 아직 끝나지 않은 카메라 명령의 완료 알림이 해제된 SSL에 쓰지 않도록 세션을 먼저 닫음
+    auto session = ClientSession::from(ssl);
+    if (session)
+        session->close();
+
+    // 상대가 close_notify를 보낸 정상 종료일 때만 종료 완료로 표시하여 세션을 캐시에 남김 (재접속 시 세션 재개).
+    // 오류나 close_notify 없이 끊긴 연결(SSL_R_UNEXPECTED_EOF_WHILE_READING)은 OpenSSL 기본 동작대로 SSL_free에서
+    // 세션을 캐시에서 지움
+    if (SSL_get_shutdown(ssl) & SSL_RECEIVED_SHUTDOWN)
+    {
+        SSL_set_shutdown(ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+    }
     SSL_free(ssl);
+    untrack_client_socket(client_socket);
     close(client_socket);
     printNowTimeKST();
     cout << " [Thread " << std::this_thread::get_id() << "] 클라이언트 연결 종료 및 스레드 정리." << endl;
 }
 
+/**
+ * @brief 클라이언트 TCP 소켓에 keepalive를 켭니다.
+ * @details heartbeat를 보내지 않는 클라이언트가 FIN 없이 사라져도 커널 탐침이 실패하면 읽기가 오류로 끝나 연결이
+ *          정리됩니다. (keepalive_idle_sec + keepalive_interval_sec * keepalive_count 초 이내)
+ * @param client_socket 클라이언트 소켓 디스크립터
+ */
+static void enable_tcp_keepalive(int client_socket)
+{
+    if (g_config.connection_keepalive_idle_sec <= 0)
+    {
+        return;
+    }
+    int on = 1;
+    int idle = g_config.connection_keepalive_idle_sec;
+    int interval = max(1, g_config.connection_keepalive_interval_sec);
+    int count = max(1, g_config.connection_keepalive_count);
+    if (setsockopt(client_socket, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on)) < 0 ||
+        setsockopt(client_socket, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle)) < 0 ||
+        setsockopt(client_socket, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval)) < 0 ||
+        setsockopt(client_socket, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count)) < 0)
+    {
+        cerr << "[Thread " << std::this_thread::get_id() << "] TCP keepalive 설정 실패: " << strerror(errno) << endl;
+    }
+}
+
 // ==================== 메인 클라이언트 처리 함수 ====================
 
 /**
  * @brief 클라이언트 연결을 처리하는 메인 함수 (스레드 진입점)
+ * @param ssl 핸드셰이크를 마친 SSL 포인터 (로컬 연결이면 TLS 없는 연결 핸들)
  * @param client_socket 클라이언트 소켓 디스크립터
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param resumed 세션 재개 여부 (로컬 연결은 false)
+ * @param db_pool DB 연결 풀
  */
-void handle_client(int client_socket, SQLite::Database& db, std::mutex& db_mutex)
+void handle_client(SSL* ssl, int client_socket, bool resumed, DatabasePool& db_pool)
 {
-    // SSL 연결 설정
-    SSL* ssl = setup_ssl_connection(client_socket);
-    if (!ssl)
-        return;
+    printNowTimeKST();
+    if (is_plain_connection(ssl))
+    {
+        cout << " [Thread " << std::this_thread::get_id() << "] 로컬 클라이언트 처리 시작. (Unix 소켓, TLS 없음)" << endl;
+    }
+    else
+    {
+        TlsHandshakeStats stats = get_handshake_stats();
+        cout << " [Thread " << std::this_thread::get_id() << "] SSL 클라이언트 처리 시작. ("
+             << (resumed ? "세션 재개" : "전체 핸드셰이크") << ", 누적 전체 " << stats.full << " / 재개 "
+             << stats.resumed << " / 실패 " << stats.failed << ", "
+             << (ktls_send_active(ssl) ? "kTLS 송신" : "사용자 공간 암호화") << ")" << endl;
+    }
 
-    // 데이터베이스 테이블 초기화
-    initialize_database_tables(db);
+    // 연결 세션 (송신 직렬화, 비동기 알림의 연결 수명 확인, 송신 정체/수신 유휴 시간 초과)
+    auto session = ClientSession::attach(ssl);
+    session->start_timeouts(client_socket, chrono::milliseconds(max(0, g_config.connection_write_stall_timeout_ms)));
+
+    // Unix 소켓의 상대는 같은 장비에 있어 사라지면 커널이 바로 연결을 닫으므로 TCP 연결에만 keepalive 적용
+    if (!is_plain_connection(ssl))
+    {
+        enable_tcp_keepalive(client_socket);
+    }
 
     // 스레드 관련 변수
     atomic<bool> bbox_push_enabled(false);
@@ -209,17 +374,23 @@ void handle_client(int client_socket, SQLite::Database& db, std::mutex& db_mutex
     while (true)
     {
         json received_json;
+        session->begin_read_wait();
         if (!receive_json_message(ssl, received_json))
         {
             break;
         }
+        session->end_read_wait();
 
         try
         {
-            printNowTimeKST();
-            cout << " [Thread " << std::this_thread::get_id() << "] 수신 성공:\n" << received_json.dump(2) << endl;
-
-            route_request(ssl, received_json, db, db_mutex, bbox_push_enabled, push_thread, metadata_thread);
+            // 주기적인 heartbeat는 로그에 남기지 않음
+            if (received_json.value("request_id", -1) != 35)
+            {
+                printNowTimeKST();
+                cout << " [Thread " << std::this_thread::get_id() << "] 수신 성공:\n" << received_json.dump(2) << endl;
+            }
+
+            route_request(ssl, received_json, db_pool, bbox_push_enabled, push_thread, metadata_thread);
         }
         catch (const json::parse_error& e)
         {
@@ -227,10 +398,64 @@ void handle_client(int client_socket, SQLite::Database& db, std::mutex& db_mutex
         }
     }
 
+    // 종료 정리 중이면 카메라 쓰기 명령의 완료 알림이 이 연결로 전달될 때까지 기다린 뒤 연결을 닫음
+    if (g_draining.load())
+    {
+        g_camera_commands.wait_idle(g_drain_deadline);
+    }
+
     // 정리 작업
     cleanup_client_connection(ssl, client_socket, bbox_push_enabled, push_thread, metadata_thread);
 }
 
+/**
+ * @brief TCP 서버가 쓰는 DB를 준비합니다. (연결 풀 열기, 스키마 마이그레이션, 라인 설정 로드)
+ * @return 성공 시 true, 실패 시 false
+ * @details 마이그레이션은 오래 걸릴 수 있으므로 이전 서버의 리스닝 소켓을 넘겨받기 전에 호출합니다.
+ *          (인계 확인 대기 시간에는 리스너 시작만 포함되도록 함)
+ */
+bool tcp_prepare()
+{
+    if (g_db_prepared)
+    {
+        return true;
+    }
+
+    // SQL 디버그 로그는 설정에서 켠 경우에만 출력 (getExpandedSQL 비용 회피)
+    g_sql_logging = g_config.db_log_sql;
+
+    // WAL 모드 DB 연결 풀 생성 (읽기 전용 연결 여러 개 + 쓰기 연결 1개)
+    DatabasePool& db_pool = g_db_pool;
+    if (!db_pool.open(g_config.db_file, g_config.db_reader_count, g_config.db_busy_timeout_ms))
+    {
+        cerr << "[ERROR] 데이터베이스 연결 실패" << endl;
+        return false;
+    }
+    cout << "데이터베이스 파일 '" << g_config.db_file << "'에 연결되었습니다.\n";
+
+    // 스키마 마이그레이션 (PRAGMA user_version 기준으로 시작 시 한 번, 클라이언트 연결 처리에는 DB 작업 없음)
+    try
+    {
+        db_pool.write([](SQLite::Database& db) { return run_schema_migrations(db); });
+    }
+    catch (const exception& e)
+    {
+        cerr << "[ERROR] 스키마 마이그레이션 실패: " << e.what() << endl;
+        db_pool.close();
+        return false;
+    }
+
+    // 감지선/기준선/수직선 설정을 메모리로 로드 (이후 조회는 스냅샷, 변경은 write-through)
+    if (!g_line_config.load(db_pool))
+    {
+        db_pool.close();
+        return false;
+    }
+
+    g_db_prepared = true;
+    return true;
+}
+
 /**
  * @brief TCP 서버 메인 함수. 서버를 초기화하고 클라이언트 연결을 처리합니다.
  * @return 정상 종료 시 0, 실패 시 음수
@@ -244,6 +469,23 @@ int tcp_run()
         return -1;
     }
 
+    // 끊긴 연결에 쓰면 프로세스가 종료되지 않고 쓰기 실패(EPIPE)로 처리되도록 SIGPIPE 무시
+    // (핸드셰이크 중 세션 티켓 전송, 응답 전송 중 클라이언트가 먼저 연결을 끊는 경우)
+    signal(SIGPIPE, SIG_IGN);
+
+    // 종료 시그널은 메인 스레드가 새 연결 수락을 멈추고 처리 중인 연결을 정리한 뒤 끝나도록 eventfd로 전달
+    g_shutdown_fd = eventfd(0, EFD_CLOEXEC);
+    if (g_shutdown_fd < 0)
+    {
+        cerr << "[ERROR] 종료 신호용 eventfd 생성 실패: " << strerror(errno) << endl;
+        return -1;
+    }
+    struct sigaction shutdown_action{};
+    shutdown_action.sa_handler = handle_shutdown_signal;
+    sigemptyset(&shutdown_action.sa_mask);
+    sigaction(SIGTERM, &shutdown_action, nullptr);
+    sigaction(SIGINT, &shutdown_action, nullptr);
+
     // OpenSSL 초기화
     if (!init_openssl())
     {
@@ -262,8 +504,20 @@ int tcp_run()
     // SSL 컨텍스트 설정
     configure_ssl_context(ssl_ctx);
 
-    SQLite::Database db(g_config.db_file, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
-    cout << "데이터베이스 파일 'server_log.db'에 연결되었습니다.\n";
+    // 재접속 시 비대칭 키 교환을 생략하도록 세션 티켓/세션 캐시 설정
+    configure_session_resumption(ssl_ctx, g_config.tls_session_cache_size, g_config.tls_session_timeout_sec,
+                                 g_config.tls_ticket_key_rotation_sec);
+
+    // 큰 응답과 bbox 스트림의 레코드 암호화를 커널에 맡김 (지원하지 않으면 연결별로 사용자 공간 암호화)
+    configure_ktls(ssl_ctx, g_config.tls_ktls);
+
+    // 인계 전에 준비하지 않고 단독으로 실행된 경우에는 여기서 DB를 준비
+    if (!tcp_prepare())
+    {
+        cleanup_openssl();
+        return -1;
+    }
+    DatabasePool& db_pool = g_db_pool;
 
     // libcurl 전역 초기화
     CURLcode res_global_init = curl_global_init(CURL_GLOBAL_DEFAULT);
@@ -273,52 +527,151 @@ int tcp_run()
         return -1;
     }
 
-    std::mutex db_mutex; // DB 접근을 보호할 뮤텍스 객체
+    // CCTV 감지선 캐시 갱신 스레드 시작 (조회 요청은 캐시로 응답)
+    g_camera_lines.start(g_config.camera_cache_refresh_sec);
+
+    // 카메라 쓰기 명령 큐 시작 (감지선 PUT/DELETE는 요청 처리 스레드를 막지 않음)
+    g_camera_commands.start(g_config.camera_command_max_attempts, g_config.camera_command_retry_base_ms);
 
-    int server_fd;
-    struct sockaddr_in address;
-    socklen_t addrlen = sizeof(address);
+    // 감지 데이터 보존 스레드 시작 (삭제는 연결 풀의 쓰기 큐에서 실행)
+    g_retention.start(db_pool, retention_policy_from_config());
 
-    server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    int opt = 1;
-    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(PORT);
-    if (bind(server_fd, (struct sockaddr*)&address, sizeof(address)) < 0)
+    auto start_client_thread = [&db_pool](SSL* ssl, int client_socket, bool resumed)
+    {
+        track_client_socket(client_socket);
+        std::thread client_thread(handle_client, ssl, client_socket, resumed, std::ref(db_pool));
+        client_thread.detach();
+    };
+
+    // 핸드셰이크 마감 시각과 연결별 송신 정체/수신 유휴 시간 초과를 스레드 하나의 타이머 휠로 관리
+    g_timer_wheel.start(chrono::milliseconds(g_config.connection_timer_tick_ms));
+
+    // TLS 핸드셰이크는 전용 스레드에서 비차단으로 진행하고, 끝난 연결만 클라이언트 처리 스레드로 넘김
+    if (!g_tls_handshaker.start(ssl_ctx, g_config.tls_handshake_timeout_ms, g_config.tls_max_concurrent_handshakes,
+                                g_config.tls_crypto_threads, start_client_thread))
     {
-        cerr << "Bind Failed" << endl;
         return -1;
     }
-    if (listen(server_fd, 10) < 0)
+
+    // 이전 서버에서 넘겨받은 리스닝 소켓이 있으면 새로 열지 않고 그대로 사용 (server.cpp에서 넘겨받음)
+    int inherited_local = g_listener_handoff.take_local();
+
+    // 같은 장비의 도구와 제어 데몬은 Unix 소켓으로 TLS 없이 같은 요청 처리 함수를 사용 (실패해도 TCP 서버는 계속)
+    if (!g_config.local_socket_enabled && inherited_local >= 0)
+    {
+        close(inherited_local);
+    }
+    else if (g_config.local_socket_enabled)
     {
-        cerr << "Listen Failed" << endl;
+        const auto& uids = g_config.local_socket_allowed_uids;
+        const auto& gids = g_config.local_socket_allowed_gids;
+        vector<uid_t> allowed_uids(uids.begin(), uids.end());
+        vector<gid_t> allowed_gids(gids.begin(), gids.end());
+        g_local_listener.start(ssl_ctx, g_config.local_socket_path, static_cast<mode_t>(g_config.local_socket_mode),
+                               allowed_uids, allowed_gids,
+                               [start_client_thread](SSL* ssl, int client_socket, const ucred&)
+                               { start_client_thread(ssl, client_socket, false); },
+                               inherited_local);
+    }
+
+    // 재접속이 몰려도 수락 큐 하나에 쌓이지 않도록 SO_REUSEPORT 리스닝 소켓마다 수락 스레드를 둠
+    // (동시 핸드셰이크가 상한이면 해당 수락 스레드가 잠시 멈추고, 그동안 새 연결은 그 소켓의 listen 백로그에 남음)
+    if (!g_tcp_acceptors.start(PORT, g_config.listener_acceptors, g_config.listener_backlog,
+                               g_config.listener_pin_threads,
+                               [](int client_socket, int acceptor)
+                               {
+                                   printNowTimeKST();
+                                   cout << " 수락 스레드 " << acceptor
+                                        << ": 클라이언트 연결 수락됨. TLS 핸드셰이크 시작..." << endl;
+
+                                   // 핸드셰이크가 끝나면 처리 스레드가 생성됨
+                                   g_tls_handshaker.submit(client_socket);
+                               },
+                               g_listener_handoff.take_tcp()))
+    {
+        cerr << "Bind Failed" << endl;
+        // 이전 서버에서 넘겨받은 로컬 소켓이면 소켓 파일은 이전 서버가 계속 쓰므로 지우지 않음
+        g_local_listener.stop(inherited_local < 0);
         return -1;
     }
 
     printNowTimeKST();
     cout << " 멀티스레드 서버 시작. 클라이언트 연결 대기 중... (Port: " << PORT << ")" << endl;
 
+    // 모든 리스너가 준비되면 이전 서버에 인계 완료를 알리고, 다음에 실행될 서버의 인계 요청을 받음
+    // (인계를 마치면 이 서버는 수락을 멈추고 처리 중인 연결을 정리한 뒤 종료)
+    if (g_config.restart_enabled)
+    {
+        g_listener_handoff.serve(
+            g_config.restart_handoff_path, g_config.restart_handoff_ack_timeout_sec,
+            [] { return ListenerSockets{g_tcp_acceptors.listen_fds(), g_local_listener.listen_socket(), -1}; },
+            []
+            {
+                g_handed_off = true;
+                request_shutdown();
+            });
+    }
+
+    // 메인 스레드는 종료 요청이 올 때까지 수락 큐 통계를 주기적으로 보고
+    int stats_interval_ms = max(1, g_config.listener_stats_interval_sec) * 1000;
     while (true)
     {
-        int new_socket = accept(server_fd, (struct sockaddr*)&address, &addrlen);
-        if (new_socket < 0)
+        pollfd shutdown_event{g_shutdown_fd, POLLIN, 0};
+        int ready = poll(&shutdown_event, 1, stats_interval_ms);
+        if (ready > 0)
+        {
+            break;
+        }
+        if (ready == 0)
         {
-            cerr << "연결 수락 실패" << endl;
-            continue;
+            g_tcp_acceptors.report();
         }
+    }
 
-        printNowTimeKST();
-        cout << " 메인 스레드: 클라이언트 연결 수락됨. 처리 스레드 생성..." << endl;
-
-        // 새 클라이언트를 처리할 스레드 생성 및 분리
-        std::thread client_thread(handle_client, new_socket, std::ref(db), std::ref(db_mutex));
-        client_thread.detach(); // 메인 스레드는 기다리지 않고 바로 다음
-                                // 클라이언트를 받으러 감
+    // 종료 전 정리: 새 연결 수락 중지 -> 진행 중인 핸드셰이크 완료 -> 처리 중인 요청 응답 후 연결 종료
+    bool handed_off = g_handed_off.load();
+    auto drain_deadline = chrono::steady_clock::now() + chrono::seconds(max(0, g_config.restart_drain_timeout_sec));
+    printNowTimeKST();
+    cout << " [Drain] " << (handed_off ? "새 서버에 리스닝 소켓을 넘겼습니다." : "종료 신호를 받았습니다.")
+         << " 새 연결 수락을 멈추고 처리 중인 연결을 정리합니다." << endl;
+
+    // 인계했으면 리스닝 소켓은 새 서버의 복사본이 계속 수락하고, 소켓 파일도 새 서버가 쓰므로 지우지 않음
+    g_listener_handoff.stop(!handed_off);
+    g_tcp_acceptors.stop();
+    g_local_listener.stop(!handed_off);
+
+    // 이미 수락한 연결의 핸드셰이크는 마감 시각까지 기다려 처리 스레드로 넘김 (중지 후에는 새 처리 스레드가 없음)
+    auto handshake_deadline = min(drain_deadline, chrono::steady_clock::now() +
+                                                      chrono::milliseconds(g_config.tls_handshake_timeout_ms +
+                                                                           g_config.connection_timer_tick_ms));
+    while (g_tls_handshaker.pending() > 0 && chrono::steady_clock::now() < handshake_deadline)
+    {
+        this_thread::sleep_for(chrono::milliseconds(50));
     }
+    g_tls_handshaker.stop();
 
-    close(server_fd);
+    // 끝나지 않은 처리 스레드가 DB 연결 풀과 타이머를 쓰고 있을 수 있으므로, 정리하지 않고 프로세스를 바로 끝냄
+    // (리스닝 소켓 파일은 위에서 이미 정리됨)
+    if (!drain_client_connections(drain_deadline))
+    {
+        cerr << "[Drain] 정리를 건너뛰고 프로세스를 종료합니다." << endl;
+        cout.flush();
+        _exit(1);
+    }
+    printNowTimeKST();
+    cout << " [Drain] 연결 정리 완료. 서버를 종료합니다." << endl;
+
+    g_timer_wheel.stop();
+    g_retention.stop();
+    db_pool.close();
+    g_camera_commands.stop();
+    g_camera_lines.stop();
+    cleanup_camera_http();
     curl_global_cleanup();
     cleanup_openssl();
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    close(g_shutdown_fd);
+    g_shutdown_fd = -1;
     return 0;
 }
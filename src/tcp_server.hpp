@@ -41,6 +41,7 @@
 
 // DB 관련 헤더
 #include "db_management.hpp"
+#include "db_pool.hpp"
 
 // 카메라에 line을 설정하기 위한 헤더
 #include "curl_camera.hpp"
@@ -84,6 +85,13 @@ string putLines(CrossLine);
  */
 string deleteLines(int index);
 
+/**
+ * @brief TCP 서버가 쓰는 DB를 준비합니다. (스키마 마이그레이션, 라인 설정 로드)
+ * @return 성공 시 true, 실패 시 false
+ * @details 이전 서버의 리스닝 소켓을 넘겨받기 전에 호출합니다. 호출하지 않으면 tcp_run에서 준비합니다.
+ */
+bool tcp_prepare();
+
 /**
  * @brief TCP 서버를 시작하고 클라이언트 연결을 대기합니다.
  * @return 성공 시 0, 실패 시 -1
@@ -91,19 +99,6 @@ string deleteLines(int index);
 int tcp_run();
 
 // ==================== 새로운 유틸리티 함수들 ====================
-/**
- * @brief 클라이언트 소켓에 SSL 연결을 설정합니다.
- * @param client_socket 클라이언트 소켓 파일 디스크립터
- * @return 성공 시 SSL 포인터, 실패 시 nullptr
- */
-SSL* setup_ssl_connection(int client_socket);
-
-/**
- * @brief 데이터베이스 테이블들을 초기화합니다.
- * @param db SQLite 데이터베이스 참조
- */
-void initialize_database_tables(SQLite::Database& db);
-
 /**
  * @brief SSL 연결에서 JSON 메시지를 수신합니다.
  * @param ssl OpenSSL SSL 포인터
@@ -117,93 +112,104 @@ bool receive_json_message(SSL* ssl, json& received_json);
  * @brief 감지 데이터 조회 요청을 처리합니다. (request_id == 1)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_detection_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_detection_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 감지선 좌표값 삽입 요청을 처리합니다. (request_id == 2)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_line_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_line_insert_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 감지선 전체 조회 요청을 처리합니다. (request_id == 3)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_line_select_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_line_select_all_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 감지선, 기준선, 수직선 전체 삭제 요청을 처리합니다. (request_id == 4)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_line_delete_all_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_line_delete_all_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 도로 기준선 삽입 요청을 처리합니다. (request_id == 5)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_baseline_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_baseline_insert_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 감지선의 수직선 방정식 삽입 요청을 처리합니다. (request_id == 6)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_vertical_line_insert_request(SSL* ssl, const json& received_json, SQLite::Database& db,
-                                         std::mutex& db_mutex);
+void handle_vertical_line_insert_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 도로 기준선 전체 조회 요청을 처리합니다. (request_id == 7)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_baseline_select_all_request(SSL* ssl, const json& received_json, SQLite::Database& db,
-                                        std::mutex& db_mutex);
+void handle_baseline_select_all_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 1단계 로그인 요청(ID/PW 검증)을 처리합니다. (request_id == 8)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_login_step1_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_login_step1_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 2단계 로그인 요청(OTP/복구코드 검증)을 처리합니다. (request_id == 22)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  */
-void handle_login_step2_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_login_step2_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief 회원가입 요청을 처리합니다. (request_id == 9)
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
+ */
+void handle_signup_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
+
+/**
+ * @brief 감지 데이터 보존 상태 조회 요청을 처리합니다. (request_id == 24)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ */
+void handle_retention_stats_request(SSL* ssl, const json& received_json);
+
+/**
+ * @brief 감지 이벤트 필터 조회 요청을 처리합니다. (request_id == 26)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ * @param db_pool DB 연결 풀
+ */
+void handle_detection_event_query_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
+
+/**
+ * @brief 감지 통계(집계) 조회 요청을 처리합니다. (request_id == 28)
+ * @param ssl OpenSSL SSL 포인터
+ * @param received_json 수신된 JSON 요청
+ * @param db_pool DB 연결 풀
  */
-void handle_signup_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex);
+void handle_detection_rollup_request(SSL* ssl, const json& received_json, DatabasePool& db_pool);
 
 /**
  * @brief BBox push 시작 요청을 처리합니다. (request_id == 31)
@@ -230,14 +236,13 @@ void handle_bbox_stop_request(SSL* ssl, std::atomic<bool>& bbox_push_enabled, st
  * @brief 수신된 JSON 요청을 적절한 처리 함수로 라우팅합니다.
  * @param ssl OpenSSL SSL 포인터
  * @param received_json 수신된 JSON 요청
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param db_pool DB 연결 풀
  * @param bbox_push_enabled BBox push 활성화 플래그
  * @param push_thread BBox push 스레드 참조
  * @param metadata_thread 메타데이터 파싱 스레드 참조
  */
-void route_request(SSL* ssl, const json& received_json, SQLite::Database& db, std::mutex& db_mutex,
-                   std::atomic<bool>& bbox_push_enabled, std::thread& push_thread, std::thread& metadata_thread);
+void route_request(SSL* ssl, const json& received_json, DatabasePool& db_pool, std::atomic<bool>& bbox_push_enabled,
+                   std::thread& push_thread, std::thread& metadata_thread);
 
 /**
  * @brief 클라이언트 연결을 정리하고 관련 리소스를 해제합니다.
@@ -253,9 +258,10 @@ void cleanup_client_connection(SSL* ssl, int client_socket, std::atomic<bool>& b
 // ==================== 메인 클라이언트 처리 함수 ====================
 /**
  * @brief 개별 클라이언트와의 연결을 처리하는 메인 함수입니다.
- * @details SSL 연결 설정, JSON 메시지 수신, 요청 라우팅, 연결 정리를 담당합니다.
+ * @details JSON 메시지 수신, 요청 라우팅, 연결 정리를 담당합니다. TLS 핸드셰이크는 TlsHandshaker가 마친 뒤 호출됩니다.
+ * @param ssl 핸드셰이크를 마친 SSL 포인터
  * @param client_socket 클라이언트 소켓 파일 디스크립터
- * @param db SQLite 데이터베이스 참조
- * @param db_mutex DB 접근 뮤텍스
+ * @param resumed 세션 재개 여부
+ * @param db_pool DB 연결 풀
  */
-void handle_client(int client_socket, SQLite::Database& db, std::mutex& db_mutex);
+void handle_client(SSL* ssl, int client_socket, bool resumed, DatabasePool& db_pool);
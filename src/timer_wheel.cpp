@@ -0,0 +1,304 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief 계층형 타이머 휠 구현 파일
+ * @details 칸 배치(link/unlink), 틱 진행과 상위 단계 칸 내리기(advance), 휠 스레드(run)를 구현합니다.
+ */
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 타이머 휠 인스턴스
+ */
+TimerWheel g_timer_wheel;
+
+/**
+ * @brief 소멸자. 휠 스레드를 중지함
+ */
+TimerWheel::~TimerWheel()
+{
+    stop();
+}
+
+/**
+ * @brief 휠 스레드를 시작합니다.
+ * @param tick 틱 간격 (타이머 해상도)
+ * @return 성공 시 true
+ */
+bool TimerWheel::start(chrono::milliseconds tick)
+{
+    if (running.load())
+    {
+        return true;
+    }
+    this->tick = max(chrono::milliseconds(1), tick);
+    running = true;
+    thread = std::thread(&TimerWheel::run, this);
+    return true;
+}
+
+/**
+ * @brief 휠 스레드를 중지합니다. (남은 타이머는 실행하지 않음)
+ */
+void TimerWheel::stop()
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        if (!running.exchange(false))
+        {
+            return;
+        }
+    }
+    stop_cv.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+/**
+ * @brief 해제 상태의 타이머를 만듭니다.
+ * @param callback 만료 시 휠 스레드에서 실행할 콜백
+ * @return 타이머 식별자
+ */
+TimerId TimerWheel::add(function<void()> callback)
+{
+    lock_guard<std::mutex> lock(mutex);
+    auto timer = make_unique<Timer>();
+    timer->id = next_id++;
+    timer->callback = std::move(callback);
+    TimerId id = timer->id;
+    timers.emplace(id, std::move(timer));
+    return id;
+}
+
+/**
+ * @brief 타이머를 지금부터 delay 뒤에 만료되도록 설정합니다.
+ * @param id 타이머 식별자
+ * @param delay 만료까지의 시간
+ */
+void TimerWheel::arm(TimerId id, chrono::milliseconds delay)
+{
+    lock_guard<std::mutex> lock(mutex);
+    auto it = timers.find(id);
+    if (it == timers.end())
+    {
+        return;
+    }
+    Timer* timer = it->second.get();
+    if (timer->armed)
+    {
+        unlink(timer);
+    }
+    // 다음 틱까지 남은 시간을 모르므로 한 틱을 더해 delay보다 일찍 만료되지 않게 함
+    uint64_t ticks = static_cast<uint64_t>((max<long long>(0, delay.count()) + tick.count() - 1) / tick.count()) + 1;
+    timer->expires = current_tick + ticks;
+    timer->generation++;
+    timer->armed = true;
+    link(timer);
+}
+
+/**
+ * @brief 타이머를 해제합니다.
+ * @param id 타이머 식별자
+ */
+void TimerWheel::disarm(TimerId id)
+{
+    lock_guard<std::mutex> lock(mutex);
+    auto it = timers.find(id);
+    if (it == timers.end())
+    {
+        return;
+    }
+    Timer* timer = it->second.get();
+    if (timer->armed)
+    {
+        unlink(timer);
+        timer->armed = false;
+    }
+    timer->generation++;
+}
+
+/**
+ * @brief 타이머를 지웁니다.
+ * @param id 타이머 식별자 (0이면 무시)
+ */
+void TimerWheel::remove(TimerId id)
+{
+    if (id == 0)
+    {
+        return;
+    }
+    unique_lock<std::mutex> lock(mutex);
+    // 휠 스레드(콜백 안)에서 자기 자신을 지우는 경우는 기다리지 않음
+    if (this_thread::get_id() != thread_id)
+    {
+        callback_done.wait(lock, [this, id] { return running_timer != id; });
+    }
+    auto it = timers.find(id);
+    if (it == timers.end())
+    {
+        return;
+    }
+    if (it->second->armed)
+    {
+        unlink(it->second.get());
+    }
+    timers.erase(it);
+}
+
+/**
+ * @brief 등록된 타이머 수를 반환합니다.
+ * @return 타이머 수
+ */
+size_t TimerWheel::size()
+{
+    lock_guard<std::mutex> lock(mutex);
+    return timers.size();
+}
+
+/**
+ * @brief 타이머를 만료 틱에 맞는 단계와 칸에 답니다.
+ * @details 남은 틱이 64 미만이면 0단계, 64^2 미만이면 1단계처럼 남은 틱의 크기로 단계를 고르고, 그 단계에서는 만료
+ *          틱의 해당 자리 비트로 칸을 고릅니다.
+ * @param timer 타이머
+ */
+void TimerWheel::link(Timer* timer)
+{
+    const uint64_t max_delta = (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    if (timer->expires <= current_tick)
+    {
+        timer->expires = current_tick + 1;
+    }
+    else if (timer->expires - current_tick > max_delta)
+    {
+        timer->expires = current_tick + max_delta;
+    }
+
+    uint64_t delta = timer->expires - current_tick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1))))
+    {
+        level++;
+    }
+    int slot = static_cast<int>((timer->expires >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    Timer*& head = slots[level][slot];
+    timer->head = &head;
+    timer->prev = nullptr;
+    timer->next = head;
+    if (head)
+    {
+        head->prev = timer;
+    }
+    head = timer;
+}
+
+/**
+ * @brief 타이머를 칸에서 뗍니다.
+ * @param timer 타이머
+ */
+void TimerWheel::unlink(Timer* timer)
+{
+    if (timer->prev)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        *timer->head = timer->next;
+    }
+    if (timer->next)
+    {
+        timer->next->prev = timer->prev;
+    }
+    timer->head = nullptr;
+    timer->prev = nullptr;
+    timer->next = nullptr;
+}
+
+/**
+ * @brief 틱 하나를 진행하고 만료된 타이머를 모읍니다.
+ * @details 하위 단계가 한 바퀴를 돌면 상위 단계의 현재 칸에 있던 타이머를 다시 배치하여 하위 단계로 내립니다.
+ * @param expired 만료된 타이머 식별자와 세대 (출력)
+ */
+void TimerWheel::advance(vector<pair<TimerId, uint64_t>>& expired)
+{
+    current_tick++;
+    for (int level = 1; level < LEVELS; ++level)
+    {
+        if ((current_tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0)
+        {
+            break;
+        }
+        int slot = static_cast<int>((current_tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+        Timer* timer = slots[level][slot];
+        slots[level][slot] = nullptr;
+        while (timer)
+        {
+            Timer* next = timer->next;
+            link(timer);
+            timer = next;
+        }
+    }
+
+    int slot = static_cast<int>(current_tick & (SLOTS - 1));
+    Timer* timer = slots[0][slot];
+    slots[0][slot] = nullptr;
+    while (timer)
+    {
+        Timer* next = timer->next;
+        timer->head = nullptr;
+        timer->prev = nullptr;
+        timer->next = nullptr;
+        timer->armed = false;
+        expired.emplace_back(timer->id, timer->generation);
+        timer = next;
+    }
+}
+
+/**
+ * @brief 휠 스레드 본체
+ * @details 틱 시각은 시작 시각 기준으로 계산하므로, 콜백이 오래 걸려 늦어진 틱은 이어서 따라잡습니다.
+ */
+void TimerWheel::run()
+{
+    unique_lock<std::mutex> lock(mutex);
+    thread_id = this_thread::get_id();
+    auto started = chrono::steady_clock::now();
+    uint64_t ticks_done = current_tick;
+    vector<pair<TimerId, uint64_t>> expired;
+    while (running.load())
+    {
+        auto next_tick = started + tick * static_cast<long long>(current_tick - ticks_done + 1);
+        if (stop_cv.wait_until(lock, next_tick, [this] { return !running.load(); }))
+        {
+            break;
+        }
+
+        expired.clear();
+        advance(expired);
+        for (const auto& entry : expired)
+        {
+            // 모은 뒤 다시 설정/해제되었거나 지워진 타이머는 실행하지 않음
+            auto it = timers.find(entry.first);
+            if (it == timers.end() || it->second->generation != entry.second || it->second->armed)
+            {
+                continue;
+            }
+            // 콜백 안에서 자기 타이머를 지울 수 있으므로(기다리지 않고 바로 지워짐) 복사본을 실행
+            running_timer = entry.first;
+            function<void()> callback = it->second->callback;
+            lock.unlock();
+            callback();
+            lock.lock();
+            running_timer = 0;
+            callback_done.notify_all();
+        }
+    }
+    thread_id = std::thread::id();
+}
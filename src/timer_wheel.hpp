@@ -0,0 +1,172 @@
+/**
+ * @file timer_wheel.hpp
+ * @brief 계층형 타이머 휠 헤더 파일
+ * @details 모든 연결의 마감 시각(수신 유휴, 송신 정체, TLS 핸드셰이크)을 스레드 하나로 관리합니다. 타이머는 4단계
+ *          휠(단계마다 64칸)의 칸에 이중 연결 리스트로 달리며, 등록/재설정/해제는 타이머 수와 관계없이 O(1)입니다.
+ *          상위 단계의 칸은 하위 단계가 한 바퀴 돌 때마다 한 칸씩 하위 단계로 내려옵니다. 틱 100ms 기준 최대 약 19일까지
+ *          예약할 수 있고, 그보다 긴 지연은 최대값으로 줄입니다.
+ *
+ *          타이머는 add()로 한 번 만들고 arm()/disarm()으로 여러 번 다시 씁니다. 연결마다 메시지를 받을 때마다 유휴
+ *          타이머를 재설정해도 할당이 일어나지 않습니다. 콜백은 휠 스레드에서 잠금 없이 실행되므로 짧게 끝나야 합니다.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 타이머 식별자 (0은 타이머 없음)
+ */
+using TimerId = uint64_t;
+
+/**
+ * @class TimerWheel
+ * @brief 계층형 타이머 휠
+ * @details 만료된 타이머는 해제 상태가 되며, 다시 arm()하기 전까지 남아 있습니다. 타이머 콜백 안에서도 arm(),
+ *          disarm(), remove()를 호출할 수 있습니다.
+ */
+class TimerWheel
+{
+public:
+    /**
+     * @brief 소멸자. 휠 스레드를 중지함
+     */
+    ~TimerWheel();
+
+    /**
+     * @brief 휠 스레드를 시작합니다.
+     * @param tick 틱 간격 (타이머 해상도)
+     * @return 성공 시 true
+     */
+    bool start(std::chrono::milliseconds tick);
+
+    /**
+     * @brief 휠 스레드를 중지합니다. (남은 타이머는 실행하지 않음)
+     */
+    void stop();
+
+    /**
+     * @brief 해제 상태의 타이머를 만듭니다.
+     * @param callback 만료 시 휠 스레드에서 실행할 콜백
+     * @return 타이머 식별자
+     */
+    TimerId add(std::function<void()> callback);
+
+    /**
+     * @brief 타이머를 지금부터 delay 뒤에 만료되도록 설정합니다. (이미 설정되어 있으면 다시 설정)
+     * @details 만료는 delay보다 이르지 않고, 최대 한 틱 늦을 수 있습니다.
+     * @param id 타이머 식별자
+     * @param delay 만료까지의 시간
+     */
+    void arm(TimerId id, std::chrono::milliseconds delay);
+
+    /**
+     * @brief 타이머를 해제합니다. (이미 실행 중인 콜백은 기다리지 않음)
+     * @param id 타이머 식별자
+     */
+    void disarm(TimerId id);
+
+    /**
+     * @brief 타이머를 지웁니다.
+     * @details 다른 스레드에서 호출하면 실행 중인 이 타이머의 콜백이 끝날 때까지 기다리므로, 반환 후에는 콜백이
+     *          실행되지 않습니다. 콜백이 잡는 잠금을 쥔 채로 호출하면 안 됩니다. 콜백 안에서 호출하면 기다리지 않고
+     *          바로 지우며, 실행 중인 콜백은 휠이 가진 복사본이므로 끝까지 실행됩니다.
+     * @param id 타이머 식별자 (0이면 무시)
+     */
+    void remove(TimerId id);
+
+    /**
+     * @brief 등록된 타이머 수를 반환합니다.
+     * @return 타이머 수
+     */
+    size_t size();
+
+private:
+    /**
+     * @brief 단계 수, 단계별 칸 수(비트 수)
+     */
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    /**
+     * @brief 타이머 하나 (칸의 이중 연결 리스트 노드)
+     */
+    struct Timer
+    {
+        TimerId id = 0;
+        std::function<void()> callback;
+        uint64_t expires = 0;    ///< 만료 틱
+        uint64_t generation = 0; ///< arm/disarm마다 증가 (수집 후 다시 설정된 타이머를 실행하지 않기 위함)
+        bool armed = false;
+        Timer** head = nullptr; ///< 달려 있는 칸의 리스트 머리
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+    };
+
+    /**
+     * @brief 타이머를 만료 틱에 맞는 단계와 칸에 답니다. (mutex를 잡은 상태에서 호출)
+     * @param timer 타이머
+     */
+    void link(Timer* timer);
+
+    /**
+     * @brief 타이머를 칸에서 뗍니다. (mutex를 잡은 상태에서 호출)
+     * @param timer 타이머
+     */
+    void unlink(Timer* timer);
+
+    /**
+     * @brief 틱 하나를 진행하고 만료된 타이머를 모읍니다. (mutex를 잡은 상태에서 호출)
+     * @param expired 만료된 타이머 식별자와 세대 (출력)
+     */
+    void advance(std::vector<std::pair<TimerId, uint64_t>>& expired);
+
+    /**
+     * @brief 휠 스레드 본체
+     */
+    void run();
+
+    /**
+     * @brief 타이머 목록과 단계별 칸
+     */
+    std::unordered_map<TimerId, std::unique_ptr<Timer>> timers;
+    Timer* slots[LEVELS][SLOTS] = {};
+
+    /**
+     * @brief 현재 틱, 다음 식별자, 콜백을 실행 중인 타이머
+     */
+    uint64_t current_tick = 0;
+    TimerId next_id = 1;
+    TimerId running_timer = 0;
+
+    /**
+     * @brief 보호용 뮤텍스, 콜백 완료/중지 신호
+     */
+    std::mutex mutex;
+    std::condition_variable callback_done;
+    std::condition_variable stop_cv;
+
+    /**
+     * @brief 휠 스레드와 실행 상태, 틱 간격
+     */
+    std::thread thread;
+    std::thread::id thread_id;
+    std::atomic<bool> running{false};
+    std::chrono::milliseconds tick{100};
+};
+
+/**
+ * @brief 서버 전역 타이머 휠 인스턴스
+ */
+extern TimerWheel g_timer_wheel;
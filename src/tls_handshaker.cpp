@@ -0,0 +1,404 @@
+/**
+ * @file tls_handshaker.cpp
+ * @brief 비차단 TLS 핸드셰이크 처리기 구현 파일
+ * @details epoll(EPOLLONESHOT) 기반 이벤트 스레드, 암호 연산 스레드 풀, 타이머 휠을 이용한 핸드셰이크 마감 시각
+ *          처리를 구현합니다.
+ */
+
+#include "tls_handshaker.hpp"
+
+#include "timer_wheel.hpp"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief 서버 전역 TLS 핸드셰이크 처리기 인스턴스
+ */
+TlsHandshaker g_tls_handshaker;
+
+/**
+ * @brief 소켓의 비차단 모드를 켜거나 끕니다.
+ * @param fd 소켓 디스크립터
+ * @param non_blocking 비차단 모드 여부
+ * @return 성공 시 true
+ */
+static bool set_non_blocking(int fd, bool non_blocking)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0)
+    {
+        return false;
+    }
+    flags = non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(fd, F_SETFL, flags) == 0;
+}
+
+/**
+ * @brief 소멸자. 실행 중인 스레드를 중지함
+ */
+TlsHandshaker::~TlsHandshaker()
+{
+    stop();
+}
+
+/**
+ * @brief 이벤트 스레드와 암호 연산 스레드를 시작합니다.
+ * @param ctx 서버 SSL_CTX
+ * @param timeout_ms 핸드셰이크 마감 시간(ms, 동시 핸드셰이크 자리를 얻은 시점부터)
+ * @param max_concurrent 동시에 진행할 수 있는 최대 핸드셰이크 수
+ * @param crypto_threads 암호 연산 스레드 수
+ * @param on_ready 핸드셰이크가 끝난 연결을 넘겨받는 콜백
+ * @return 성공 시 true
+ */
+bool TlsHandshaker::start(SSL_CTX* ctx, int timeout_ms, int max_concurrent, int crypto_threads,
+                          TlsReadyCallback on_ready)
+{
+    if (running.load())
+    {
+        return true;
+    }
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0)
+    {
+        cerr << "[TLS] 핸드셰이크 epoll 생성 실패: " << strerror(errno) << endl;
+        return false;
+    }
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event);
+
+    this->ctx = ctx;
+    this->timeout = chrono::milliseconds(max(1000, timeout_ms));
+    this->max_concurrent = static_cast<size_t>(max(1, max_concurrent));
+    this->on_ready = std::move(on_ready);
+    crypto_threads = max(1, crypto_threads);
+
+    running = true;
+    event_thread = thread(&TlsHandshaker::event_loop, this);
+    for (int i = 0; i < crypto_threads; ++i)
+    {
+        crypto_workers.emplace_back(&TlsHandshaker::crypto_loop, this);
+    }
+    cout << "[TLS] 핸드셰이크 처리기 시작 (timeout=" << timeout.count() << "ms, max_concurrent=" << this->max_concurrent
+         << ", crypto_threads=" << crypto_threads << ")" << endl;
+    return true;
+}
+
+/**
+ * @brief 모든 스레드를 중지하고 진행 중인 핸드셰이크의 소켓을 닫습니다.
+ */
+void TlsHandshaker::stop()
+{
+    {
+        lock_guard<mutex> lock(handshakes_mutex);
+        if (!running.exchange(false))
+        {
+            return;
+        }
+    }
+    slot_cv.notify_all();
+    {
+        lock_guard<mutex> lock(crypto_mutex);
+    }
+    crypto_cv.notify_all();
+    uint64_t one = 1;
+    (void)write(wake_fd, &one, sizeof(one));
+
+    if (event_thread.joinable())
+    {
+        event_thread.join();
+    }
+    for (auto& worker : crypto_workers)
+    {
+        worker.join();
+    }
+    crypto_workers.clear();
+    crypto_queue.clear();
+
+    // 만료 콜백이 실행 중이면 끝날 때까지 기다린 뒤 남은 핸드셰이크를 정리 (콜백이 처리한 것은 목록에서 빠짐)
+    vector<TimerId> timers;
+    {
+        lock_guard<mutex> lock(handshakes_mutex);
+        for (const auto& entry : handshakes)
+        {
+            timers.push_back(entry.second->timer);
+        }
+    }
+    for (TimerId timer : timers)
+    {
+        g_timer_wheel.remove(timer);
+    }
+    for (auto& entry : handshakes)
+    {
+        SSL_free(entry.second->ssl);
+        close(entry.second->fd);
+    }
+    handshakes.clear();
+    close(epoll_fd);
+    close(wake_fd);
+    epoll_fd = -1;
+    wake_fd = -1;
+}
+
+/**
+ * @brief 수락된 소켓의 핸드셰이크를 시작합니다.
+ * @param client_socket 수락된 클라이언트 소켓 (소유권 이전)
+ * @return 핸드셰이크를 시작했으면 true, 실패(소켓은 닫힘) 시 false
+ */
+bool TlsHandshaker::submit(int client_socket)
+{
+    SSL* ssl = SSL_new(ctx);
+    if (!ssl || !set_non_blocking(client_socket, true))
+    {
+        ERR_print_errors_fp(stderr);
+        SSL_free(ssl);
+        close(client_socket);
+        return false;
+    }
+    SSL_set_fd(ssl, client_socket);
+
+    auto handshake = make_shared<Handshake>();
+    handshake->fd = client_socket;
+    handshake->ssl = ssl;
+    weak_ptr<Handshake> weak = handshake;
+    handshake->timer = g_timer_wheel.add([this, weak] { expire(weak); });
+    {
+        unique_lock<mutex> lock(handshakes_mutex);
+        if (handshakes.size() >= max_concurrent)
+        {
+            cout << "[TLS] 동시 핸드셰이크 상한(" << max_concurrent << ") 도달, 자리가 날 때까지 대기" << endl;
+        }
+        slot_cv.wait(lock, [this] { return !running.load() || handshakes.size() < max_concurrent; });
+        if (!running.load())
+        {
+            lock.unlock();
+            g_timer_wheel.remove(handshake->timer);
+            SSL_free(ssl);
+            close(client_socket);
+            return false;
+        }
+        // 마감 시각은 자리를 얻은 시점부터 (대기 중에는 클라이언트가 보낸 데이터가 소켓 버퍼에 쌓여 있음)
+        handshake->deadline = chrono::steady_clock::now() + timeout;
+        handshakes[client_socket] = handshake;
+    }
+    g_timer_wheel.arm(handshake->timer, timeout);
+
+    // TLS는 클라이언트가 먼저 ClientHello를 보내므로 읽기 준비부터 기다림
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.fd = client_socket;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &event) < 0)
+    {
+        fail(handshake, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 진행 중인 핸드셰이크 수를 반환합니다.
+ * @return 핸드셰이크 수
+ */
+size_t TlsHandshaker::pending()
+{
+    lock_guard<mutex> lock(handshakes_mutex);
+    return handshakes.size();
+}
+
+/**
+ * @brief 이벤트 스레드 본체. 준비된 소켓의 핸드셰이크를 암호 연산 큐로 보냄
+ * @details 마감 시각은 타이머 휠이 처리하므로 소켓 준비나 중지 신호가 올 때까지만 기다립니다.
+ */
+void TlsHandshaker::event_loop()
+{
+    vector<epoll_event> events(64);
+    while (running.load())
+    {
+        int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+        if (count < 0 && errno != EINTR)
+        {
+            cerr << "[TLS] 핸드셰이크 epoll_wait 실패: " << strerror(errno) << endl;
+            continue;
+        }
+
+        vector<shared_ptr<Handshake>> ready;
+        {
+            lock_guard<mutex> lock(handshakes_mutex);
+            for (int i = 0; i < count; ++i)
+            {
+                int fd = events[i].data.fd;
+                if (fd == wake_fd)
+                {
+                    uint64_t value;
+                    (void)read(wake_fd, &value, sizeof(value));
+                    continue;
+                }
+                auto it = handshakes.find(fd);
+                if (it != handshakes.end() && !it->second->running)
+                {
+                    it->second->running = true;
+                    ready.push_back(it->second);
+                }
+            }
+        }
+
+        if (!ready.empty())
+        {
+            {
+                lock_guard<mutex> lock(crypto_mutex);
+                crypto_queue.insert(crypto_queue.end(), ready.begin(), ready.end());
+            }
+            crypto_cv.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief 마감 시각이 된 핸드셰이크를 실패로 처리합니다. (타이머 휠 스레드에서 호출)
+ * @details 암호 연산 큐/스레드에 있는 핸드셰이크는 건너뜁니다. 그 단계가 끝나 다시 기다리려 할 때 step()이 마감
+ *          시각을 확인합니다.
+ * @param weak 마감 시각이 된 핸드셰이크
+ */
+void TlsHandshaker::expire(const weak_ptr<Handshake>& weak)
+{
+    auto handshake = weak.lock();
+    if (!handshake)
+    {
+        return;
+    }
+    {
+        lock_guard<mutex> lock(handshakes_mutex);
+        auto it = handshakes.find(handshake->fd);
+        if (it == handshakes.end() || it->second != handshake || handshake->running)
+        {
+            return;
+        }
+        handshake->running = true;
+    }
+    fail(handshake, "시간 초과");
+}
+
+/**
+ * @brief 암호 연산 스레드 본체. 큐에서 핸드셰이크를 꺼내 다음 단계를 실행
+ */
+void TlsHandshaker::crypto_loop()
+{
+    while (true)
+    {
+        shared_ptr<Handshake> handshake;
+        {
+            unique_lock<mutex> lock(crypto_mutex);
+            crypto_cv.wait(lock, [this] { return !running.load() || !crypto_queue.empty(); });
+            if (!running.load())
+            {
+                return;
+            }
+            handshake = crypto_queue.front();
+            crypto_queue.pop_front();
+        }
+        step(handshake);
+    }
+}
+
+/**
+ * @brief 핸드셰이크 한 단계(SSL_accept)를 실행하고 결과에 따라 완료, 재감시, 실패 처리합니다.
+ * @details 다시 기다려야 하면 running 해제와 EPOLL_CTL_MOD를 handshakes_mutex 안에서 함께 하므로, 그 사이 도착한
+ *          이벤트도 이벤트 스레드가 놓치지 않습니다. 단계를 실행하는 동안 마감 시각이 지났으면(만료 타이머가 건너뜀)
+ *          다시 기다리지 않고 실패로 처리합니다.
+ * @param handshake 실행할 핸드셰이크
+ */
+void TlsHandshaker::step(const shared_ptr<Handshake>& handshake)
+{
+    if (chrono::steady_clock::now() >= handshake->deadline)
+    {
+        fail(handshake, "시간 초과");
+        return;
+    }
+
+    ERR_clear_error();
+    int ret = SSL_accept(handshake->ssl);
+    if (ret == 1)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, handshake->fd, nullptr);
+        remove(handshake);
+        set_non_blocking(handshake->fd, false);
+        bool resumed = record_handshake(handshake->ssl, true);
+        on_ready(handshake->ssl, handshake->fd, resumed);
+        return;
+    }
+
+    int error = SSL_get_error(handshake->ssl, ret);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE)
+    {
+        epoll_event event{};
+        event.events = (error == SSL_ERROR_WANT_READ ? EPOLLIN : EPOLLOUT) | EPOLLONESHOT;
+        event.data.fd = handshake->fd;
+        const char* reason = "시간 초과";
+        {
+            lock_guard<mutex> lock(handshakes_mutex);
+            if (chrono::steady_clock::now() < handshake->deadline)
+            {
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, handshake->fd, &event) == 0)
+                {
+                    handshake->running = false;
+                    return;
+                }
+                reason = strerror(errno);
+            }
+        }
+        fail(handshake, reason);
+        return;
+    }
+
+    ERR_print_errors_fp(stderr);
+    fail(handshake, "SSL_accept 실패");
+}
+
+/**
+ * @brief 핸드셰이크를 목록에서 빼고 만료 타이머를 지운 뒤 자리를 기다리는 submit을 깨웁니다.
+ * @details 소켓을 닫기 전에 호출해야 같은 디스크립터 번호로 수락된 새 연결을 지우지 않습니다. 만료 콜백이
+ *          handshakes_mutex를 잡으므로 타이머는 잠금 밖에서 지웁니다.
+ * @param handshake 뺄 핸드셰이크
+ */
+void TlsHandshaker::remove(const shared_ptr<Handshake>& handshake)
+{
+    {
+        lock_guard<mutex> lock(handshakes_mutex);
+        auto it = handshakes.find(handshake->fd);
+        if (it != handshakes.end() && it->second == handshake)
+        {
+            handshakes.erase(it);
+        }
+    }
+    g_timer_wheel.remove(handshake->timer);
+    slot_cv.notify_one();
+}
+
+/**
+ * @brief 실패한 핸드셰이크를 정리합니다. (SSL 해제, 소켓 닫기, 실패 통계 기록)
+ * @param handshake 실패한 핸드셰이크
+ * @param reason 로그에 남길 실패 이유
+ */
+void TlsHandshaker::fail(const shared_ptr<Handshake>& handshake, const char* reason)
+{
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, handshake->fd, nullptr);
+    remove(handshake);
+    record_handshake(handshake->ssl, false);
+    SSL_free(handshake->ssl);
+    close(handshake->fd);
+    TlsHandshakeStats stats = get_handshake_stats();
+    cerr << "[TLS] 핸드셰이크 실패: " << reason << " (누적 실패 " << stats.failed << ")" << endl;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file tls_handshaker.hpp
+ * @brief 비차단 TLS 핸드셰이크 처리기 헤더 파일
+ * @details 수락된 소켓의 SSL_accept를 클라이언트 처리 스레드가 아닌 별도 단계에서 끝냅니다. 이벤트 스레드 하나가
+ *          epoll로 소켓 준비 상태를 감시하고 핸드셰이크 마감 시각은 타이머 휠(g_timer_wheel)이 관리하며, 준비된 핸드셰이크의 다음 단계(SSL_accept 한 번,
+ *          키 교환과 서명 포함)는 크기가 고정된 암호 연산 스레드 풀에서 실행합니다. 동시에 진행 중인 핸드셰이크 수에
+ *          상한을 두어, 네트워크 단절 직후 재접속이 몰려도 암호 연산이 요청 처리 스레드를 잠식하지 않게 합니다.
+ *          마감 시각까지 끝나지 않은 핸드셰이크는 실패로 처리하고 소켓을 닫습니다.
+ */
+
+#pragma once
+
+#include "ssl.hpp"
+#include "timer_wheel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 핸드셰이크가 끝난 연결을 넘겨받는 콜백 (암호 연산 스레드에서 호출, 소켓은 다시 차단 모드)
+ * @param ssl 핸드셰이크를 마친 SSL 포인터 (소유권 이전)
+ * @param client_socket 클라이언트 소켓 디스크립터 (소유권 이전)
+ * @param resumed 세션 재개 여부
+ */
+using TlsReadyCallback = std::function<void(SSL* ssl, int client_socket, bool resumed)>;
+
+/**
+ * @class TlsHandshaker
+ * @brief epoll 이벤트 스레드와 암호 연산 스레드 풀로 구성된 비차단 TLS 핸드셰이크 상태 머신
+ * @details 핸드셰이크 하나는 항상 이벤트 스레드의 대기 목록(소켓 준비 대기)이나 암호 연산 큐/스레드(단계 실행 중)
+ *          중 한 곳에만 있습니다. 소켓은 EPOLLONESHOT으로 등록하여 한 단계가 끝난 뒤에만 다시 감시합니다.
+ */
+class TlsHandshaker
+{
+public:
+    /**
+     * @brief 소멸자. 실행 중인 스레드를 중지함
+     */
+    ~TlsHandshaker();
+
+    /**
+     * @brief 이벤트 스레드와 암호 연산 스레드를 시작합니다.
+     * @param ctx 서버 SSL_CTX
+     * @param timeout_ms 핸드셰이크 마감 시간(ms, 동시 핸드셰이크 자리를 얻은 시점부터)
+     * @param max_concurrent 동시에 진행할 수 있는 최대 핸드셰이크 수
+     * @param crypto_threads 암호 연산 스레드 수
+     * @param on_ready 핸드셰이크가 끝난 연결을 넘겨받는 콜백
+     * @return 성공 시 true
+     */
+    bool start(SSL_CTX* ctx, int timeout_ms, int max_concurrent, int crypto_threads, TlsReadyCallback on_ready);
+
+    /**
+     * @brief 모든 스레드를 중지하고 진행 중인 핸드셰이크의 소켓을 닫습니다.
+     */
+    void stop();
+
+    /**
+     * @brief 수락된 소켓의 핸드셰이크를 시작합니다.
+     * @details 진행 중인 핸드셰이크가 상한에 도달했으면 자리가 날 때까지 기다립니다. (그동안 새 연결은 listen
+     *          백로그에 남음)
+     * @param client_socket 수락된 클라이언트 소켓 (소유권 이전)
+     * @return 핸드셰이크를 시작했으면 true, 실패(소켓은 닫힘) 시 false
+     */
+    bool submit(int client_socket);
+
+    /**
+     * @brief 진행 중인 핸드셰이크 수를 반환합니다. (종료 전 정리에서 남은 핸드셰이크를 기다릴 때 사용)
+     * @return 핸드셰이크 수
+     */
+    size_t pending();
+
+private:
+    /**
+     * @brief 진행 중인 핸드셰이크 하나의 상태
+     */
+    struct Handshake
+    {
+        int fd = -1;
+        SSL* ssl = nullptr;
+        std::chrono::steady_clock::time_point deadline;
+        TimerId timer = 0;    ///< 마감 시각 타이머
+        bool running = false; ///< 암호 연산 큐/스레드에 있으면 true (만료 타이머가 실패 처리하지 않음)
+    };
+
+    /**
+     * @brief 이벤트 스레드 본체. 준비된 소켓의 핸드셰이크를 암호 연산 큐로 보냄
+     */
+    void event_loop();
+
+    /**
+     * @brief 마감 시각이 된 핸드셰이크를 실패로 처리합니다. (타이머 휠 스레드에서 호출)
+     * @param weak 마감 시각이 된 핸드셰이크
+     */
+    void expire(const std::weak_ptr<Handshake>& weak);
+
+    /**
+     * @brief 암호 연산 스레드 본체. 큐에서 핸드셰이크를 꺼내 다음 단계를 실행
+     */
+    void crypto_loop();
+
+    /**
+     * @brief 핸드셰이크 한 단계(SSL_accept)를 실행하고 결과에 따라 완료, 재감시, 실패 처리합니다.
+     * @param handshake 실행할 핸드셰이크
+     */
+    void step(const std::shared_ptr<Handshake>& handshake);
+
+    /**
+     * @brief 핸드셰이크를 목록에서 빼고 만료 타이머를 지운 뒤 자리를 기다리는 submit을 깨웁니다.
+     * @param handshake 뺄 핸드셰이크
+     */
+    void remove(const std::shared_ptr<Handshake>& handshake);
+
+    /**
+     * @brief 실패한 핸드셰이크를 정리합니다. (SSL 해제, 소켓 닫기, 실패 통계 기록)
+     * @param handshake 실패한 핸드셰이크
+     * @param reason 로그에 남길 실패 이유
+     */
+    void fail(const std::shared_ptr<Handshake>& handshake, const char* reason);
+
+    /**
+     * @brief 진행 중인 핸드셰이크 (소켓 디스크립터 기준), 보호용 뮤텍스, 자리 대기 신호
+     */
+    std::unordered_map<int, std::shared_ptr<Handshake>> handshakes;
+    std::mutex handshakes_mutex;
+    std::condition_variable slot_cv;
+
+    /**
+     * @brief 단계 실행을 기다리는 핸드셰이크 큐와 깨우기 신호
+     */
+    std::deque<std::shared_ptr<Handshake>> crypto_queue;
+    std::mutex crypto_mutex;
+    std::condition_variable crypto_cv;
+
+    /**
+     * @brief 이벤트 스레드, 암호 연산 스레드, epoll/깨우기 디스크립터
+     */
+    std::thread event_thread;
+    std::vector<std::thread> crypto_workers;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::atomic<bool> running{false};
+
+    /**
+     * @brief 설정
+     */
+    SSL_CTX* ctx = nullptr;
+    std::chrono::milliseconds timeout{10000};
+    size_t max_concurrent = 64;
+    TlsReadyCallback on_ready;
+};
+
+/**
+ * @brief 서버 전역 TLS 핸드셰이크 처리기 인스턴스
+ */
+extern TlsHandshaker g_tls_handshaker;
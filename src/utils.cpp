@@ -5,7 +5,10 @@
  */
 
 #include "utils.hpp"
+#include <cctype>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
 
 /**
  * @brief 현재 시간을 KST(한국 표준시) 기준으로 밀리초 단위까지 출력합니다.
@@ -25,6 +28,112 @@ void printNowTimeKST()
          << endl;
 }
 
+/**
+ * @brief 타임스탬프 문자열을 epoch 밀리초로 변환합니다.
+ * @param text "YYYY-MM-DDTHH:MM:SS[.mmm][KST|Z|UTC|±HH:MM]" 형식 문자열 ('T' 대신 공백 허용)
+ * @param epoch_ms 변환된 epoch 밀리초 (출력)
+ * @param assume_utc 접미사가 없을 때 UTC로 해석할지 여부 (기본값 false: KST)
+ * @return 변환 성공 시 true, 형식이 맞지 않거나 알 수 없는 시간대 접미사이면 false
+ * @details 'Z'/"UTC"는 UTC, "KST"는 KST, "±HH:MM"은 해당 오프셋으로 해석합니다.
+ */
+bool parse_timestamp_ms(const string& text, long long& epoch_ms, bool assume_utc)
+{
+    int year, month, day, hour, minute, second, consumed = 0;
+    char separator;
+    if (sscanf(text.c_str(), "%4d-%2d-%2d%c%2d:%2d:%2d%n", &year, &month, &day, &separator, &hour, &minute, &second,
+               &consumed) != 7 ||
+        (separator != 'T' && separator != ' ') || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 ||
+        hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60)
+    {
+        return false;
+    }
+
+    // 소수점 이하 밀리초 (있으면 앞 3자리만 사용)
+    size_t pos = consumed;
+    long long millis = 0;
+    if (pos < text.size() && text[pos] == '.')
+    {
+        int digits = 0;
+        for (++pos; pos < text.size() && isdigit(static_cast<unsigned char>(text[pos])); ++pos)
+        {
+            if (digits < 3)
+            {
+                millis = millis * 10 + (text[pos] - '0');
+                digits++;
+            }
+        }
+        for (; digits < 3; digits++)
+        {
+            millis *= 10;
+        }
+    }
+
+    // 시간대 접미사 (알 수 없는 접미사를 KST로 추측하지 않고 거부)
+    string zone = text.substr(pos);
+    const long KST_OFFSET_SECONDS = 9 * 60 * 60;
+    long offset;
+    auto is_digit_at = [&](size_t i) { return isdigit(static_cast<unsigned char>(zone[i])) != 0; };
+    if (zone.empty())
+    {
+        offset = assume_utc ? 0 : KST_OFFSET_SECONDS;
+    }
+    else if (zone == "Z" || zone == "UTC")
+    {
+        offset = 0;
+    }
+    else if (zone == "KST")
+    {
+        offset = KST_OFFSET_SECONDS;
+    }
+    else if (zone.size() == 6 && (zone[0] == '+' || zone[0] == '-') && zone[3] == ':' && is_digit_at(1) &&
+             is_digit_at(2) && is_digit_at(4) && is_digit_at(5))
+    {
+        long offset_hour = (zone[1] - '0') * 10 + (zone[2] - '0');
+        long offset_minute = (zone[4] - '0') * 10 + (zone[5] - '0');
+        if (offset_hour > 14 || offset_minute > 59)
+        {
+            return false;
+        }
+        offset = (offset_hour * 3600 + offset_minute * 60) * (zone[0] == '-' ? -1 : 1);
+    }
+    else
+    {
+        return false;
+    }
+
+    tm parsed = {};
+    parsed.tm_year = year - 1900;
+    parsed.tm_mon = month - 1;
+    parsed.tm_mday = day;
+    parsed.tm_hour = hour;
+    parsed.tm_min = minute;
+    parsed.tm_sec = second;
+    time_t seconds = timegm(&parsed);
+    if (seconds == -1)
+    {
+        return false;
+    }
+
+    epoch_ms = (static_cast<long long>(seconds) - offset) * 1000 + millis;
+    return true;
+}
+
+/**
+ * @brief epoch 밀리초를 KST 타임스탬프 문자열로 변환합니다.
+ * @param epoch_ms epoch 밀리초
+ * @return "YYYY-MM-DDTHH:MM:SSKST" 형식 문자열 (control이 기록하는 형식과 동일)
+ */
+string format_kst_timestamp(long long epoch_ms)
+{
+    const long KST_OFFSET_SECONDS = 9 * 60 * 60;
+    time_t kst_seconds = static_cast<time_t>(epoch_ms / 1000) + KST_OFFSET_SECONDS;
+    tm kst_tm;
+    gmtime_r(&kst_seconds, &kst_tm);
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SKST", &kst_tm);
+    return string(buffer);
+}
+
 /**
  * @brief 바이트 배열을 Base64 문자열로 인코딩합니다.
  * @param in 인코딩할 바이트 배열
@@ -21,6 +21,23 @@ using namespace std;
  */
 void printNowTimeKST();
 
+/**
+ * @brief 타임스탬프 문자열을 epoch 밀리초로 변환합니다.
+ * @param text "YYYY-MM-DDTHH:MM:SS[.mmm][KST|Z|UTC|±HH:MM]" 형식 문자열 ('T' 대신 공백 허용)
+ * @param epoch_ms 변환된 epoch 밀리초 (출력)
+ * @param assume_utc 접미사가 없을 때 UTC로 해석할지 여부 (기본값 false: KST)
+ * @return 변환 성공 시 true, 형식이 맞지 않거나 알 수 없는 시간대 접미사이면 false
+ * @details 'Z'/"UTC"는 UTC, "KST"는 KST, "±HH:MM"은 해당 오프셋으로 해석합니다.
+ */
+bool parse_timestamp_ms(const string& text, long long& epoch_ms, bool assume_utc = false);
+
+/**
+ * @brief epoch 밀리초를 KST 타임스탬프 문자열로 변환합니다.
+ * @param epoch_ms epoch 밀리초
+ * @return "YYYY-MM-DDTHH:MM:SSKST" 형식 문자열 (control이 기록하는 형식과 동일)
+ */
+string format_kst_timestamp(long long epoch_ms);
+
 // ==================== 인코딩 관련 함수 ====================
 /**
  * @brief 바이트 배열을 Base64 문자열로 인코딩합니다.